@@ -0,0 +1,199 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ * TCPPUMP <https://github.com/amartin755/tcppump>
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdlib>
+#include <new>
+#if !HAVE_WINDOWS
+#include <sys/mman.h>
+#endif
+
+#include "framearena.hpp"
+#include "settings.hpp"
+#include "console.hpp"
+
+
+cFrameArena::cFrameArena ()
+: current(0), next(nullptr), end(nullptr), used(0), reserved(0)
+{
+}
+
+
+cFrameArena::~cFrameArena ()
+{
+    release ();
+}
+
+
+uint8_t* cFrameArena::alloc (size_t len)
+{
+    len = (len + FRAME_ALIGNMENT - 1) & ~(FRAME_ALIGNMENT - 1);
+
+    if (!next || len > size_t(end - next))
+    {
+        if (!nextChunk (len) && !addChunk (len))
+            throw std::bad_alloc ();
+    }
+
+    uint8_t* frame = next;
+    next += len;
+    used += len;
+    return frame;
+}
+
+
+void cFrameArena::reset (void)
+{
+    current = 0;
+    next    = chunks.empty () ? nullptr : chunks[0].begin;
+    end     = chunks.empty () ? nullptr : chunks[0].begin + chunks[0].size;
+    used    = 0;
+}
+
+
+void cFrameArena::release (void)
+{
+    for (auto& c : chunks)
+    {
+#if !HAVE_WINDOWS
+        if (c.mapped)
+        {
+            munmap (c.mem, c.size);
+            continue;
+        }
+#endif
+        std::free (c.mem);
+    }
+    chunks.clear ();
+    current = 0;
+    next = end = nullptr;
+    used = reserved = 0;
+}
+
+
+// continue with the next already allocated chunk, that is big enough (only after reset)
+bool cFrameArena::nextChunk (size_t minSize)
+{
+    while (!chunks.empty () && current + 1 < chunks.size ())
+    {
+        const chunk& c = chunks[++current];
+        if (c.size >= minSize)
+        {
+            next = c.begin;
+            end  = c.begin + c.size;
+            return true;
+        }
+    }
+    return false;
+}
+
+
+bool cFrameArena::addChunk (size_t minSize)
+{
+    chunk c;
+    c.size   = (minSize + CHUNK_SIZE - 1) / CHUNK_SIZE * CHUNK_SIZE;
+    c.mem    = nullptr;
+    c.mapped = false;
+
+#if !HAVE_WINDOWS
+    // mmap'ed memory is page aligned, thus also cache line aligned
+    if (cSettings::get().useHugepages ())
+    {
+        c.mem = mmap (nullptr, c.size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (c.mem == MAP_FAILED)
+        {
+            Console::PrintVerbose ("No hugepages available (see /proc/sys/vm/nr_hugepages). Using transparent hugepages.\n");
+            c.mem = mmap (nullptr, c.size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (c.mem != MAP_FAILED)
+                madvise (c.mem, c.size, MADV_HUGEPAGE);
+        }
+    }
+    else
+    {
+        c.mem = mmap (nullptr, c.size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    }
+    if (c.mem == MAP_FAILED)
+        return false;
+    c.mapped = true;
+    c.begin  = (uint8_t*)c.mem;
+#else
+    c.mem = std::malloc (c.size + FRAME_ALIGNMENT);
+    if (!c.mem)
+        return false;
+    c.begin = (uint8_t*)(((uintptr_t)c.mem + FRAME_ALIGNMENT - 1) & ~(uintptr_t)(FRAME_ALIGNMENT - 1));
+#endif
+
+    chunks.push_back (c);
+    current   = chunks.size () - 1;
+    next      = c.begin;
+    end       = c.begin + c.size;
+    reserved += c.size;
+
+    return true;
+}
+
+
+#ifdef WITH_UNITTESTS
+#include <cstring>
+#include "bug.hpp"
+
+void cFrameArena::unitTest ()
+{
+    Console::PrintDebug("-- " __FILE__ " --\n");
+
+    cFrameArena arena;
+    BUG_IF_NOT (arena.getUsed () == 0 && arena.getReserved () == 0);
+
+    // frames are cache line aligned and placed back to back
+    uint8_t* p1 = arena.alloc (60);
+    uint8_t* p2 = arena.alloc (1);
+    uint8_t* p3 = arena.alloc (65);
+    uint8_t* p4 = arena.alloc (64);
+    BUG_IF_NOT (((uintptr_t)p1 % FRAME_ALIGNMENT) == 0);
+    BUG_IF_NOT (p2 == p1 + 64);
+    BUG_IF_NOT (p3 == p2 + 64);
+    BUG_IF_NOT (p4 == p3 + 128);
+    BUG_IF_NOT (arena.getUsed () == 320);
+    BUG_IF_NOT (arena.getReserved () == CHUNK_SIZE);
+    std::memset (p1, 0xaa, 320);
+
+    // a frame, that doesn't fit into the current chunk, starts a new one
+    uint8_t* p5 = arena.alloc (CHUNK_SIZE - 320);
+    BUG_IF_NOT (p5 == p4 + 64);
+    uint8_t* p6 = arena.alloc (1);
+    BUG_IF_NOT (((uintptr_t)p6 % FRAME_ALIGNMENT) == 0);
+    BUG_IF_NOT (arena.getReserved () == 2 * CHUNK_SIZE);
+
+    // oversized frames get a chunk of their own
+    uint8_t* p7 = arena.alloc (CHUNK_SIZE + 1);
+    BUG_IF_NOT (((uintptr_t)p7 % FRAME_ALIGNMENT) == 0);
+    BUG_IF_NOT (arena.getReserved () == 4 * CHUNK_SIZE);
+    std::memset (p7, 0x55, CHUNK_SIZE + 1);
+
+    // chunks are reused after reset
+    arena.reset ();
+    BUG_IF_NOT (arena.getUsed () == 0 && arena.getReserved () == 4 * CHUNK_SIZE);
+    BUG_IF_NOT (arena.alloc (1) == p1);
+    BUG_IF_NOT (arena.alloc (CHUNK_SIZE) == p6);
+    BUG_IF_NOT (arena.alloc (CHUNK_SIZE + 1) == p7);
+    BUG_IF_NOT (arena.getReserved () == 4 * CHUNK_SIZE);
+
+    arena.release ();
+    BUG_IF_NOT (arena.getUsed () == 0 && arena.getReserved () == 0);
+    BUG_IF_NOT (((uintptr_t)arena.alloc (1) % FRAME_ALIGNMENT) == 0);
+}
+#endif
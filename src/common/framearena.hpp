@@ -0,0 +1,73 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ * TCPPUMP <https://github.com/amartin755/tcppump>
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FRAMEARENA_HPP_
+#define FRAMEARENA_HPP_
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+/*
+ * Storage for the frames of compiled packets. Frames are placed back to back in large chunks,
+ * each one starting at a cache line boundary. There is no way to free a single frame, the memory
+ * of all frames is released together with the arena.
+ * On Linux the chunks can optionally be backed by hugepages (see cSettings::setHugepages).
+ */
+class cFrameArena
+{
+public:
+    cFrameArena ();
+    ~cFrameArena ();
+    cFrameArena (const cFrameArena&) = delete;
+    cFrameArena& operator= (const cFrameArena&) = delete;
+
+    uint8_t* alloc (size_t len);
+    void reset (void);
+    void release (void);
+    size_t getUsed (void) const {return used;}
+    size_t getReserved (void) const {return reserved;}
+
+    static const size_t FRAME_ALIGNMENT = 64;
+    static const size_t CHUNK_SIZE      = 2 * 1024 * 1024;
+
+#ifdef WITH_UNITTESTS
+    static void unitTest ();
+#endif
+
+private:
+    struct chunk
+    {
+        void*    mem;
+        size_t   size;
+        uint8_t* begin;  // first aligned byte of mem
+        bool     mapped;
+    };
+
+    bool addChunk (size_t minSize);
+    bool nextChunk (size_t minSize);
+
+    std::vector<chunk> chunks;
+    size_t   current;    // index of the current chunk
+    uint8_t* next;       // next free byte in the current chunk
+    uint8_t* end;        // end of the current chunk
+    size_t   used;
+    size_t   reserved;
+};
+
+#endif /* FRAMEARENA_HPP_ */
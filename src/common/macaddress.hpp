@@ -1,7 +1,7 @@
 // SPDX-License-Identifier: GPL-3.0-only
 /*
  * TCPPUMP <https://github.com/amartin755/tcppump>
- * Copyright (C) 2012-2021 Andreas Martin (netnag@mailbox.org)
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -196,12 +196,7 @@ public:
     {
         BUG_ON (!unicast && !multicast);
 
-        m_mac[0] = cRandom::rand8 ();
-        m_mac[1] = cRandom::rand8 ();
-        m_mac[2] = cRandom::rand8 ();
-        m_mac[3] = cRandom::rand8 ();
-        m_mac[4] = cRandom::rand8 ();
-        m_mac[5] = cRandom::rand8 ();
+        cRandom::randBytes (m_mac, sizeof (m_mac));
 
         if (unicast && !multicast)
             m_mac[0] &= 0xfe;
@@ -0,0 +1,101 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ * TCPPUMP <https://github.com/amartin755/tcppump>
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ORDERDEPENDENCY_HPP_
+#define ORDERDEPENDENCY_HPP_
+
+#include <cstdint>
+
+/*
+ * Some state of the compiler depends on the order of the compiled instructions: counters like the IPv4
+ * identification or random numbers in counter mode. These counters are thread local. An instruction, that
+ * takes counter values, marks the calling thread. As an instruction normally takes the same number of values,
+ * whatever the start values are, its start values can be assigned in advance (see cCompiler::readChunks).
+ */
+class cOrderDependency
+{
+public:
+    enum counterId
+    {
+        RANDOM_SEQUENCE, IPV4_IDENTIFICATION, COUNTERS
+    };
+
+    // all counters of a thread
+    struct cCounters
+    {
+        uint64_t value[COUNTERS] = {};
+
+        bool operator== (const cCounters& c) const
+        {
+            for (unsigned n = 0; n < COUNTERS; n++)
+            {
+                if (value[n] != c.value[n])
+                    return false;
+            }
+            return true;
+        }
+        bool operator!= (const cCounters& c) const
+        {
+            return !(*this == c);
+        }
+        cCounters operator+ (const cCounters& c) const
+        {
+            cCounters sum;
+            for (unsigned n = 0; n < COUNTERS; n++)
+                sum.value[n] = value[n] + c.value[n];
+            return sum;
+        }
+    };
+
+    // returns the next value of the counter and marks the calling thread
+    static uint64_t next (counterId id)
+    {
+        state ().marked = true;
+        return state ().counters.value[id]++;
+    }
+
+    static const cCounters& get (void)
+    {
+        return state ().counters;
+    }
+    static void set (const cCounters& c)
+    {
+        state ().counters = c;
+    }
+
+    // returns and clears the mark of the calling thread
+    static bool test (void)
+    {
+        bool marked = state ().marked;
+        state ().marked = false;
+        return marked;
+    }
+
+private:
+    struct cState
+    {
+        cCounters counters;
+        bool marked = false;
+    };
+    static cState& state (void)
+    {
+        static thread_local cState s;
+        return s;
+    }
+};
+
+#endif /* ORDERDEPENDENCY_HPP_ */
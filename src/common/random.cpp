@@ -1,7 +1,7 @@
 // SPDX-License-Identifier: GPL-3.0-only
 /*
  * TCPPUMP <https://github.com/amartin755/tcppump>
- * Copyright (C) 2012-2021 Andreas Martin (netnag@mailbox.org)
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -17,17 +17,144 @@
  */
 
 
-#include <cstdlib>
-#include <ctime>
-#include <cassert>
 #include <cstring>
+#include <mutex>
 #include <random>
 
 #include "bug.hpp"
 #include "random.hpp"
+#include "orderdependency.hpp"
 
 cRandom* cRandom::instance = nullptr;
 
+
+/*
+ * xoshiro256** (D. Blackman, S. Vigna) with LANES independent streams, which are stepped together.
+ * The state is stored lane by lane, thus the compiler can vectorize a step.
+ */
+class cXoshiro256
+{
+public:
+    static const unsigned LANES = 4;
+
+    void setLane (unsigned lane, const uint64_t state[4])
+    {
+        for (unsigned n = 0; n < 4; n++)
+            s[n][lane] = state[n];
+    }
+
+    void step (uint64_t out[LANES])
+    {
+        for (unsigned l = 0; l < LANES; l++)
+        {
+            out[l] = rotl (s[1][l] * 5, 7) * 9;
+            const uint64_t t = s[1][l] << 17;
+            s[2][l] ^= s[0][l];
+            s[3][l] ^= s[1][l];
+            s[1][l] ^= s[2][l];
+            s[0][l] ^= s[3][l];
+            s[2][l] ^= t;
+            s[3][l] = rotl (s[3][l], 45);
+        }
+    }
+
+    // advances a single stream by 2^128 steps, thus streams, which are jumped apart, never overlap
+    static void jump (uint64_t state[4])
+    {
+        static const uint64_t JUMP[] = {0x180ec6d33cfd0aba, 0xd5a61266f0c9392c, 0xa9582618e03fc9aa, 0x39abdc4529b1661c};
+        cXoshiro256 x;
+        uint64_t t[4] = {0, 0, 0, 0};
+        uint64_t out[LANES];
+
+        x.setLane (0, state);
+        for (uint64_t j : JUMP)
+        {
+            for (unsigned b = 0; b < 64; b++)
+            {
+                if (j & ((uint64_t)1 << b))
+                {
+                    for (unsigned n = 0; n < 4; n++)
+                        t[n] ^= x.s[n][0];
+                }
+                x.step (out);
+            }
+        }
+        std::memcpy (state, t, sizeof (t));
+    }
+
+private:
+    static inline uint64_t rotl (uint64_t x, int k)
+    {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    uint64_t s[4][LANES];
+};
+
+
+/*
+ * The generator of a thread. Its streams are taken from a common state, which is jumped for each stream.
+ * Single values are handed out from a buffer of one step.
+ * No constructor, as thread_local objects with dynamic initialization are accessed via a wrapper function.
+ */
+struct cRandomStream
+{
+    uint64_t next (void)
+    {
+        if (idx == cXoshiro256::LANES)
+        {
+            gen.step (buf);
+            idx = 0;
+        }
+        return buf[idx++];
+    }
+
+    cXoshiro256 gen;
+    uint64_t buf[cXoshiro256::LANES];
+    unsigned idx;
+    bool seeded;        // false until first use of the thread
+
+    static std::mutex mutex;
+    static uint64_t   nextState[4];   // state of the next stream
+};
+std::mutex cRandomStream::mutex;
+uint64_t   cRandomStream::nextState[4];
+
+static thread_local cRandomStream stream;
+
+
+// expands the seed to the state of the first stream (splitmix64, as recommended for xoshiro)
+static void seedStreams (uint64_t seed)
+{
+    std::lock_guard<std::mutex> lock (cRandomStream::mutex);
+    for (unsigned n = 0; n < 4; n++)
+    {
+        uint64_t z = (seed += 0x9e3779b97f4a7c15);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+        cRandomStream::nextState[n] = z ^ (z >> 31);
+    }
+}
+
+// multiplies two 64bit values; returns the upper 64bit of the product
+static inline uint64_t mul128 (uint64_t a, uint64_t b, uint64_t& lo)
+{
+#if defined (__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 uint128;
+    uint128 m = (uint128)a * b;
+    lo = (uint64_t)m;
+    return (uint64_t)(m >> 64);
+#else
+    uint64_t aL = a & 0xffffffff, aH = a >> 32;
+    uint64_t bL = b & 0xffffffff, bH = b >> 32;
+    uint64_t ll = aL * bL, lh = aL * bH, hl = aH * bL, hh = aH * bH;
+    uint64_t mid = (ll >> 32) + (lh & 0xffffffff) + (hl & 0xffffffff);
+    lo = (mid << 32) | (ll & 0xffffffff);
+    return hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+#endif
+}
+
+
 cRandom* cRandom::create (void)
 {
     if (!instance)
@@ -55,25 +182,48 @@ void cRandom::setCounterMode (unsigned startValue)
 
 cRandom::cRandom () : countOnly(false), seq(0)
 {
-    if (!countOnly)
-        std::srand ((unsigned)std::time (NULL));
+    std::random_device rd;
+    seedStreams ((uint64_t)rd () << 32 | rd ());
 }
 
 uint64_t cRandom::rand (uint64_t min, uint64_t max)
 {
-    assert (instance);
-    uint64_t r = instance->countOnly ? instance->sequence() : instance->pseudoRandom();
-
+    BUG_ON (!instance);
     uint64_t range = max - min + 1;
 
+    if (instance->countOnly)
+    {
+        uint64_t r = instance->sequence();
+        return (range ? r % range : r) + min;
+    }
+
     // if min...max spans the entire 64bit area, range becomes zero
-    // In this case we need special handling to avoid division by zero.
-    return (range ? r % range : r) + min;
+    return (range ? uniform (range) : instance->pseudoRandom ()) + min;
+}
+
+/*
+ * Returns an unbiased random number 0...range-1 (D. Lemire, "Fast Random Integer Generation in an Interval").
+ * The upper half of random * range is the result. Only if the lower half hits the few values, which would
+ * be overrepresented, the threshold is calculated and the number is drawn again. Thus there is no division
+ * in the common path.
+ */
+uint64_t cRandom::uniform (uint64_t range)
+{
+    uint64_t lo;
+    uint64_t hi = mul128 (instance->pseudoRandom (), range, lo);
+
+    if (lo < range)
+    {
+        const uint64_t threshold = (0 - range) % range; // 2^64 mod range
+        while (lo < threshold)
+            hi = mul128 (instance->pseudoRandom (), range, lo);
+    }
+    return hi;
 }
 
-void cRandom::rand (void* p, size_t len /*number of bytes*/)
+void cRandom::fill (void* p, size_t len /*number of bytes*/)
 {
-    assert (instance);
+    BUG_ON (!instance);
 
     uint8_t *data = (uint8_t*)p;
 
@@ -83,54 +233,60 @@ void cRandom::rand (void* p, size_t len /*number of bytes*/)
         {
             data[n] = (uint8_t)n;
         }
+        return;
     }
-    else
+
+    instance->pseudoRandom (); // seed the stream of this thread
+    uint64_t out[cXoshiro256::LANES];
+    while (len >= sizeof (out))
     {
-        uint8_t* p8 = (uint8_t*)p;
+        stream.gen.step (out);
+        std::memcpy (data, out, sizeof (out));
+        data += sizeof (out);
+        len  -= sizeof (out);
+    }
+    if (len)
+    {
+        stream.gen.step (out);
+        std::memcpy (data, out, len);
+    }
+}
 
-        if ((intptr_t)p8 & 1)
-        {
-            *p8++ = (uint8_t)instance->pseudoRandom ();
-            len--;
-        }
-        if (len >= 2)
-        {
-            if ((intptr_t)p8 & 2)
-            {
-                *(uint16_t*)p8 = (uint16_t)instance->pseudoRandom ();
-                p8 += 2;
-                len -= 2;
-            }
-            while (len >= 4)
-            {
-                *(uint32_t*)p8 = (uint32_t)instance->pseudoRandom ();
-                p8 += 4;
-                len -= 4;
-            }
-            if (len & 2)
-            {
-                *(uint16_t*)p8 = (uint16_t)instance->pseudoRandom ();
-                p8 += 2;
-                len -= 2;
-            }
-        }
-        if (len & 1)
-        {
-            *p8++ = (uint8_t)instance->pseudoRandom ();
-            len--;
-        }
+void cRandom::randBytes (uint8_t* p, size_t len)
+{
+    BUG_ON (!instance);
+
+    if (instance->countOnly)
+    {
+        for (size_t n = 0; n < len; n++)
+            p[n] = (uint8_t)instance->sequence ();
+    }
+    else
+    {
+        fill (p, len);
     }
 }
 
 uint64_t cRandom::pseudoRandom (void)
 {
-    static thread_local std::mt19937_64 rng(std::random_device{}());
-    return rng();
+    if (!stream.seeded)
+    {
+        std::lock_guard<std::mutex> lock (cRandomStream::mutex);
+        for (unsigned l = 0; l < cXoshiro256::LANES; l++)
+        {
+            stream.gen.setLane (l, cRandomStream::nextState);
+            cXoshiro256::jump (cRandomStream::nextState);
+        }
+        stream.idx    = cXoshiro256::LANES;
+        stream.seeded = true;
+    }
+    return stream.next ();
 }
 
+// the counter depends on the order of the calls, see cOrderDependency
 uint64_t cRandom::sequence (void)
 {
-    return seq++;
+    return seq + cOrderDependency::next (cOrderDependency::RANDOM_SEQUENCE);
 }
 
 #ifdef WITH_UNITTESTS
@@ -139,51 +295,59 @@ void cRandom::unitTest ()
 {
     Console::PrintDebug("-- " __FILE__ " --\n");
 
+    // reference values of xoshiro256** with state {1, 2, 3, 4}
+    {
+        const uint64_t state[4] = {1, 2, 3, 4};
+        uint64_t jumped[4] = {1, 2, 3, 4};
+        cXoshiro256::jump (jumped);
+
+        cXoshiro256 x;
+        uint64_t out[cXoshiro256::LANES];
+        x.setLane (0, state);
+        x.setLane (1, jumped);
+        x.setLane (2, state);
+        x.setLane (3, jumped);
+        x.step (out);
+        BUG_IF_NOT (out[0] == 0x2d00 && out[1] == 0xbbd2f312298443d8 && out[2] == out[0] && out[3] == out[1]);
+        x.step (out);
+        BUG_IF_NOT (out[0] == 0 && out[1] == 0x62e57db2d5706577);
+        x.step (out);
+        BUG_IF_NOT (out[0] == 0x5a007080 && out[2] == out[0]);
+    }
+
+    // upper half of the product
+    {
+        uint64_t lo;
+        BUG_IF_NOT (mul128 (0xffffffffffffffff, 0xffffffffffffffff, lo) == 0xfffffffffffffffe && lo == 1);
+        BUG_IF_NOT (mul128 (0x8000000000000000, 6, lo) == 3 && lo == 0);
+        BUG_IF_NOT (mul128 (0x123456789abcdef0, 0x10, lo) == 1 && lo == 0x23456789abcdef00);
+    }
+
+    // all values of a range and nothing else
+    {
+        unsigned hits[7] = {0};
+        for (int n = 0; n < 7000; n++)
+        {
+            uint64_t r = rand (10, 16);
+            BUG_IF_NOT (r >= 10 && r <= 16);
+            hits[r - 10]++;
+        }
+        for (unsigned h : hits)
+            BUG_IF_NOT (h > 700 && h < 1300);
+        BUG_IF_NOT (rand (5, 5) == 5);
+        BUG_IF_NOT (rand8 (0xff, 0xff) == 0xff);
+    }
+
     uint32_t data[32];
     uint8_t* a = (uint8_t*)&data[1];
     for (int n = 0; n < 3; n++, a++)
     {
+        for (size_t len : {1, 2, 3, 4, 5, 6, 10, 33, 64})
         {
             std::memset (data, 0, sizeof (data));
-            rand (a, 1);
-            BUG_IF_NOT (data[0] == 0);
-            BUG_IF_NOT (a[1] == 0);
-        }
-        {
-            std::memset (data, 0, sizeof (data));
-            rand (a, 2);
-            BUG_IF_NOT (data[0] == 0);
-            BUG_IF_NOT (a[2] == 0);
-        }
-        {
-            std::memset (data, 0, sizeof (data));
-            rand (a, 3);
-            BUG_IF_NOT (data[0] == 0);
-            BUG_IF_NOT (a[3] == 0);
-        }
-        {
-            std::memset (data, 0, sizeof (data));
-            rand (a, 4);
-            BUG_IF_NOT (data[0] == 0);
-            BUG_IF_NOT (a[4] == 0);
-        }
-        {
-            std::memset (data, 0, sizeof (data));
-            rand (a, 5);
-            BUG_IF_NOT (data[0] == 0);
-            BUG_IF_NOT (a[5] == 0);
-        }
-        {
-            std::memset (data, 0, sizeof (data));
-            rand (a, 6);
-            BUG_IF_NOT (data[0] == 0);
-            BUG_IF_NOT (a[6] == 0);
-        }
-        {
-            std::memset (data, 0, sizeof (data));
-            rand (a, 10);
+            fill (a, len);
             BUG_IF_NOT (data[0] == 0);
-            BUG_IF_NOT (a[10] == 0);
+            BUG_IF_NOT (a[len] == 0);
         }
     }
 }
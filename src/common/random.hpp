@@ -1,7 +1,7 @@
 // SPDX-License-Identifier: GPL-3.0-only
 /*
  * TCPPUMP <https://github.com/amartin755/tcppump>
- * Copyright (C) 2012-2021 Andreas Martin (netnag@mailbox.org)
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -21,7 +21,12 @@
 #define RANDOM_HPP_
 
 #include <cstdint>
+#include <cstddef>
 
+/*
+ * Random numbers of xoshiro256**. Each thread has its own generator, all of them are derived from the seed
+ * of create(). In counter mode (--predictable-random), consecutive values of a counter are returned instead.
+ */
 class cRandom
 {
 public:
@@ -43,7 +48,10 @@ public:
     {
         return (uint8_t)rand (min, max);
     }
-    static void rand (void* p, size_t len);
+    // random payload; in counter mode the bytes are 0, 1, 2, ...
+    static void fill (void* p, size_t len);
+    // independent random bytes (e.g. addresses); in counter mode each byte is the next counter value
+    static void randBytes (uint8_t* p, size_t len);
     static void setCounterMode (unsigned startValue);
 
 #ifdef WITH_UNITTESTS
@@ -55,9 +63,10 @@ private:
     uint64_t pseudoRandom (void);
     uint64_t sequence (void);
     static uint64_t rand (uint64_t min = 0, uint64_t max = 0xffffffff);
+    static uint64_t uniform (uint64_t range);
     static cRandom* instance;
     bool countOnly;
-    uint64_t seq;
+    uint64_t seq;       // start value of counter mode
 };
 
 #endif /* RANDOM_HPP_ */
@@ -22,8 +22,12 @@
 #include "ethernetpacket.hpp"
 
 static cSettings globalSettings;
+static thread_local unsigned threadMTU = 0;
 
-cSettings::cSettings () : m_hasMAC(false), m_hasIPv4(false), m_hasIPv6(false), m_mtu(cEthernetPacket::MAX_ETHERNET_PAYLOAD)
+cSettings::cSettings () : m_hasMAC(false), m_hasIPv4(false), m_hasIPv6(false), m_mtu(cEthernetPacket::MAX_ETHERNET_PAYLOAD),
+                        m_hugepages(false),
+                        m_csumOffload(false),
+                        m_gso(false)
 {
 
 }
@@ -103,7 +107,17 @@ const cIPv6& cSettings::getMyIPv6(void) const
 
 unsigned cSettings::getMyMTU (void) const
 {
-    return m_mtu;
+    return threadMTU ? threadMTU : m_mtu;
+}
+
+cSettings::cThreadMTU::cThreadMTU (unsigned mtu) : m_saved (threadMTU)
+{
+    threadMTU = mtu;
+}
+
+cSettings::cThreadMTU::~cThreadMTU ()
+{
+    threadMTU = m_saved;
 }
 
 void cSettings::setIfName (const char* ifc)
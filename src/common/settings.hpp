@@ -1,7 +1,7 @@
 // SPDX-License-Identifier: GPL-3.0-only
 /*
  * TCPPUMP <https://github.com/amartin755/tcppump>
- * Copyright (C) 2012-2021 Andreas Martin (netnag@mailbox.org)
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -50,6 +50,26 @@ public:
     bool isIPv6Set (void) const {return m_hasIPv6;}
     void setIfName (const char* ifc);
     const std::string getIfName () const;
+    void setHugepages (bool enable) {m_hugepages = enable;}
+    bool useHugepages (void) const {return m_hugepages;}
+    // UDP and TCP checksums are completed on transmission (see txOffload)
+    void setChecksumOffload (bool enable) {m_csumOffload = enable;}
+    bool useChecksumOffload (void) const {return m_csumOffload;}
+    // UDP and TCP packets exceeding the MTU are split on transmission (GSO), requires checksum offload
+    void setSegmentationOffload (bool enable) {m_gso = enable;}
+    bool useSegmentationOffload (void) const {return m_gso && m_csumOffload;}
+
+    // overrides the MTU for the calling thread during its lifetime
+    class cThreadMTU
+    {
+    public:
+        cThreadMTU (unsigned mtu);
+        ~cThreadMTU ();
+        cThreadMTU(const cThreadMTU&) = delete;
+        cThreadMTU& operator= (const cThreadMTU&) = delete;
+    private:
+        unsigned m_saved;
+    };
 
 private:
     bool m_hasMAC;
@@ -60,6 +80,9 @@ private:
     cIPv6 m_myIPv6;
     unsigned m_mtu;
     std::string m_ifName;
+    bool m_hugepages;
+    bool m_csumOffload;
+    bool m_gso;
 };
 
 #endif /* SETTINGS_HPP */
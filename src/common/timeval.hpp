@@ -1,7 +1,7 @@
 // SPDX-License-Identifier: GPL-3.0-only
 /*
  * TCPPUMP <https://github.com/amartin755/tcppump>
- * Copyright (C) 2012-2021 Andreas Martin (netnag@mailbox.org)
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -28,6 +28,9 @@
 #include "bug.hpp"
 #endif
 
+/*
+ * Point in time or duration with nanosecond resolution
+ */
 class cTimeval
 {
 public:
@@ -54,8 +57,8 @@ public:
     cTimeval& now ()
     {
         auto currTime = std::chrono::system_clock::now();
-        auto us = std::chrono::duration_cast<std::chrono::microseconds>(currTime.time_since_epoch());
-        value = us.count();
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(currTime.time_since_epoch());
+        value = ns.count();
         return *this;
     }
     struct timeval timeval() const
@@ -68,31 +71,35 @@ public:
     }
     uint64_t ns() const
     {
-        return value * 1000;
+        return value;
+    }
+    void setNs (uint64_t ns)
+    {
+        value = ns;
     }
     uint64_t us() const
     {
-        return value;
+        return value / 1000;
     }
     void setUs (uint64_t us)
     {
-        value = us;
+        value = us * 1000;
     }
     uint64_t ms() const
     {
-        return value / 1000;
+        return value / 1000000;
     }
     void setMs (uint64_t ms)
     {
-        value = ms * 1000;
+        value = ms * 1000000;
     }
     uint64_t s() const
     {
-        return value / 1000000;
+        return value / 1000000000;
     }
     void setS (uint64_t s)
     {
-        value = s * 1000000;
+        value = s * 1000000000;
     }
     void set (const cTimeval& val)
     {
@@ -100,7 +107,7 @@ public:
     }
     void set (const struct timeval &tv)
     {
-        value = (uint64_t)(tv.tv_sec * 1000000) + (uint64_t)tv.tv_usec;
+        value = (uint64_t)tv.tv_sec * 1000000000 + (uint64_t)tv.tv_usec * 1000;
     }
     cTimeval& add (const cTimeval& val)
     {
@@ -207,6 +214,15 @@ public:
         BUG_IF_NOT (cTimeval(2) < cTimeval(3));
         BUG_IF_NOT (cTimeval(1) > cTimeval(0));
         BUG_IF_NOT (cTimeval(10).mul(1.5) == cTimeval(15));
+
+        // nanoseconds
+        v.setNs (1999999999);
+        BUG_IF_NOT (v.ns() == 1999999999);
+        BUG_IF_NOT (v.us() == 1999999);
+        BUG_IF_NOT (v.s() == 1);
+        BUG_IF_NOT (v.timeval().tv_usec == 999999);
+        v.setUs (3);
+        BUG_IF_NOT (v.ns() == 3000);
     }
 #endif
 };
@@ -0,0 +1,74 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ * TCPPUMP <https://github.com/amartin755/tcppump>
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TXOFFLOAD_HPP_
+#define TXOFFLOAD_HPP_
+
+#include <cstdint>
+#include <cstddef>    // size_t
+
+
+/*
+ * Work on a frame, which is left to the kernel or network adapter on transmission (linux: virtio_net_hdr).
+ * If the checksum is offloaded, the checksum field holds the sum of the pseudo header. The sum of the data
+ * from csumStart to the end of the frame is added on transmission.
+ * A super-frame exceeds the MTU and is split on transmission (GSO): TCP into segments of gsoSize payload
+ * bytes, UDP into IP fragments of gsoSize bytes. Super-frames always have an offloaded checksum.
+ */
+struct txOffload
+{
+    enum gso : uint8_t
+    {
+        GSO_NONE,
+        GSO_TCPV4,
+        GSO_TCPV6,
+        GSO_UDP,    // IPv4 and IPv6
+    };
+
+    txOffload () : csumStart (0), csumOffset (0), gsoType (GSO_NONE), gsoSize (0), gsoHdrLen (0) {}
+
+    bool needsChecksum (void) const {return csumStart != 0;}
+    bool isSuperFrame (void) const {return gsoType != GSO_NONE;}
+
+    /*
+     * Returns the number of frames on the wire for a frame of length bytes. All of them, except the last one,
+     * have segLength bytes. TCP segments repeat the headers up to the TCP payload, IP fragments split
+     * everything behind the IP header (csumStart).
+     */
+    size_t segments (size_t length, size_t& segLength, size_t& lastLength) const
+    {
+        segLength  = length;
+        lastLength = length;
+        const size_t split = gsoType == GSO_UDP ? csumStart : gsoHdrLen;
+        if (!isSuperFrame () || length <= split + gsoSize)
+            return 1;
+
+        const size_t n = (length - split + gsoSize - 1) / gsoSize;
+        segLength  = gsoHdrLen + gsoSize;
+        lastLength = gsoHdrLen + (length - split) - (n - 1) * gsoSize;
+        return n;
+    }
+
+    uint16_t csumStart;     // begin of the data covered by the checksum, 0 if the checksum is complete
+    uint16_t csumOffset;    // of the checksum field relative to csumStart
+    uint8_t  gsoType;       // see enum gso
+    uint16_t gsoSize;       // max. payload per segment or fragment
+    uint16_t gsoHdrLen;     // length of the headers of each segment or fragment (IPv6 incl. fragment header)
+};
+
+#endif /* TXOFFLOAD_HPP_ */
@@ -1,7 +1,7 @@
 // SPDX-License-Identifier: GPL-3.0-only
 /*
  * TCPPUMP <https://github.com/amartin755/tcppump>
- * Copyright (C) 2012-2024 Andreas Martin (netnag@mailbox.org)
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -16,7 +16,12 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <cstdio>
+#include <cstring>
 #include <chrono>
+#include <thread>
+#include <atomic>
+#include <algorithm>
 
 #include "bug.hpp"
 #include "console.hpp"
@@ -25,129 +30,213 @@
 #include "parsehelper.hpp"
 #include "formatexception.hpp"
 #include "fileioexception.hpp"
-#include "pcapfileio.hpp"
+#include "orderdependency.hpp"
+#include "random.hpp"
+
+
+// number of instructions compiled at once by a worker thread
+static const size_t CHUNK_INSTRUCTIONS = 1024;
 
 
 cCompiler::cCompiler (inputType t, const cTimeval& delay, unsigned delayScale, bool optDestMAC, double pcapScaling)
 : type(t), defaultDelay(delay), defaultDelayScale(delayScale), ipOptionalDestMAC(optDestMAC),
-  fileParser (defaultDelay.us()/defaultDelayScale, ipOptionalDestMAC), pcapScalingFactor(pcapScaling)
+  fileParser (defaultDelay.ns()/defaultDelayScale, ipOptionalDestMAC), pcapScalingFactor(pcapScaling), jobs(1),
+  copyMappedFrames(false), input(nullptr), inputIdx(0), inputOpen(false), parsedInstructions(0), chunkIdx(0), readEof(false)
+{
+}
+
+
+void cCompiler::setJobs (unsigned n)
 {
+    jobs = n ? n : 1;
 }
 
 
 cPacketData& cCompiler::operator<< (const std::vector<std::string>& input)
 {
-    switch (type)
-    {
-    case PACKET:
-        processPackets (input);
-        break;
-    case SCRIPT:
-        processScriptFiles (input);
-        break;
-    case PCAP:
-        processPcapFiles (input);
-        break;
-    default:
-        BUG ("unkown input type");
-    }
+    open (input);
+    while (produce (data, SIZE_MAX))
+        ;
+
+    Console::PrintDebug ("Frame storage: %zu bytes used, %zu bytes reserved\n",
+            data.getArena().getUsed(), data.getArena().getReserved());
     return data;
 }
 
 
-void cCompiler::processPcapFiles (const std::vector<std::string>& input)
+void cCompiler::open (const std::vector<std::string>& in)
+{
+    static const char* types[] = {"packets", "script files", "PCAP files"};
+
+    input = &in;
+    rewind ();
+
+    Console::PrintDebug ("Parsing %d %s ...\n", (int)input->size(), types[type]);
+}
+
+
+void cCompiler::rewind (void)
+{
+    closeInput ();
+    inputIdx = 0;
+    currtime.clear ();
+}
+
+
+/*
+ * Compiles the next packets of the input into data, until at least maxPackets ethernet packets were added
+ * or the end of the input is reached. Returns the number of added ethernet packets, 0 at the end of the input.
+ */
+size_t cCompiler::produce (cPacketData& data, size_t maxPackets)
 {
-    Console::PrintDebug ("Parsing %d PCAP files ...\n", (int)input.size());
+    BUG_ON (!input);
+
+    const size_t start = data.getPacketCnt ();
 
-    cTimeval currtime;
-    for (const auto & file : input)
+    // loops refer to the frames of data, so they are never split
+    while (inputIdx < input->size() && (data.getPacketCnt () - start < maxPackets || data.inLoop ()))
     {
-        cPcapFileIO pcap;
-        cTimeval t;
-        int len;
+        const std::string& in = (*input)[inputIdx];
+        bool more = false;
+
+        switch (type)
+        {
+        case PACKET:
+            processPacket (data, in);
+            break;
+        case SCRIPT:
+            more = processScriptInstruction (data, in);
+            break;
+        case PCAP:
+            more = processPcapPacket (data, in);
+            break;
+        default:
+            BUG ("unkown input type");
+        }
+
+        if (!more)
+            inputIdx++;
+    }
+
+    return data.getPacketCnt () - start;
+}
+
 
+void cCompiler::closeInput (void)
+{
+    if (inputOpen)
+    {
+        if (type == SCRIPT)
+        {
+            discardChunks ();
+            fileParser.close ();
+        }
+        else if (type == PCAP)
+            pcap.close ();
+        inputOpen = false;
+    }
+}
+
+
+bool cCompiler::processPcapPacket (cPacketData& data, const std::string& file)
+{
+    if (!inputOpen)
+    {
         Console::PrintDebug ("Open '%s'\n", file.c_str());
 
         if (!pcap.open (file.c_str(), false))
         {
             throw FileIOException (FileIOException::OPEN, file.c_str());
         }
+        inputOpen = true;
+    }
+
+    uint8_t* pcapdata;
+    cTimeval t;
+    int len;
 
-        uint8_t* pcapdata;
-        data.hasUserTimestamps = pcapScalingFactor == 0 ? false : true;
+    data.hasUserTimestamps = pcapScalingFactor == 0 ? false : true;
 
-        while ((pcapdata = pcap.read(&t, &len)) != nullptr)
+    if ((pcapdata = pcap.read(&t, &len)) != nullptr)
+    {
+        if (len < (int)sizeof (mac_header_t))
         {
-            cEthernetPacket* packet = new cEthernetPacket(len);
-            packet->setRaw (pcapdata, len);
-            cTimeval delta(t);
-            packet->setTime (delta.sub (currtime).mul(pcapScalingFactor));
-            currtime.set(t);
+            closeInput ();
+            throw FileIOException (FileIOException::READ, file.c_str());
+        }
+
+        cTimeval delta(t);
+        delta.sub (currtime).mul(pcapScalingFactor);
+        currtime.set(t);
 
-            data.addPacket(packet);
+        // frames of mapped files are sent in place, all others are copied
+        if (pcap.mapping () && !copyMappedFrames)
+        {
+            data.keep (pcap.mapping ());
+            data.addFrame (pcapdata, (size_t)len, delta);
         }
-        if (pcap.error ())
+        else
         {
-            throw FileIOException (FileIOException::READ, file.c_str());
+            data.copyFrame (pcapdata, (size_t)len, delta);
         }
+        return true;
+    }
 
-        pcap.close ();
+    bool error = pcap.error ();
+    closeInput ();
+
+    if (error)
+    {
+        throw FileIOException (FileIOException::READ, file.c_str());
     }
+    return false;
 }
 
 
-void cCompiler::processPackets (const std::vector<std::string>& input)
+void cCompiler::processPacket (cPacketData& data, const std::string& packet)
 {
     cInstructionParser::cResult result;
-    cTimeval timestamp, currtime;
+    cTimeval timestamp;
 
-    Console::PrintDebug ("Parsing %d packets ...\n", (int)input.size());
+    cInstructionParser (ipOptionalDestMAC).parse (packet.c_str(), result);
+    if (result.hasTimestamp)
+    {
+        data.hasUserTimestamps = true;
+    }
+    else
+    {
+        result.timestamp  = defaultDelay.ns()/defaultDelayScale;
+        result.isAbsolute = false;
+    }
+    timestamp.setNs(result.timestamp * defaultDelayScale);
 
-    for (const auto & packet : input)
+    if (!result.isAbsolute)
     {
-        cInstructionParser (ipOptionalDestMAC).parse (packet.c_str(), result);
-        if (result.hasTimestamp)
-        {
-            data.hasUserTimestamps = true;
-        }
+        result.packets->setTime(timestamp);
+        data.addPacket(result.packets);
+        currtime.add (timestamp);
+    }
+    else
+    {
+        if (timestamp < currtime)  // FIXME What to do if timestamp < currtime? delay = 0 or parse exception?
+            BUG ("FIXME");
         else
         {
-            result.timestamp  = defaultDelay.us()/defaultDelayScale;
-            result.isAbsolute = false;
-        }
-        timestamp.setUs(result.timestamp * defaultDelayScale);
-
-        if (!result.isAbsolute)
-        {
-            result.packets->setTime(timestamp);
+            cTimeval delta(timestamp);
+            result.packets->setTime(delta.sub (currtime));
             data.addPacket(result.packets);
-            currtime.add (timestamp);
-        }
-        else
-        {
-            if (timestamp < currtime)  // FIXME What to do if timestamp < currtime? delay = 0 or parse exception?
-                BUG ("FIXME");
-            else
-            {
-                cTimeval delta(timestamp);
-                result.packets->setTime(delta.sub (currtime));
-                data.addPacket(result.packets);
-                currtime.set (timestamp);
-            }
+            currtime.set (timestamp);
         }
     }
 }
 
 
-void cCompiler::processScriptFiles (const std::vector<std::string>& input)
+bool cCompiler::processScriptInstruction (cPacketData& data, const std::string& file)
 {
     cInstructionParser::cResult result;
-    cTimeval timestamp, currtime, scriptStartTime;
     int count;
 
-    Console::PrintDebug ("Parsing %d script files ...\n", (int)input.size());
-
-    for (const auto & file : input)
+    if (!inputOpen)
     {
         Console::PrintDebug ("Open '%s'\n", file.c_str());
 
@@ -155,46 +244,556 @@ void cCompiler::processScriptFiles (const std::vector<std::string>& input)
         {
             throw FileIOException (FileIOException::OPEN, file.c_str());
         }
-
+        inputOpen       = true;
         scriptStartTime = currtime;
-        auto t1 = std::chrono::high_resolution_clock::now();
+        parsedInstructions   = 0;
+        parseStart      = std::chrono::high_resolution_clock::now();
+        blocks.clear ();
+    }
+
+    if ((count = nextInstruction (result) ? 0 : EOF) >= 0)
+    {
+        switch (result.control)
+        {
+        case cInstructionParser::cResult::BLOCK_BEGIN:
+            beginBlock (data, result);
+            break;
+        case cInstructionParser::cResult::BLOCK_END:
+            endBlock (data);
+            break;
+        default:
+            result.packets->setTime(advance (data, result));
+            if (blocks.empty () || !blocks.back ().discard)
+                data.addPacket(result.packets);
+            else
+                delete result.packets;
+            break;
+        }
+        parsedInstructions++;
+        return true;
+    }
+
+    auto elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - parseStart);
+    Console::PrintDebug ("parsed %zu instructions in %.2f usec\n", parsedInstructions, (double)elapsedUs.count());
+
+    closeInput ();
+
+    if (count != EOF)
+        throw FileIOException (FileIOException::READ, file.c_str());
+
+    return false;
+}
+
+
+/*
+ * Returns the delay of a script instruction relative to the previous one and advances the current time.
+ */
+cTimeval cCompiler::advance (cPacketData& data, const cInstructionParser::cResult& result)
+{
+    cTimeval timestamp;
+
+    timestamp.setNs(result.timestamp * defaultDelayScale);
+    if (result.hasTimestamp)
+    {
+        data.hasUserTimestamps = true;
+    }
+
+    if (!result.isAbsolute)
+    {
+        currtime.add (timestamp);
+        return timestamp;
+    }
+
+    timestamp.add(scriptStartTime);
+
+    if (timestamp < currtime) // FIXME What to do if timestamp < currtime? delay = 0 or parse exception?
+        BUG ("FIXME");
+
+    cTimeval delta(timestamp);
+    delta.sub (currtime);
+    currtime.set (timestamp);
+    return delta;
+}
+
+
+/*
+ * The body of a repeated block is compiled once and executed by the output as loop. Blocks, that are never
+ * executed, are compiled anyway to find errors, but their packets are discarded.
+ */
+void cCompiler::beginBlock (cPacketData& data, const cInstructionParser::cResult& result)
+{
+    cBlock block;
+
+    block.start   = currtime;
+    block.repeat  = result.repeat;
+    block.discard = !result.repeat || (!blocks.empty () && blocks.back ().discard);
+
+    cTimeval delay = advance (data, result);
+    block.bodyStart = currtime;
+
+    if (!block.discard)
+        data.beginLoop (block.repeat, delay);
+    blocks.push_back (block);
+}
+
+
+void cCompiler::endBlock (cPacketData& data)
+{
+    BUG_ON (blocks.empty ()); // the file parser ensures, that blocks are balanced
+    const cBlock block = blocks.back ();
+    blocks.pop_back ();
+
+    if (block.discard || !data.endLoop ())
+    {
+        currtime = block.start;
+    }
+    else
+    {
+        // following absolute timestamps are relative to the end of the last execution
+        cTimeval body (currtime);
+        body.sub (block.bodyStart);
+        body.setNs (body.ns () * (block.repeat - 1));
+        currtime.add (body);
+    }
+}
+
+
+/*
+ * Delivers the next compiled instruction of the open script file. Returns false at the end of the file.
+ * With more than one job, chunks of instructions are read ahead and compiled in parallel. The results
+ * are delivered in the order of the file, errors are thrown when the erroneous instruction is reached.
+ */
+bool cCompiler::nextInstruction (cInstructionParser::cResult& result)
+{
+    if (jobs <= 1)
+        return fileParser.parse (result) != EOF;
+
+    for (;;)
+    {
+        if (chunks.empty ())
+        {
+            if (readError)
+            {
+                std::exception_ptr e = readError;
+                readError = nullptr;
+                std::rethrow_exception (e);
+            }
+            if (readEof)
+                return false;
+
+            readChunks ();
+            continue;
+        }
 
-        while ((count = fileParser.parse (result)) >= 0)
+        cChunk& chunk = chunks.front ();
+        if (chunkIdx < chunk.instructions.size ())
         {
-            timestamp.setUs(result.timestamp * defaultDelayScale);
-            if (result.hasTimestamp)
+            const cInstruction& instr = chunk.instructions[chunkIdx];
+
+            // the counters of the calling thread are at the position of the instruction in the script
+            if (chunk.serial || (instr.dependent && (!instr.prepared || instr.first != cOrderDependency::get ())))
+            {
+                if (chunkIdx < chunk.results.size ())
+                {
+                    delete chunk.results[chunkIdx].packets;
+                    chunk.results[chunkIdx].packets = nullptr;
+                }
+                chunkIdx++;
+                fileParser.compile (instr.text, instr.length, instr.line, instr.control, result);
+                return true;
+            }
+            if (chunkIdx < chunk.results.size ())
             {
-                data.hasUserTimestamps = true;
+                if (instr.dependent)
+                    cOrderDependency::set (instr.first + instr.count);
+                result = chunk.results[chunkIdx++];
+                return true;
             }
 
-            if (!result.isAbsolute)
+            // the exception holds a copy of the instruction, so all chunks can be dropped
+            std::exception_ptr e = chunk.error;
+            BUG_ON (!e);
+            chunk.results.clear ();
+            while (!chunks.empty ())
             {
-                result.packets->setTime(timestamp);
-                data.addPacket(result.packets);
-                currtime.add (timestamp);
+                for (auto& r : chunks.back ().results)
+                    delete r.packets;
+                chunks.pop_back ();
             }
-            else
+            chunkIdx = 0;
+            readError = nullptr;
+            readEof   = true;
+            std::rethrow_exception (e);
+        }
+
+        chunks.pop_front ();
+        chunkIdx = 0;
+    }
+}
+
+
+/*
+ * Reads the next chunks of the script file and compiles them by worker threads.
+ */
+void cCompiler::readChunks (void)
+{
+    const size_t maxChunks = 2 * jobs;
+
+    try
+    {
+        while (chunks.size () < maxChunks && !readEof)
+        {
+            chunks.emplace_back ();
+            cChunk& chunk = chunks.back ();
+            chunk.serial = false;
+
+            // instructions of a mapped file are used in place, otherwise they are copied
+            std::vector<size_t> offsets;
+            bool mapped = fileParser.isMapped ();
+            auto resolve = [&] ()
             {
-                timestamp.add(scriptStartTime);
+                for (size_t n = 0; n < offsets.size (); n++)
+                    chunk.instructions[n].text = chunk.text.c_str () + offsets[n];
+            };
 
-                if (timestamp < currtime) // FIXME What to do if timestamp < currtime? delay = 0 or parse exception?
-                    BUG ("FIXME");
-                else
+            try
+            {
+                while (chunk.instructions.size () < CHUNK_INSTRUCTIONS)
                 {
-                    cTimeval delta(timestamp);
-                    result.packets->setTime(delta.sub (currtime));
-                    data.addPacket(result.packets);
-                    currtime.set (timestamp);
+                    unsigned line;
+                    size_t len;
+                    cInstructionParser::cResult::controlType control;
+                    const char* instruction = fileParser.read (line, len, control);
+
+                    if (!instruction)
+                    {
+                        readEof = true;
+                        break;
+                    }
+                    if (!mapped)
+                    {
+                        offsets.push_back (chunk.text.size ());
+                        chunk.text.append (instruction, len);
+                        chunk.text.push_back ('\0');
+                        instruction = nullptr;
+                    }
+                    chunk.instructions.push_back ({instruction, len, line, control, false, false, {}, {}});
                 }
             }
+            catch (...)
+            {
+                resolve ();
+                throw;
+            }
+            resolve ();
+
+            if (chunk.instructions.empty ())
+                chunks.pop_back ();
         }
-        auto t2 = std::chrono::high_resolution_clock::now();
-        auto elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1);
-        Console::PrintDebug ("parsed %zu packets in %.2f usec\n", data.getPacketCnt(), (double)elapsedUs.count());
+    }
+    catch (...)
+    {
+        // thrown after all previous instructions were delivered
+        readError = std::current_exception ();
+        readEof   = true;
+    }
 
-        fileParser.close ();
+    // a single chunk is compiled by the calling thread, while it is consumed
+    if (chunks.size () < 2)
+    {
+        for (auto& chunk : chunks)
+            chunk.serial = true;
+        return;
+    }
 
-        if (count != EOF)
-            throw FileIOException (FileIOException::READ, file.c_str());
+    // the calling thread doesn't compile, as its counters must not be touched
+    auto runWorkers = [this] (void (cCompiler::*compile)(cChunk&) const, size_t chunkCnt)
+    {
+        std::atomic<size_t> next (0);
+        auto worker = [&] ()
+        {
+            size_t n;
+            while ((n = next++) < chunkCnt)
+                (this->*compile) (chunks[n]);
+        };
+
+        std::vector<std::thread> threads;
+        for (size_t n = 0; n < std::min ((size_t)jobs, chunkCnt); n++)
+            threads.emplace_back (worker);
+        for (auto& t : threads)
+            t.join ();
+    };
+
+    runWorkers (&cCompiler::compileChunk, chunks.size ());
+
+    // assign the start values of the counters in script order, beginning with the state of the calling thread
+    cOrderDependency::cCounters counters = cOrderDependency::get ();
+    bool dependent = false;
+    size_t reachable = 0;
+    while (reachable < chunks.size ())
+    {
+        cChunk& chunk = chunks[reachable++];
+        for (size_t n = 0; n < chunk.results.size (); n++)
+        {
+            cInstruction& instr = chunk.instructions[n];
+            if (instr.dependent)
+            {
+                instr.first = counters;
+                counters    = counters + instr.count;
+                dependent   = true;
+            }
+        }
+        // nothing behind an error is delivered
+        if (chunk.error)
+            break;
+    }
+
+    if (dependent)
+        runWorkers (&cCompiler::compileDependent, reachable);
+}
+
+
+/*
+ * Executed by worker threads. Compiles all instructions of a chunk, which don't take counter values,
+ * and counts the values of the others.
+ */
+void cCompiler::compileChunk (cChunk& chunk) const
+{
+    chunk.results.reserve (chunk.instructions.size ());
+
+    for (auto& instr : chunk.instructions)
+    {
+        cInstructionParser::cResult result;
+        std::exception_ptr error;
+
+        cOrderDependency::set (cOrderDependency::cCounters ());
+        cOrderDependency::test ();
+        try
+        {
+            fileParser.compile (instr.text, instr.length, instr.line, instr.control, result);
+        }
+        catch (...)
+        {
+            error = std::current_exception ();
+        }
+        if (cOrderDependency::test ())
+        {
+            // the result is wrong, but the number of taken counter values is known now
+            delete result.packets;
+            instr.dependent = true;
+            instr.count     = cOrderDependency::get ();
+            chunk.results.emplace_back ();
+            continue;
+        }
+        if (error)
+        {
+            chunk.error = error;
+            return;
+        }
+        chunk.results.push_back (result);
+    }
+}
+
+
+/*
+ * Executed by worker threads. Compiles the instructions, that take counter values, with their start values.
+ * If an instruction took another number of values than before (e.g. because the number depends on the
+ * values), it is compiled by the calling thread, when it's consumed.
+ */
+void cCompiler::compileDependent (cChunk& chunk) const
+{
+    for (size_t n = 0; n < chunk.results.size (); n++)
+    {
+        cInstruction& instr = chunk.instructions[n];
+        if (!instr.dependent)
+            continue;
+
+        cOrderDependency::set (instr.first);
+        try
+        {
+            fileParser.compile (instr.text, instr.length, instr.line, instr.control, chunk.results[n]);
+            instr.prepared = cOrderDependency::get () == instr.first + instr.count;
+        }
+        catch (...)
+        {
+            // reported in order by the calling thread
+            instr.prepared = false;
+        }
+        if (!instr.prepared)
+        {
+            delete chunk.results[n].packets;
+            chunk.results[n].packets = nullptr;
+        }
     }
 }
+
+
+void cCompiler::discardChunks (void)
+{
+    if (!chunks.empty ())
+    {
+        cChunk& chunk = chunks.front ();
+        for (size_t n = chunkIdx; n < chunk.results.size (); n++)
+            delete chunk.results[n].packets;
+        chunks.pop_front ();
+    }
+    for (auto& chunk : chunks)
+    {
+        for (auto& r : chunk.results)
+            delete r.packets;
+    }
+    chunks.clear ();
+    chunkIdx  = 0;
+    readError = nullptr;
+    readEof   = false;
+}
+
+
+#ifdef WITH_UNITTESTS
+
+void cCompiler::unitTest ()
+{
+    Console::PrintDebug("-- " __FILE__ " --\n");
+
+    // TCP sequence numbers and IPv4 identifications depend on the order of compilation
+    const char* scriptFile = "unittest.pump";
+    const std::vector<std::string> script = {scriptFile};
+    const cTimeval delay;
+
+    auto writeScript = [&] (size_t errorLine)
+    {
+        FILE* fp = std::fopen (scriptFile, "w");
+        BUG_IF_NOT (fp);
+        for (size_t n = 1; n <= 5000; n++)
+        {
+            if (n == errorLine)
+                std::fprintf (fp, "eth(dmac=11:22:33:44:55:66, payload=0123)456);\n");
+            else if (n % 1500 == 0)
+                std::fprintf (fp, "tcp(dip=10.20.30.40, dmac=11:22:33:44:55:66, sport=1, dport=2, seq=0, ack=0);\n");
+            else if (n % 2200 == 0)
+                std::fprintf (fp, "ipv4(dip=10.20.30.40, dmac=11:22:33:44:55:66, protocol=255, payload=\"%02000zu\");\n", n);
+            else
+                std::fprintf (fp, "eth(dmac=11:22:33:44:55:66, ethertype=0x9000, payload=%08zx);\n", n);
+        }
+        std::fclose (fp);
+    };
+
+    // each compilation starts with the initial order dependent state of a new thread
+    auto compile = [&] (cCompiler& compiler) -> cPacketData&
+    {
+        cPacketData* data = nullptr;
+        std::thread ([&] () { data = &(compiler << script); }).join ();
+        data->pack ();
+        return *data;
+    };
+
+    writeScript (0);
+    cCompiler serial (SCRIPT, delay, 1000000, false, 1.0);
+    cPacketData& expected = compile (serial);
+    BUG_IF_NOT (expected.getFrameCnt () == 5002);
+
+    for (unsigned jobs = 2; jobs <= 5; jobs += 3)
+    {
+        cCompiler parallel (SCRIPT, delay, 1000000, false, 1.0);
+        parallel.setJobs (jobs);
+        cPacketData& data = compile (parallel);
+        BUG_IF_NOT (data.getFrameCnt () == expected.getFrameCnt ());
+        for (size_t n = 0; n < data.getFrameCnt (); n++)
+        {
+            const cPacketData::frame& f = data.getFrames ()[n];
+            const cPacketData::frame& e = expected.getFrames ()[n];
+            BUG_IF_NOT (f.length == e.length && !std::memcmp (f.data, e.data, f.length));
+        }
+    }
+
+    // counter values are assigned in advance and the dependent instructions are compiled in parallel
+    cRandom::setCounterMode (7);
+    FILE* fp = std::fopen (scriptFile, "w");
+    BUG_IF_NOT (fp);
+    for (size_t n = 1; n <= 5000; n++)
+    {
+        if (n % 3 == 0)
+            std::fprintf (fp, "eth(dmac=*, smac=*, ethertype=*, payload=%08zx);\n", n);
+        else if (n % 1700 == 0)
+            std::fprintf (fp, "ipv4(dip=10.20.30.40, dmac=11:22:33:44:55:66, protocol=255, payload=\"%02000zu\");\n", n);
+        else
+            std::fprintf (fp, "eth(dmac=11:22:33:44:55:66, ethertype=0x9000, payload=%08zx);\n", n);
+    }
+    std::fclose (fp);
+    cCompiler serialCounted (SCRIPT, delay, 1000000, false, 1.0);
+    cPacketData& expectedCounted = compile (serialCounted);
+    for (unsigned jobs = 2; jobs <= 5; jobs += 3)
+    {
+        cCompiler parallel (SCRIPT, delay, 1000000, false, 1.0);
+        parallel.setJobs (jobs);
+        cPacketData& data = compile (parallel);
+        BUG_IF_NOT (data.getFrameCnt () == expectedCounted.getFrameCnt ());
+        for (size_t n = 0; n < data.getFrameCnt (); n++)
+        {
+            const cPacketData::frame& f = data.getFrames ()[n];
+            const cPacketData::frame& e = expectedCounted.getFrames ()[n];
+            BUG_IF_NOT (f.length == e.length && !std::memcmp (f.data, e.data, f.length));
+        }
+    }
+    // back to random numbers
+    cRandom::destroy ();
+    cRandom::create ();
+
+    // errors are reported at the position of the erroneous instruction
+    writeScript (3333);
+    for (unsigned jobs = 1; jobs <= 4; jobs += 3)
+    {
+        cCompiler parallel (SCRIPT, delay, 1000000, false, 1.0);
+        parallel.setJobs (jobs);
+        cPacketData data;
+        bool catched = false;
+
+        parallel.open (script);
+        try
+        {
+            while (parallel.produce (data, SIZE_MAX))
+                ;
+        }
+        catch (FileParseException& e)
+        {
+            catched = true;
+            BUG_IF_NOT (e.lineNumber () == 3333);
+            BUG_IF_NOT (std::strstr (e.instruction (), "eth(dmac=11:22:33:44:55:66, payload=0123)456)"));
+        }
+        BUG_IF_NOT (catched);
+        BUG_IF_NOT (data.getPacketCnt () == 3332 + 1); // one fragmented packet
+        parallel.rewind ();
+    }
+
+    // repeated blocks are stored once and executed by loops
+    fp = std::fopen (scriptFile, "w");
+    BUG_IF_NOT (fp);
+    std::fprintf (fp, "eth(dmac=11:22:33:44:55:66, payload=01);\n"
+                      "+5: repeat (1000000) {\n"
+                      "    eth(dmac=11:22:33:44:55:66, payload=02);\n"
+                      "    repeat (3) { eth(dmac=11:22:33:44:55:66, payload=03); }\n"
+                      "    repeat (0) { eth(dmac=11:22:33:44:55:66, payload=04); }\n"
+                      "    repeat (2) { }\n"
+                      "}\n"
+                      "{ eth(dmac=11:22:33:44:55:66, payload=05); }\n"
+                      "eth(dmac=11:22:33:44:55:66, payload=06);\n");
+    std::fclose (fp);
+    for (unsigned jobs = 1; jobs <= 2; jobs++)
+    {
+        cCompiler loops (SCRIPT, delay, 1000000, false, 1.0);
+        loops.setJobs (jobs);
+        cPacketData& data = compile (loops);
+        BUG_IF_NOT (data.getFrameCnt () == 5);
+        BUG_IF_NOT (data.getPacketCnt () == 1 + 4000000 + 2);
+        BUG_IF_NOT (data.getTotalPacketBytes () == data.getPacketCnt () * 15);
+        BUG_IF_NOT (data.getLoopCnt () == 3);
+        const cPacketData::loop* l = data.getLoops ();
+        BUG_IF_NOT (l[0].begin == 1 && l[0].end == 3 && l[0].count == 1000000 && l[0].delay.ms () == 5);
+        BUG_IF_NOT (l[1].begin == 2 && l[1].end == 3 && l[1].count == 3 && l[1].delay.isNull ());
+        BUG_IF_NOT (l[2].begin == 3 && l[2].end == 4 && l[2].count == 1);
+        BUG_IF_NOT (data.getFrames ()[3].data[14] == 0x05);
+    }
+    std::remove (scriptFile);
+}
+
+#endif
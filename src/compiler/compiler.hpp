@@ -1,7 +1,7 @@
 // SPDX-License-Identifier: GPL-3.0-only
 /*
  * TCPPUMP <https://github.com/amartin755/tcppump>
- * Copyright (C) 2012-2021 Andreas Martin (netnag@mailbox.org)
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -23,11 +23,16 @@
 #include <string>
 #include <vector>
 #include <iostream>
+#include <chrono>
+#include <deque>
+#include <exception>
 #include "packetdata.hpp"
 #include "macaddress.hpp"
 #include "ipaddress.hpp"
 #include "timeval.hpp"
 #include "fileparser.hpp"
+#include "pcapfileio.hpp"
+#include "orderdependency.hpp"
 
 
 class cCompiler
@@ -42,10 +47,68 @@ public:
     cCompiler (inputType type, const cTimeval& activeDelay, unsigned defaultDelayScale, bool ipOptionalDestMAC, double pcapScaling);
     cPacketData& operator<< (const std::vector<std::string>& input);
 
+    // piecewise compilation (streaming)
+    void open (const std::vector<std::string>& input);
+    size_t produce (cPacketData& data, size_t maxPackets);
+    void rewind (void);
+
+    // number of threads compiling script files
+    void setJobs (unsigned n);
+
+    // frames of mapped pcap files are copied instead of being used in place, e.g. if they are modified
+    void setCopyMappedFrames (bool copy) {copyMappedFrames = copy;}
+
+#ifdef WITH_UNITTESTS
+    static void unitTest ();
+#endif
+
 private:
-    void processPackets (const std::vector<std::string>& input);
-    void processScriptFiles (const std::vector<std::string>& input);
-    void processPcapFiles (const std::vector<std::string>& input);
+    /*
+     * A chunk of script instructions, which is compiled by worker threads.
+     * Instructions, that take order dependent counter values (see cOrderDependency), are compiled twice:
+     * first to count the values, then with the start values of their position in the script.
+     */
+    struct cInstruction
+    {
+        const char* text;
+        size_t      length;
+        unsigned    line;
+        cInstructionParser::cResult::controlType control;
+        bool        dependent;  // takes counter values
+        bool        prepared;   // result was compiled with the counter values in 'first'
+        cOrderDependency::cCounters first;
+        cOrderDependency::cCounters count;
+    };
+    struct cChunk
+    {
+        std::string text;   // copy of the instructions, each terminated by zero, if the script file isn't mapped
+        std::vector<cInstruction> instructions;
+        std::vector<cInstructionParser::cResult> results;
+        std::exception_ptr error;   // error of the instruction following the last result
+        bool serial;                // compiled by the calling thread, while it is consumed
+    };
+
+    bool nextInstruction (cInstructionParser::cResult& result);
+    void readChunks (void);
+    void compileChunk (cChunk& chunk) const;
+    void compileDependent (cChunk& chunk) const;
+    void discardChunks (void);
+    // open control block of a script
+    struct cBlock
+    {
+        uint64_t repeat;
+        cTimeval start;     // before the header
+        cTimeval bodyStart; // after the header
+        bool     discard;   // the block or an enclosing one is never executed
+    };
+
+    void processPacket (cPacketData& data, const std::string& packet);
+    bool processScriptInstruction (cPacketData& data, const std::string& file);
+    cTimeval advance (cPacketData& data, const cInstructionParser::cResult& result);
+    void beginBlock (cPacketData& data, const cInstructionParser::cResult& result);
+    void endBlock (cPacketData& data);
+    bool processPcapPacket (cPacketData& data, const std::string& file);
+    void closeInput (void);
 
     cPacketData data;
     inputType type;
@@ -53,7 +116,23 @@ private:
     unsigned defaultDelayScale;
     bool ipOptionalDestMAC;
     cFileParser fileParser;
+    cPcapFileIO pcap;
     double pcapScalingFactor;
+    unsigned jobs;
+    bool copyMappedFrames;
+
+    const std::vector<std::string>* input;
+    size_t   inputIdx;      // current packet or file of input
+    bool     inputOpen;     // file of inputIdx is open
+    cTimeval currtime;
+    cTimeval scriptStartTime;
+    size_t   parsedInstructions;
+    std::vector<cBlock> blocks;
+    std::deque<cChunk> chunks;  // compiled, but not yet consumed instructions of the current script
+    size_t   chunkIdx;          // next instruction of chunks.front()
+    std::exception_ptr readError;
+    bool     readEof;
+    std::chrono::high_resolution_clock::time_point parseStart;
 };
 
 #endif /* COMPILER_HPP_ */
@@ -1,7 +1,7 @@
 // SPDX-License-Identifier: GPL-3.0-only
 /*
  * TCPPUMP <https://github.com/amartin755/tcppump>
- * Copyright (C) 2012-2021 Andreas Martin (netnag@mailbox.org)
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -20,6 +20,9 @@
 #include <cstdio>
 #include <cctype>
 #include <cstring>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 #include "fileparser.hpp"
 
@@ -32,9 +35,11 @@
 
 cFileParser::cFileParser (uint64_t defaultDelay, bool ipOptionalDestMAC)
 {
-    instructionBufferSize = 0;
-    instructionBuffer     = nullptr;
     fp                    = nullptr;
+    data                  = nullptr;
+    size                  = 0;
+    pos                   = 0;
+    linePos               = 0;
     lineNbr               = 1;
     delay                 = defaultDelay;
     path                  = nullptr;
@@ -45,21 +50,36 @@ cFileParser::cFileParser (uint64_t defaultDelay, bool ipOptionalDestMAC)
 
 cFileParser::~cFileParser ()
 {
-    std::free (instructionBuffer);
     close ();
 }
 
 bool cFileParser::open (const char* filepath)
 {
-    BUG_ON (fp);
+    BUG_ON (fp || file.isOpen ());
 
-    if ((fp = std::fopen (filepath, "rt")) == NULL)
+    // "-" reads the script from stdin
+    if (!std::strcmp (filepath, "-"))
+    {
+        fp       = stdin;
+        filepath = "stdin";
+    }
+    // regular files are mapped, everything else (e.g. pipes) is read block by block
+    else if (file.open (filepath))
+    {
+        file.sequential ();
+    }
+    else if ((fp = std::fopen (filepath, "rt")) == NULL)
     {
         return false;
     }
 
-    lineNbr    =  1;
-    this->path = filepath;
+    data              = file.isOpen () ? (char*)file.data () : nullptr;
+    size              = file.isOpen () ? file.size () : 0;
+    pos               = 0;
+    linePos           = 0;
+    lineNbr           = 1;
+    openControlBlocks = 0;
+    this->path        = filepath;
 
     return true;
 }
@@ -68,10 +88,16 @@ void cFileParser::close (void)
 {
     if (fp)
     {
-        std::fclose(fp);
+        if (fp != stdin)
+            std::fclose(fp);
         fp   = nullptr;
-        path = nullptr;
     }
+    file.close ();
+    std::vector<char> ().swap (buffer);
+    copies.clear ();
+    data = nullptr;
+    size = 0;
+    path = nullptr;
 }
 
 /**
@@ -80,107 +106,359 @@ void cFileParser::close (void)
  */
 int cFileParser::parse (cInstructionParser::cResult& result)
 {
-    BUG_ON (!fp);
+    unsigned line;
+    size_t len;
+    cInstructionParser::cResult::controlType control;
+    const char* instruction = read (line, len, control);
+    if (!instruction)
+        return EOF;
 
-    int offset = 0;
-    int c;
-    bool comment = false;
+    compile (instruction, len, line, control, result);
+    return 0;
+}
 
-    while ((c = std::getc (fp)) != EOF)
+/**
+ *  Compiles an instruction of this file. It is thread safe.
+ */
+void cFileParser::compile (const char* instruction, size_t len, unsigned line, cInstructionParser::cResult::controlType control,
+        cInstructionParser::cResult& result) const
+{
+    try
     {
-        if (offset >= instructionBufferSize)
+        switch (control)
         {
-            instructionBufferSize += 10*1024;
-            void* newbuf = std::realloc (instructionBuffer, instructionBufferSize);
-            if (newbuf)
-            {
-                instructionBuffer = (char*)newbuf;
-            }
-            else
-            {
-                // Could not allocate memory! Line too long?!
-                throw std::bad_alloc();
-            }
+        case cInstructionParser::cResult::NONE:
+            result.clear ();
+            result.timestamp = delay;
+            cInstructionParser (ipOptionalDestMAC)
+                    .parse (instruction, len, result);
+            break;
+        case cInstructionParser::cResult::BLOCK_BEGIN:
+            cInstructionParser (ipOptionalDestMAC)
+                    .parseBlock (instruction, len, result);
+            break;
+        case cInstructionParser::cResult::BLOCK_END:
+            result.clear ();
+            result.control = control;
+            break;
         }
+    }
+    catch (ParseException &e)
+    {
+        throw FileParseException (path, (int)line, e.instruction(), e.errorMsg(), e.details(), e.errorBegin(), e.errorLen());
+    }
+}
+
+/*
+ *  Returns the position of the next character, that is relevant for splitting the script
+ *  (';', '#', '{' or '}'), or end if there is none.
+ */
+static size_t findDelimiter (const char* data, size_t p, size_t end)
+{
+#if defined(__SSE2__)
+    const __m128i semicolon = _mm_set1_epi8 (';');
+    const __m128i hash      = _mm_set1_epi8 ('#');
+    const __m128i open      = _mm_set1_epi8 ('{');
+    const __m128i close     = _mm_set1_epi8 ('}');
+
+    for (; p + 16 <= end; p += 16)
+    {
+        __m128i v = _mm_loadu_si128 ((const __m128i*)(data + p));
+        __m128i m = _mm_or_si128 (_mm_or_si128 (_mm_cmpeq_epi8 (v, semicolon), _mm_cmpeq_epi8 (v, hash)),
+                                  _mm_or_si128 (_mm_cmpeq_epi8 (v, open), _mm_cmpeq_epi8 (v, close)));
+        int mask = _mm_movemask_epi8 (m);
+        if (mask)
+            return p + __builtin_ctz (mask);
+    }
+#endif
+    for (; p < end; p++)
+    {
+        char c = data[p];
+        if (c == ';' || c == '#' || c == '{' || c == '}')
+            break;
+    }
+    return p;
+}
 
-        if (c == '#')
+static bool isBlank (const char* data, size_t p, size_t end)
+{
+    for (; p < end; p++)
+    {
+        if (!isspace ((unsigned char)data[p]))
+            return false;
+    }
+    return true;
+}
+
+/**
+ *  Delivers the next instruction, its length and line number. Returns nullptr at the end of the file.
+ *  The instruction is part of the mapped file or the read buffer, see isMapped(), and is not terminated by zero.
+ *  It is compiled later via compile(), e.g. by another thread. For control blocks, the header and an empty
+ *  instruction at the end are delivered.
+ */
+const char* cFileParser::read (unsigned& line, size_t& len, cInstructionParser::cResult::controlType& control)
+{
+    BUG_ON (!fp && !file.isOpen ());
+
+    // copies of the read buffer are only valid until the next call, like the buffer itself
+    if (!isMapped ())
+        copies.clear ();
+
+    bool commented = false;
+    size_t p = pos;
+    for (;;)
+    {
+        p = findDelimiter (data, p, size);
+        if (p >= size)
+        {
+            size_t offset = p - pos;
+            if (!fill ())
+                break;
+            p = pos + offset;
+            continue;
+        }
+
+        switch (data[p])
         {
-            comment = true;
+        // instructions are terminated with ';'
+        case ';':
+        {
+            countLines (p);
+            line    = lineNbr;
+            control = cInstructionParser::cResult::NONE;
+            return deliver (p, commented, len);
         }
-        else
+        // comments are ignored until the end of the line
+        case '#':
         {
-            if (c == '\n')
+            // comments in front of an instruction are simply skipped, within an instruction they are blanked later
+            bool leading = isBlank (data, pos, p);
+            const void* nl;
+            while ((nl = std::memchr (data + p, '\n', size - p)) == nullptr)
             {
-                lineNbr++;
-            }
-            if (comment)
-            {
-                if (c == '\n')
-                {
-                    comment = false;
-                }
+                size_t offset = size - pos;
+                if (!fill ())
+                    break;
+                p = pos + offset;
             }
+            size_t end = nl ? (size_t)((const char*)nl - data) : size;
+            if (leading)
+                pos = end;
+            else
+                commented = true;
+            p = end;
+            break;
+        }
+        // control blocks start with '{', which terminates their header
+        case '{':
+        {
+            countLines (p);
+            openControlBlocks++;
+            Console::PrintDebug("## block start %d\n", lineNbr);
 
-            if (!comment)
-            {
-                // instructions are terminated with ';'
-                if (c == ';')
-                {
-                    instructionBuffer[offset++] = '\0';
-                    result.isAbsolute = false;
-                    result.timestamp  = delay;
-                    try
-                    {
-                        cInstructionParser (ipOptionalDestMAC)
-                                .parse (instructionBuffer, result);
-                        return 0;
-                    }
-                    catch (ParseException &e)
-                    {
-                        throw FileParseException (path, lineNbr, e.instruction(), e.errorMsg(), e.details(), e.errorBegin(), e.errorLen());
-                    }
-                }
-                // control blocks start with '{'
-                else if (c == '{')
-                {
-                    openControlBlocks++;
-                    Console::PrintDebug("## block start %d\n", lineNbr);
-                    // TODO
-                    // - parse timestamp
-                    // - parse control key word and its parameters
-
-                    offset = 0;
-                }
-                // control blocks are terminated with '}'
-                else if (c == '}')
-                {
-                    openControlBlocks--;
-                    instructionBuffer[offset++] = (char)c;
-                    Console::PrintDebug("## block end %d\n", lineNbr);
-                    const char* p = cParseHelper::skipWhitespaces (instructionBuffer);
-                    if (*p != '}')
-                        throw FileParseException (path, lineNbr, instructionBuffer, "syntax error before '}'. Missing ';'?", nullptr, p, 0);
-
-                    if (openControlBlocks < 0)
-                        throw FileParseException (path, lineNbr, instructionBuffer, "Missing matching ‘{’", nullptr, p, 0);
-
-                    // TODO
-                    // generate jump label that points to start of the block
-
-                    offset = 0;
-                }
-                else
-                {
-                    instructionBuffer[offset++] = (char)c;
-                }
-            }
+            line    = lineNbr;
+            control = cInstructionParser::cResult::BLOCK_BEGIN;
+            return deliver (p, commented, len);
+        }
+        // control blocks are terminated with '}'
+        case '}':
+            countLines (p);
+            openControlBlocks--;
+            Console::PrintDebug("## block end %d\n", lineNbr);
+            if (!isBlank (data, pos, p))
+                throwBlockError (p + 1, "syntax error before '}'. Missing ';'?");
+
+            if (openControlBlocks < 0)
+                throwBlockError (p + 1, "Missing matching ‘{’");
+
+            pos     = p + 1;
+            len     = 0;
+            line    = lineNbr;
+            control = cInstructionParser::cResult::BLOCK_END;
+            return data + p;
+        default:
+            BUG ("unexpected delimiter");
         }
     }
 
+    countLines (size);
+    pos = size;
+
     BUG_ON (openControlBlocks < 0); // must be already handled above
 
     if (openControlBlocks > 0)
         throw FileParseException (path, lineNbr, nullptr, "Expected ‘}’ at end of input", nullptr, nullptr, 0);
 
-    return EOF;
+    return nullptr;
+}
+
+/*
+ *  Consumes the text from the current position up to the delimiter at end and returns it. The data itself is
+ *  never modified, so an instruction with comments is copied and the comments are overwritten with blanks.
+ */
+const char* cFileParser::deliver (size_t end, bool commented, size_t& len)
+{
+    const char* instruction = data + pos;
+    len = end - pos;
+    pos = end + 1;
+
+    if (commented)
+    {
+        copies.emplace_back (instruction, len);
+        std::string& copy = copies.back ();
+        for (size_t n = copy.find ('#'); n != std::string::npos; n = copy.find ('#', n))
+        {
+            size_t nl = copy.find ('\n', n);
+            if (nl == std::string::npos)
+                nl = copy.size ();
+            copy.replace (n, nl - n, nl - n, ' ');
+            n = nl;
+        }
+        instruction = copy.c_str ();
+    }
+    return instruction;
+}
+
+/**
+ *  Reads the next block of a not mapped file. Not yet consumed data is moved to the start of the buffer,
+ *  so all previously delivered instructions become invalid. Returns false at the end of the file.
+ */
+bool cFileParser::fill (void)
+{
+    if (!fp)
+        return false;
+
+    if (pos)
+    {
+        if (linePos < pos)
+            countLines (pos);
+        std::memmove (buffer.data (), buffer.data () + pos, size - pos);
+        size    -= pos;
+        linePos -= pos;
+        pos      = 0;
+    }
+    if (buffer.size () - size < BLOCK_SIZE)
+        buffer.resize (size + BLOCK_SIZE);
+
+    size_t n = std::fread (buffer.data () + size, 1, BLOCK_SIZE, fp);
+    data  = buffer.data ();
+    size += n;
+
+    return n > 0;
+}
+
+void cFileParser::countLines (size_t end)
+{
+    const char* p    = data + linePos;
+    const char* last = data + end;
+    while (p < last && (p = (const char*)std::memchr (p, '\n', last - p)) != nullptr)
+    {
+        lineNbr++;
+        p++;
+    }
+    linePos = end;
 }
+
+/*
+ *  Throws an error for the control block text from the current position up to end.
+ */
+void cFileParser::throwBlockError (size_t end, const char* errMsg)
+{
+    errorText.assign (data + pos, end - pos);
+    const char* p = cParseHelper::skipWhitespaces (errorText.c_str ());
+    throw FileParseException (path, lineNbr, errorText.c_str (), errMsg, nullptr, p, 0);
+}
+
+
+#ifdef WITH_UNITTESTS
+
+void cFileParser::unitTest ()
+{
+    Console::PrintDebug("-- " __FILE__ " --\n");
+
+    const char* scriptFile = "unittest.pump";
+    auto writeScript = [&] (const char* script)
+    {
+        FILE* fp = std::fopen (scriptFile, "w");
+        BUG_IF_NOT (fp);
+        std::fputs (script, fp);
+        std::fclose (fp);
+    };
+
+    cFileParser parser (0, false);
+    unsigned line;
+    size_t len;
+    cInstructionParser::cResult::controlType control;
+    const char* p;
+    auto is = [&] (const char* expected)
+    {
+        return len == std::strlen (expected) && !std::memcmp (p, expected, len);
+    };
+
+    writeScript ("# comment; {with} delimiters\n"
+                 "eth(dmac=11:22:33:44:55:66,   # separated; by comment\n"
+                 "    payload=1234);eth();\n"
+                 "repeat (3) {\n"
+                 "    # block\n"
+                 "    ipv4(dip=1.2.3.4);\n"
+                 "}\n"
+                 "  ignored at end of file");
+    BUG_IF_NOT (parser.open (scriptFile));
+    BUG_IF_NOT (parser.isMapped ());
+    BUG_IF_NOT ((p = parser.read (line, len, control)) != nullptr && line == 3 && control == cInstructionParser::cResult::NONE);
+    BUG_IF_NOT (is ("\neth(dmac=11:22:33:44:55:66,                          \n    payload=1234)"));
+    const char* commented = p;
+    BUG_IF_NOT ((p = parser.read (line, len, control)) != nullptr && line == 3 && is ("eth()"));
+    BUG_IF_NOT ((p = parser.read (line, len, control)) != nullptr && line == 4 && control == cInstructionParser::cResult::BLOCK_BEGIN);
+    BUG_IF_NOT (is ("\nrepeat (3) "));
+    BUG_IF_NOT ((p = parser.read (line, len, control)) != nullptr && line == 6 && control == cInstructionParser::cResult::NONE);
+    BUG_IF_NOT (is ("\n    ipv4(dip=1.2.3.4)"));
+    BUG_IF_NOT ((p = parser.read (line, len, control)) != nullptr && line == 7 && control == cInstructionParser::cResult::BLOCK_END);
+    BUG_IF_NOT (len == 0);
+    BUG_IF_NOT (!parser.read (line, len, control));
+    BUG_IF_NOT (!parser.read (line, len, control));
+    // instructions of a mapped file, even the copies with blanked comments, are valid until close
+    BUG_IF_NOT (!std::strncmp (commented, "\neth(dmac=11:22:33:44:55:66,    ", 32));
+    parser.close ();
+
+    // the script file itself is not modified
+    FILE* fp = std::fopen (scriptFile, "r");
+    BUG_IF_NOT (fp);
+    char buf[64];
+    BUG_IF_NOT (std::fgets (buf, sizeof (buf), fp) && !std::strcmp (buf, "# comment; {with} delimiters\n"));
+    std::fclose (fp);
+
+    // empty file
+    writeScript ("");
+    BUG_IF_NOT (parser.open (scriptFile));
+    BUG_IF_NOT (!parser.read (line, len, control));
+    parser.close ();
+
+    // unbalanced control blocks
+    const char* errors[][2] = {
+        {"eth();\n{\n eth()\n}\n", "syntax error before '}'. Missing ';'?"},
+        {"eth();\n}\n", "Missing matching ‘{’"},
+        {"{\neth();\n", "Expected ‘}’ at end of input"}};
+    for (const auto& error : errors)
+    {
+        bool catched = false;
+        writeScript (error[0]);
+        BUG_IF_NOT (parser.open (scriptFile));
+        try
+        {
+            while (parser.read (line, len, control))
+                ;
+        }
+        catch (FileParseException& e)
+        {
+            catched = true;
+            BUG_IF_NOT (!std::strcmp (e.errorMsg (), error[1]));
+        }
+        BUG_IF_NOT (catched);
+        parser.close ();
+    }
+
+    std::remove (scriptFile);
+}
+
+#endif
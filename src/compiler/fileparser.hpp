@@ -1,7 +1,7 @@
 // SPDX-License-Identifier: GPL-3.0-only
 /*
  * TCPPUMP <https://github.com/amartin755/tcppump>
- * Copyright (C) 2012-2021 Andreas Martin (netnag@mailbox.org)
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -22,17 +22,29 @@
 
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
+#include <deque>
 #include <list>
+#include <string>
+#include <vector>
 
 #include "ethernetpacket.hpp"
 #include "ipaddress.hpp"
 #include "macaddress.hpp"
 #include "instructionparser.hpp"
+#include "mappedfile.hpp"
 
 const int PARSE_ERROR = -100;
 
 class cParameterList;
 
+/*
+ * Splits script files into instructions. Regular files are mapped into memory (read-only) and the
+ * instructions are delivered in place as text and length, without their terminating ';'. Other files,
+ * like stdin or pipes, are read in large blocks into a buffer. Instructions containing comments are
+ * copied to blank them. The headers of control blocks (the text before '{') and their ends are
+ * delivered like instructions.
+ */
 class cFileParser
 {
 public:
@@ -40,17 +52,41 @@ public:
     ~cFileParser ();
     bool open (const char* path);
     int parse (cInstructionParser::cResult& result);
+    const char* read (unsigned& line, size_t& len, cInstructionParser::cResult::controlType& control);
+    void compile (const char* instruction, size_t len, unsigned line, cInstructionParser::cResult::controlType control,
+            cInstructionParser::cResult& result) const;
     void close (void);
 
+#ifdef WITH_UNITTESTS
+    static void unitTest ();
+#endif
+
+    // true, if instructions delivered by read() are valid until close(), otherwise only until the next read()
+    bool isMapped (void) const
+    {
+        return file.isOpen ();
+    }
 
 private:
+    bool fill (void);
+    void countLines (size_t end);
+    void throwBlockError (size_t end, const char* errMsg);
+    const char* deliver (size_t end, bool commented, size_t& len);
+
+    static const size_t BLOCK_SIZE = 1024*1024;
 
-    char*  instructionBuffer;
-    int    instructionBufferSize;
+    cMappedFile  file;
+    FILE*        fp;        // stream, if the file can't be mapped
+    std::vector<char> buffer;
+    char*        data;      // content of the file or buffer
+    size_t       size;
+    size_t       pos;       // first not yet consumed byte of data
+    size_t       linePos;   // lines are counted up to this position
+    std::string  errorText;
+    std::deque<std::string> copies;  // instructions with blanked comments
 
     uint64_t     delay;
     bool         ipOptionalDestMAC;
-    FILE*        fp;
     const char*  path;
 
     unsigned     lineNbr;
@@ -61,7 +97,7 @@ class FileParseException : public ParseException
 {
 public:
     FileParseException (const char* file, int lineNbr, const char* inst, const char* errMsg, const char* details, const char* errBegin, int errLen) :
-        ParseException(inst, errMsg, details, errBegin, errLen), m_lineNbr (lineNbr), m_file (file)
+        ParseException(inst, inst ? std::strlen (inst) : 0, errMsg, details, errBegin, errLen), m_lineNbr (lineNbr), m_file (file)
     {
     }
     int lineNumber () const
@@ -20,6 +20,7 @@
 #include <cstdio>
 #include <cctype>
 #include <cstring>
+#include <cerrno>
 
 #include "instructionparser.hpp"
 
@@ -46,8 +47,130 @@
 #include "lldpparser.hpp"
 
 
+/*
+ * Protocol keywords, sorted by name for binary search
+ */
+enum protocolId
+{
+    ID_ARP,
+    ID_ARP_ANNOUNCE,
+    ID_ARP_PROBE,
+    ID_ETH,
+    ID_GRE4,
+    ID_GRE6,
+    ID_ICMP4,
+    ID_ICMP4_ECHO,
+    ID_ICMP4_ECHOR,
+    ID_ICMP4_REDIR,
+    ID_ICMP4_SRCQ,
+    ID_ICMP4_TIMEX,
+    ID_ICMP4_UNREACH,
+    ID_IGMP,
+    ID_IGMP_LEAVE,
+    ID_IGMP_QUERY,
+    ID_IGMP_REPORT,
+    ID_IGMP3_QUERY,
+    ID_IPV4,
+    ID_IPV6,
+    ID_LLDP,
+    ID_RAW,
+    ID_RSTP,
+    ID_STP,
+    ID_STP_TCN,
+    ID_TCP4,
+    ID_TCP6,
+    ID_UDP4,
+    ID_UDP6,
+    ID_VRRP,
+    ID_VRRP3,
+    ID_VXLAN4,
+    ID_VXLAN6
+};
+
+struct protocolKeyword
+{
+    const Protocol* protocol;
+    protocolId id;
+};
+
+static constexpr protocolKeyword keywords[] =
+{
+    {&PR_ARP, ID_ARP},
+    {&PR_ARP_ANNOUNCE, ID_ARP_ANNOUNCE},
+    {&PR_ARP_PROBE, ID_ARP_PROBE},
+    {&PR_ETH, ID_ETH},
+    {&PR_GRE4, ID_GRE4},
+    {&PR_GRE6, ID_GRE6},
+    {&PR_ICMP4, ID_ICMP4},
+    {&PR_ICMP4_ECHO, ID_ICMP4_ECHO},
+    {&PR_ICMP4_ECHOR, ID_ICMP4_ECHOR},
+    {&PR_ICMP4_REDIR, ID_ICMP4_REDIR},
+    {&PR_ICMP4_SRCQ, ID_ICMP4_SRCQ},
+    {&PR_ICMP4_TIMEX, ID_ICMP4_TIMEX},
+    {&PR_ICMP4_UNREACH, ID_ICMP4_UNREACH},
+    {&PR_IGMP, ID_IGMP},
+    {&PR_IGMP_LEAVE, ID_IGMP_LEAVE},
+    {&PR_IGMP_QUERY, ID_IGMP_QUERY},
+    {&PR_IGMP_REPORT, ID_IGMP_REPORT},
+    {&PR_IGMP3_QUERY, ID_IGMP3_QUERY},
+    {&PR_IPV4, ID_IPV4},
+    {&PR_IPV6, ID_IPV6},
+    {&PR_LLDP, ID_LLDP},
+    {&PR_RAW, ID_RAW},
+    {&PR_RSTP, ID_RSTP},
+    {&PR_STP, ID_STP},
+    {&PR_STP_TCN, ID_STP_TCN},
+    {&PR_TCP4, ID_TCP4},
+    {&PR_TCP6, ID_TCP6},
+    {&PR_UDP4, ID_UDP4},
+    {&PR_UDP6, ID_UDP6},
+    {&PR_VRRP, ID_VRRP},
+    {&PR_VRRP3, ID_VRRP3},
+    {&PR_VXLAN4, ID_VXLAN4},
+    {&PR_VXLAN6, ID_VXLAN6}
+};
+static constexpr size_t keywordCnt = sizeof (keywords) / sizeof (keywords[0]);
+
+static constexpr bool isLess (const char* a, const char* b)
+{
+    return *a == *b ? *a && isLess (a + 1, b + 1) : (unsigned char)*a < (unsigned char)*b;
+}
+
+static constexpr bool isSorted (const protocolKeyword* k, size_t n)
+{
+    return n < 2 || (isLess (k[0].protocol->syntax, k[1].protocol->syntax) && isSorted (k + 1, n - 1));
+}
+
+static_assert (isSorted (keywords, keywordCnt), "protocol keywords must be sorted and unique");
+static_assert (keywordCnt == sizeof (all_protos) / sizeof (all_protos[0]), "protocol keyword missing");
+
+
+static const protocolKeyword* findProtocol (const char* keyword, size_t len)
+{
+    size_t first = 0;
+    size_t last  = keywordCnt;
+
+    while (first < last)
+    {
+        size_t mid = (first + last) / 2;
+        const char* syntax = keywords[mid].protocol->syntax;
+        int cmp = std::strncmp (syntax, keyword, len);
+
+        if (!cmp && syntax[len] != '\0')
+            cmp = 1;
+        if (!cmp)
+            return &keywords[mid];
+        if (cmp < 0)
+            first = mid + 1;
+        else
+            last = mid;
+    }
+    return nullptr;
+}
+
+
 cInstructionParser::cInstructionParser (bool optDestMAC)
-: m_currentInstruction (nullptr), m_ipOptionalDestMAC (optDestMAC),  m_recursionDepth (0)
+: m_currentInstruction (nullptr), m_currentEnd (nullptr), m_ipOptionalDestMAC (optDestMAC),  m_recursionDepth (0)
 {
 }
 
@@ -56,10 +179,21 @@ cInstructionParser::~cInstructionParser ()
 {
 }
 
-void cInstructionParser::parse (const char* instruction, cResult& result, bool ignoreTrailingGarbage, bool noEthHeader)
+void cInstructionParser::parse (const char* instruction, cResult& result)
+{
+    parse (instruction, std::strlen (instruction), result);
+}
+
+/**
+ *  Parses the instruction of len characters, which doesn't need to be terminated by zero. The character behind it
+ *  (e.g. the ';' of a script or the '>' of an embedded packet) must not be part of a token, as it stops the scanner.
+ */
+void cInstructionParser::parse (const char* instruction, size_t len, cResult& result, bool ignoreTrailingGarbage, bool noEthHeader)
 {
     const char* prevInstruction = m_currentInstruction; // save in case of recursion
+    const char* prevEnd         = m_currentEnd;
     m_currentInstruction = instruction;
+    m_currentEnd         = instruction + len;
 
     const char* p = instruction;
     const char* keyword;
@@ -70,7 +204,7 @@ void cInstructionParser::parse (const char* instruction, cResult& result, bool i
     p = parseProtocollIdentifier (p, &keyword, &keywordLen);
 
     // parse protocol parameter list
-    cParameterList params (p, ignoreTrailingGarbage);
+    cParameterList params (p, m_currentEnd - p, ignoreTrailingGarbage);
     if (!params.isValid ())
     {
         throwParseException ("Syntax error", params.getParseError ());
@@ -83,78 +217,116 @@ void cInstructionParser::parse (const char* instruction, cResult& result, bool i
         if (++m_recursionDepth > 8)
             throwParseException ("Maximum depth of embedded instructions reached", keyword, keywordLen);
 
-        //TODO find better way for protocol selection (e.g. hash table)
-        if (!strncmp (PR_RAW.syntax, keyword, keywordLen))
+        const protocolKeyword* protocol = findProtocol (keyword, keywordLen);
+        if (!protocol)
+            throwParseException ("Unknown protocol type", keyword, keywordLen);
+
+        switch (protocol->id)
+        {
+        case ID_RAW:
             result.packets = compileRAW (noEthHeader, params);
-        else if (!strncmp (PR_ETH.syntax, keyword, keywordLen))
+            break;
+        case ID_ETH:
             result.packets = compileETH (params);
-        else if (!strncmp (PR_ARP.syntax, keyword, keywordLen))
+            break;
+        case ID_ARP:
             result.packets = compileARP (params);
-        else if (!strncmp (PR_ARP_PROBE.syntax, keyword, keywordLen))
+            break;
+        case ID_ARP_PROBE:
             result.packets = compileARP (params, true);
-        else if (!strncmp (PR_ARP_ANNOUNCE.syntax, keyword, keywordLen))
+            break;
+        case ID_ARP_ANNOUNCE:
             result.packets = compileARP (params, false, true);
-        else if (!strncmp (PR_IPV4.syntax, keyword, keywordLen))
+            break;
+        case ID_IPV4:
             result.packets = compileIP (noEthHeader, params, false);
-        else if (!strncmp (PR_IPV6.syntax, keyword, keywordLen))
+            break;
+        case ID_IPV6:
             result.packets = compileIP (noEthHeader, params, true);
-        else if (!strncmp (PR_UDP4.syntax, keyword, keywordLen))
+            break;
+        case ID_UDP4:
             result.packets = compileUDP (noEthHeader, params, false);
-        else if (!strncmp (PR_UDP6.syntax, keyword, keywordLen))
+            break;
+        case ID_UDP6:
             result.packets = compileUDP (noEthHeader, params, true);
-        else if (!strncmp (PR_VRRP.syntax, keyword, keywordLen))
+            break;
+        case ID_VRRP:
             result.packets = compileVRRP (noEthHeader, params, 2);
-        else if (!strncmp (PR_VRRP3.syntax, keyword, keywordLen))
+            break;
+        case ID_VRRP3:
             result.packets = compileVRRP (noEthHeader, params, 3);
-        else if (!strncmp (PR_STP.syntax, keyword, keywordLen))
+            break;
+        case ID_STP:
             result.packets = compileSTP (noEthHeader, params);
-        else if (!strncmp (PR_STP_TCN.syntax, keyword, keywordLen))
+            break;
+        case ID_STP_TCN:
             result.packets = compileSTP (noEthHeader, params, false, true);
-        else if (!strncmp (PR_RSTP.syntax, keyword, keywordLen))
+            break;
+        case ID_RSTP:
             result.packets = compileSTP (noEthHeader, params, true);
-        else if (!strncmp (PR_IGMP.syntax, keyword, keywordLen))
+            break;
+        case ID_IGMP:
             result.packets = compileIGMP (noEthHeader, params, false, false, false, false);
-        else if (!strncmp (PR_IGMP_QUERY.syntax, keyword, keywordLen))
+            break;
+        case ID_IGMP_QUERY:
             result.packets = compileIGMP (noEthHeader, params, false, true, false, false);
-        else if (!strncmp (PR_IGMP3_QUERY.syntax, keyword, keywordLen))
+            break;
+        case ID_IGMP3_QUERY:
             result.packets = compileIGMP (noEthHeader, params, true, true, false, false);
-        else if (!strncmp (PR_IGMP_REPORT.syntax, keyword, keywordLen))
+            break;
+        case ID_IGMP_REPORT:
             result.packets = compileIGMP (noEthHeader, params, false, false, true, false);
-        else if (!strncmp (PR_IGMP_LEAVE.syntax, keyword, keywordLen))
+            break;
+        case ID_IGMP_LEAVE:
             result.packets = compileIGMP (noEthHeader, params, false, false, false, true);
-        else if (!strncmp (PR_ICMP4.syntax, keyword, keywordLen))
+            break;
+        case ID_ICMP4:
             result.packets = compileICMP (noEthHeader, params);
-        else if (!strncmp (PR_ICMP4_UNREACH.syntax, keyword, keywordLen))
+            break;
+        case ID_ICMP4_UNREACH:
             result.packets = compileICMPWithEmbedded (noEthHeader, params, 3);
-        else if (!strncmp (PR_ICMP4_SRCQ.syntax, keyword, keywordLen))
+            break;
+        case ID_ICMP4_SRCQ:
             result.packets = compileICMPWithEmbedded (noEthHeader, params, 4);
-        else if (!strncmp (PR_ICMP4_TIMEX.syntax, keyword, keywordLen))
+            break;
+        case ID_ICMP4_TIMEX:
             result.packets = compileICMPWithEmbedded (noEthHeader, params, 11);
-        else if (!strncmp (PR_ICMP4_REDIR.syntax, keyword, keywordLen))
+            break;
+        case ID_ICMP4_REDIR:
             result.packets = compileICMPRedirect (noEthHeader, params);
-        else if (!strncmp (PR_ICMP4_ECHO.syntax, keyword, keywordLen))
+            break;
+        case ID_ICMP4_ECHO:
             result.packets = compileICMPPing (noEthHeader, params, false);
-        else if (!strncmp (PR_ICMP4_ECHOR.syntax, keyword, keywordLen))
+            break;
+        case ID_ICMP4_ECHOR:
             result.packets = compileICMPPing (noEthHeader, params, true);
-        else if (!strncmp (PR_TCP4.syntax, keyword, keywordLen))
+            break;
+        case ID_TCP4:
             result.packets = compileTCP (noEthHeader, params, false);
-        else if (!strncmp (PR_TCP6.syntax, keyword, keywordLen))
+            break;
+        case ID_TCP6:
             result.packets = compileTCP (noEthHeader, params, true);
-        else if (!strncmp (PR_VXLAN4.syntax, keyword, keywordLen))
+            break;
+        case ID_VXLAN4:
             result.packets = compileVXLAN (noEthHeader, params, false);
-        else if (!strncmp (PR_VXLAN6.syntax, keyword, keywordLen))
+            break;
+        case ID_VXLAN6:
             result.packets = compileVXLAN (noEthHeader, params, true);
-        else if (!strncmp (PR_GRE4.syntax, keyword, keywordLen))
+            break;
+        case ID_GRE4:
             result.packets = compileGRE (noEthHeader, params, false);
-        else if (!strncmp (PR_GRE6.syntax, keyword, keywordLen))
+            break;
+        case ID_GRE6:
             result.packets = compileGRE (noEthHeader, params, true);
-        else if (!strncmp (PR_LLDP.syntax, keyword, keywordLen))
+            break;
+        case ID_LLDP:
             result.packets = compileLLDP (noEthHeader, params);
-        else
-            throwParseException ("Unknown protocol type", keyword, keywordLen);
+            break;
+        }
 
         params.checkForUnusedParameters ();
         m_currentInstruction = prevInstruction;
+        m_currentEnd         = prevEnd;
         m_recursionDepth--;
         return;
     }
@@ -172,7 +344,7 @@ void cInstructionParser::parse (const char* instruction, cResult& result, bool i
         switch (e.what ())
         {
         case exParUnknown:
-            throwParseException ("Missing parameter", p, std::strlen (p), e.value ());
+            throwParseException ("Missing parameter", p, m_currentEnd - p, e.value ());
             break;
         case exParRange:
             throwParseException ("Range of parameter violated", e.value (), e.valueLength ());
@@ -191,6 +363,49 @@ void cInstructionParser::parse (const char* instruction, cResult& result, bool i
     BUG ("BUG: unreachable code");
 }
 
+/**
+ *  Parses the header of a control block, e.g. "100: repeat (5)". Like instructions, blocks may start with a
+ *  timestamp. A block without control keyword is executed once.
+ */
+void cInstructionParser::parseBlock (const char* header, size_t len, cResult& result)
+{
+    static const char REPEAT[] = "repeat";
+
+    m_currentInstruction = header;
+    m_currentEnd         = header + len;
+    result.clear ();
+    result.control = cResult::BLOCK_BEGIN;
+
+    const char* p = parseTimestamp (header, result.hasTimestamp, result.timestamp, result.isAbsolute);
+    p = cParseHelper::skipWhitespaces (p);
+    if (p >= m_currentEnd)
+        return;
+
+    const char* keyword = p;
+    while (isalpha (*p))
+        p++;
+    if ((size_t)(p - keyword) != sizeof (REPEAT) - 1 || std::strncmp (keyword, REPEAT, sizeof (REPEAT) - 1))
+        throwParseException ("Unknown control block", keyword, p - keyword);
+
+    const char* arg = cParseHelper::nextCharIgnoreWhitspaces (p, '(');
+    if (!arg)
+        throwParseException ("Expected '(' after control keyword", keyword, p - keyword);
+    arg = cParseHelper::skipWhitespaces (arg + 1);
+
+    char* end;
+    errno = 0;
+    result.repeat = isdigit (*arg) ? std::strtoull (arg, &end, 10) : 0;
+    if (!isdigit (*arg) || errno == ERANGE)
+        throwParseException ("Invalid number of repetitions", arg);
+
+    p = cParseHelper::nextCharIgnoreWhitspaces (end, ')');
+    if (!p)
+        throwParseException ("Expected ')'", end);
+    p = cParseHelper::skipWhitespaces (p + 1);
+    if (p < m_currentEnd)
+        throwParseException ("Syntax error", p);
+}
+
 const char* cInstructionParser::parseTimestamp (const char* p, bool& hasTimestamp, uint64_t& timestamp, bool& isAbsolute)
 {
     hasTimestamp = false;
@@ -259,53 +474,52 @@ cLinkable* cInstructionParser::compileRAW (bool noEthHeader, cParameterList& par
 
     for (auto &par : params)
     {
-        auto name = par.name();
         params.setParameterUsed (&par, true);
-        if (!strncmp (PAR_RAW_BYTE.syntax, name.first, name.second))
+        if (par.is (PAR_RAW_BYTE.syntax))
         {
             payload << par.asInt8 ();
         }
-        else if (!strncmp (PAR_RAW_BE16.syntax, name.first, name.second))
+        else if (par.is (PAR_RAW_BE16.syntax))
         {
             payload << toBE16 (par.asInt16 ());
         }
-        else if (!strncmp (PAR_RAW_BE32.syntax, name.first, name.second))
+        else if (par.is (PAR_RAW_BE32.syntax))
         {
             payload << toBE32 (par.asInt32 ());
         }
-        else if (!strncmp (PAR_RAW_BE64.syntax, name.first, name.second))
+        else if (par.is (PAR_RAW_BE64.syntax))
         {
             payload << toBE64 (par.asInt64 ());
         }
-        else if (!strncmp (PAR_RAW_LE16.syntax, name.first, name.second))
+        else if (par.is (PAR_RAW_LE16.syntax))
         {
             payload << toLE16 (par.asInt16 ());
         }
-        else if (!strncmp (PAR_RAW_LE32.syntax, name.first, name.second))
+        else if (par.is (PAR_RAW_LE32.syntax))
         {
             payload << toLE32 (par.asInt32 ());
         }
-        else if (!strncmp (PAR_RAW_LE64.syntax, name.first, name.second))
+        else if (par.is (PAR_RAW_LE64.syntax))
         {
             payload << toLE64 (par.asInt64 ());
         }
-        else if (!strncmp (PAR_RAW_IP4.syntax, name.first, name.second))
+        else if (par.is (PAR_RAW_IP4.syntax))
         {
             cIPv4 ip4 = par.asIPv4 ();
             payload.append (ip4.getAsArray(), 4);
         }
-        else if (!strncmp (PAR_RAW_IP6.syntax, name.first, name.second))
+        else if (par.is (PAR_RAW_IP6.syntax))
         {
             cIPv6 ip6 = par.asIPv6 ();
             payload.append (ip6.getAsArray(), 16);
         }
-        else if (!strncmp (PAR_RAW_MAC.syntax, name.first, name.second))
+        else if (par.is (PAR_RAW_MAC.syntax))
         {
             cMacAddress mac = par.asMac ();
             payload.append (mac.get (), mac.size ());
         }
         // TODO do we want to allow embedded packets? If yes with or without Ethernet header?
-        else if (!strncmp (PAR_RAW_STREAM.syntax, name.first, name.second))
+        else if (par.is (PAR_RAW_STREAM.syntax))
         {
             size_t len;
             const uint8_t* value = par.asStream(len);
@@ -357,7 +571,7 @@ bool cInstructionParser::compileMacHeader (cParameterList& params, cEthernetPack
 }
 
 
-cMacAddress cInstructionParser::getParameterOrOwnMac (cParameterList& params, const char* par) const
+cMacAddress cInstructionParser::getParameterOrOwnMac (cParameterList& params, const cParameterName& par) const
 {
     const cParameter* optionalPar = params.findParameter (par, true);
 
@@ -365,7 +579,7 @@ cMacAddress cInstructionParser::getParameterOrOwnMac (cParameterList& params, co
 }
 
 
-cIPv4 cInstructionParser::getParameterOrOwnIPv4 (cParameterList& params, const char* par) const
+cIPv4 cInstructionParser::getParameterOrOwnIPv4 (cParameterList& params, const cParameterName& par) const
 {
     const cParameter* optionalPar = params.findParameter (par, true);
 
@@ -373,7 +587,7 @@ cIPv4 cInstructionParser::getParameterOrOwnIPv4 (cParameterList& params, const c
 }
 
 
-cIPv6 cInstructionParser::getParameterOrOwnIPv6 (cParameterList& params, const char* par) const
+cIPv6 cInstructionParser::getParameterOrOwnIPv6 (cParameterList& params, const cParameterName& par) const
 {
     const cParameter* optionalPar = params.findParameter (par, true);
 
@@ -390,23 +604,11 @@ const uint8_t* cInstructionParser::compileEmbedded (cParameter* emb, bool noEthH
     {
         cResult res;
 
-        // save current mtu and increase it as we don't want to limit the size of embedded packets.
+        // increase the mtu of this thread as we don't want to limit the size of embedded packets.
         // 32K is a arbitrary limit, just to avoid generation of pakets that are impossible to send
-        unsigned mtu = cSettings::get().getMyMTU();
-        cSettings::get().setMyMTU (32*1024);
-
-        try
         {
-            parse ((char*)payload, res, true, noEthHeader);
-
-            // restore changed mtu
-            cSettings::get().setMyMTU (mtu);
-        }
-        catch (...)
-        {
-            // restore changed mtu
-            cSettings::get().setMyMTU (mtu);
-            throw;
+            cSettings::cThreadMTU mtu (32*1024);
+            parse ((const char*)payload, len, res, true, noEthHeader);
         }
 
 
@@ -559,24 +761,29 @@ cLinkable* cInstructionParser::compileARP (cParameterList& params, bool isProbe,
 
 
 // returns true, if destination IP address is a multicast address
-bool cInstructionParser::parseIPv4Params (cParameterList& params, cIPPacket* packet, bool noDestinationIP)
+bool cInstructionParser::parseIPv4Params (cParameterList& params, cIPPacket* packet, bool noDestinationIP, bool allowMutations)
 {
     bool isMulticast = false;
+    cIPPacket* mutablePacket = allowMutations ? packet : nullptr;
 
     packet->setDSCP         (params.findParameter (PAR_IP_DSCP.syntax, (uint32_t)0)->asInt8(0, 0x3f));
     packet->setECN          (params.findParameter (PAR_IP_ECN.syntax, (uint32_t)0)->asInt8(0, 3));
-    packet->setTimeToLive   (params.findParameter (PAR_IP_TTL.syntax, (uint32_t)64)->asInt8());
+    packet->setTimeToLive   ((uint8_t)parseMutableInt (params.findParameter (PAR_IP_TTL.syntax, (uint32_t)64), mutablePacket, cIPPacket::FIELD_TTL, 0xff));
     packet->setDontFragment (params.findParameter (PAR_IP4_DF.syntax, (uint32_t)0)->asInt8(0, 1));
     if (!noDestinationIP)
     {
-        const cIPv4 destIP = params.findParameter (PAR_IP_DIP.syntax)->asIPv4();
+        const cIPv4 destIP = parseMutableIPv4 (params.findParameter (PAR_IP_DIP.syntax), mutablePacket, cIPPacket::FIELD_DESTINATION);
         packet->setDestination (destIP);
         isMulticast = destIP.isMulticast();
     }
-    packet->setSource (getParameterOrOwnIPv4 (params, PAR_IP_SIP.syntax));
-    cParameter* optionalPar = params.findParameter (PAR_IP4_ID.syntax, true);
+    cParameter* optionalPar = params.findParameter (PAR_IP_SIP.syntax, true);
     if (optionalPar)
-        packet->setIdentification(optionalPar->asInt16());
+        packet->setSource (parseMutableIPv4 (optionalPar, mutablePacket, cIPPacket::FIELD_SOURCE));
+    else
+        packet->setSource (cSettings::get().getMyIPv4());
+    optionalPar = params.findParameter (PAR_IP4_ID.syntax, true);
+    if (optionalPar)
+        packet->setIdentification((uint16_t)parseMutableInt (optionalPar, mutablePacket, cIPPacket::FIELD_IDENTIFICATION, 0xffff));
     optionalPar = params.findParameter (PAR_IP4_CHKSUM.syntax, true);
     if (optionalPar)
         packet->setHeaderChksum (optionalPar->asInt16());
@@ -585,13 +792,14 @@ bool cInstructionParser::parseIPv4Params (cParameterList& params, cIPPacket* pac
 
 
 // returns true, if destination IP address is a multicast address
-bool cInstructionParser::parseIPv6Params (cParameterList& params, cIPPacket* packet, bool noDestinationIP)
+bool cInstructionParser::parseIPv6Params (cParameterList& params, cIPPacket* packet, bool noDestinationIP, bool allowMutations)
 {
     bool isMulticast = false;
 
     packet->setDSCP       (params.findParameter (PAR_IP_DSCP.syntax, (uint32_t)0)->asInt8(0, 0x3f));
     packet->setECN        (params.findParameter (PAR_IP_ECN.syntax,  (uint32_t)0)->asInt8(0, 3));
-    packet->setTimeToLive (params.findParameter (PAR_IP_TTL.syntax, (uint32_t)64)->asInt8());
+    packet->setTimeToLive ((uint8_t)parseMutableInt (params.findParameter (PAR_IP_TTL.syntax, (uint32_t)64),
+            allowMutations ? packet : nullptr, cIPPacket::FIELD_TTL, 0xff));
 
     if (!noDestinationIP)
     {
@@ -608,13 +816,70 @@ bool cInstructionParser::parseIPv6Params (cParameterList& params, cIPPacket* pac
 }
 
 
+/*
+ * Returns the integer value of a parameter. If a packet is given, the value may change with each
+ * transmission of the packet (see cParameter::asMutation), then the value of the first transmission
+ * is returned.
+ */
+uint32_t cInstructionParser::parseMutableInt (cParameter* par, cIPPacket* packet, cIPPacket::mutableField field, uint32_t rangeEnd)
+{
+    if (!par->isMutable ())
+        return par->asInt32 (0, rangeEnd);
+
+    // embedded packets are just payload of the sent frames
+    if (!packet || m_recursionDepth > 1)
+        par->throwValueException ();
+
+    cFieldMutation m = par->asMutation (rangeEnd, false);
+    const uint32_t v = m.initial ();
+    packet->addMutation (field, m);
+    return v;
+}
+
+
+cIPv4 cInstructionParser::parseMutableIPv4 (cParameter* par, cIPPacket* packet, cIPPacket::mutableField field)
+{
+    if (!par->isMutable ())
+        return par->asIPv4 ();
+
+    if (!packet || m_recursionDepth > 1)
+        par->throwValueException ();
+
+    cFieldMutation m = par->asMutation (0xffffffff, true);
+    struct in_addr ip;
+    ip.s_addr = htonl (m.initial ());
+    packet->addMutation (field, m);
+    return cIPv4 (ip);
+}
+
+
+// the checksums of embedded packets are part of the payload of their outer packet
+bool cInstructionParser::useChecksumOffload (void) const
+{
+    return cSettings::get().useChecksumOffload () && m_recursionDepth <= 1;
+}
+
+bool cInstructionParser::useSegmentationOffload (void) const
+{
+    return cSettings::get().useSegmentationOffload () && m_recursionDepth <= 1;
+}
+
+
+// must be called after the packet was compiled
+void cInstructionParser::locateMutations (cIPPacket* packet)
+{
+    if (!packet->locateMutations ())
+        throwParseException ("Values per transmission are not supported for fragmented packets", nullptr);
+}
+
+
 cLinkable* cInstructionParser::compileIP (bool noEthHeader, cParameterList& params, bool isIPv6)
 {
     cIPPacket* ippacket = new cIPPacket(isIPv6);
     try
     {
         cEthernetPacket& eth = ippacket->getFirstEthernetPacket();
-        bool destIsMulticast = isIPv6 ? parseIPv6Params (params, ippacket) : parseIPv4Params (params, ippacket);
+        bool destIsMulticast = isIPv6 ? parseIPv6Params (params, ippacket, false, true) : parseIPv4Params (params, ippacket, false, true);
 
         if (!noEthHeader)
         {
@@ -625,6 +890,7 @@ cLinkable* cInstructionParser::compileIP (bool noEthHeader, cParameterList& para
         size_t len;
         const uint8_t* payload = params.findParameter (PAR_IP_PAYLOAD.syntax)->asStream(len);
         ippacket->compile (params.findParameter (PAR_IP_PROTOCOL.syntax)->asInt8(), nullptr, 0, payload, len);
+        locateMutations (ippacket);
     }
     catch (...)
     {
@@ -641,8 +907,11 @@ cLinkable* cInstructionParser::compileUDP (bool noEthHeader, cParameterList& par
     cUdpPacket* udppacket = new cUdpPacket (isIPv6);
     try
     {
+        // explicit checksums are never offloaded
+        udppacket->setChecksumOffload (useChecksumOffload () && !params.findParameter (PAR_UDP_CHKSUM.syntax, true));
+        udppacket->setSegmentationOffload (useSegmentationOffload ());
         cEthernetPacket& eth = udppacket->getFirstEthernetPacket();
-        bool destIsMulticast = isIPv6 ? parseIPv6Params (params, udppacket) : parseIPv4Params (params, udppacket);
+        bool destIsMulticast = isIPv6 ? parseIPv6Params (params, udppacket, false, true) : parseIPv4Params (params, udppacket, false, true);
 
         if (!noEthHeader)
         {
@@ -650,8 +919,8 @@ cLinkable* cInstructionParser::compileUDP (bool noEthHeader, cParameterList& par
             compileMacHeader  (params, &eth, false, m_ipOptionalDestMAC || destIsMulticast);
             compileVLANTags   (params, &eth);
         }
-        udppacket->setSourcePort(params.findParameter (PAR_UDP_SPORT.syntax)->asInt16());
-        udppacket->setDestinationPort(params.findParameter (PAR_UDP_DPORT.syntax)->asInt16());
+        udppacket->setSourcePort((uint16_t)parseMutableInt (params.findParameter (PAR_UDP_SPORT.syntax), udppacket, cIPPacket::FIELD_SOURCE_PORT, 0xffff));
+        udppacket->setDestinationPort((uint16_t)parseMutableInt (params.findParameter (PAR_UDP_DPORT.syntax), udppacket, cIPPacket::FIELD_DESTINATION_PORT, 0xffff));
 
         size_t len = 0;
         const uint8_t* payload = nullptr;
@@ -663,6 +932,7 @@ cLinkable* cInstructionParser::compileUDP (bool noEthHeader, cParameterList& par
         optionalPar = params.findParameter (PAR_UDP_CHKSUM.syntax, true);
         if (optionalPar)
             udppacket->setChecksum (optionalPar->asInt16());
+        locateMutations (udppacket);
     }
     catch (...)
     {
@@ -719,8 +989,10 @@ cLinkable* cInstructionParser::compileTCP (bool noEthHeader, cParameterList& par
     cTcpPacket* tcppacket = new cTcpPacket (isIPv6);
     try
     {
+        tcppacket->setChecksumOffload (useChecksumOffload () && !params.findParameter (PAR_TCP_CHKSUM.syntax, true));
+        tcppacket->setSegmentationOffload (useSegmentationOffload ());
         cEthernetPacket& eth = tcppacket->getFirstEthernetPacket();
-        bool destIsMulticast = isIPv6 ? parseIPv6Params (params, tcppacket) : parseIPv4Params (params, tcppacket);
+        bool destIsMulticast = isIPv6 ? parseIPv6Params (params, tcppacket, false, true) : parseIPv4Params (params, tcppacket, false, true);
         bool userDefinedChecksum = false;
         cParameter* optionalPar;
 
@@ -730,8 +1002,8 @@ cLinkable* cInstructionParser::compileTCP (bool noEthHeader, cParameterList& par
             compileMacHeader  (params, &eth, false, m_ipOptionalDestMAC || destIsMulticast);
             compileVLANTags   (params, &eth);
         }
-        tcppacket->setSourcePort(params.findParameter (PAR_TCP_SPORT.syntax)->asInt16());
-        tcppacket->setDestinationPort(params.findParameter (PAR_TCP_DPORT.syntax)->asInt16());
+        tcppacket->setSourcePort((uint16_t)parseMutableInt (params.findParameter (PAR_TCP_SPORT.syntax), tcppacket, cIPPacket::FIELD_SOURCE_PORT, 0xffff));
+        tcppacket->setDestinationPort((uint16_t)parseMutableInt (params.findParameter (PAR_TCP_DPORT.syntax), tcppacket, cIPPacket::FIELD_DESTINATION_PORT, 0xffff));
 
         tcppacket->setSeqNumber (params.findParameter (PAR_TCP_SEQ.syntax)->asInt32());
         tcppacket->setAckNumber (params.findParameter (PAR_TCP_ACK.syntax)->asInt32());
@@ -764,6 +1036,7 @@ cLinkable* cInstructionParser::compileTCP (bool noEthHeader, cParameterList& par
         }
 
         tcppacket->compile (payload, len, !userDefinedChecksum);
+        locateMutations (tcppacket);
     }
     catch (...)
     {
@@ -1269,9 +1542,9 @@ cLinkable* cInstructionParser::compileLLDP (bool noEthHeader, cParameterList& pa
 void cInstructionParser::throwParseException (const char* msg, const char* val, size_t valLen, const char* details)
 {
     if (details)
-        throw ParseException (m_currentInstruction, msg, details, val, (int)valLen);
+        throw ParseException (m_currentInstruction, m_currentEnd - m_currentInstruction, msg, details, val, (int)valLen);
     else
-        throw ParseException (m_currentInstruction, msg, val, (int)valLen);
+        throw ParseException (m_currentInstruction, m_currentEnd - m_currentInstruction, msg, val, (int)valLen);
 }
 
 
@@ -1288,12 +1561,12 @@ void cInstructionParser::printProtocolList (const char* proto)
             {
                 for (const auto& m: p->mandatory)
                 {
-                    Console::Print ("   %-21s%s\n", m->syntax, m->descr);
+                    Console::Print ("   %-21s%s\n", m->syntax.c_str (), m->descr);
                 }
                 Console::Print (" optional\n");
                 for (const auto& o: p->optional)
                 {
-                    Console::Print ("   %-21s%s\n", o->syntax, o->descr);
+                    Console::Print ("   %-21s%s\n", o->syntax.c_str (), o->descr);
                 }
                 Console::Print ("\n");
                 if (!all)
@@ -1789,6 +2062,20 @@ void cInstructionParser::unitTest ()
         }
     }
 
+    {
+        // all keywords are found, abbreviations and extensions are not
+        for (const auto& proto : all_protos)
+        {
+            const protocolKeyword* k = findProtocol (proto->syntax, std::strlen (proto->syntax));
+            BUG_IF_NOT (k && k->protocol == proto);
+        }
+        BUG_IF_NOT (!findProtocol ("e", 1));
+        BUG_IF_NOT (!findProtocol ("ethx", 4));
+        BUG_IF_NOT (!findProtocol ("icmp-echo-", 10));
+        BUG_IF_NOT (findProtocol ("icmp-echo-reply", 15)->id == ID_ICMP4_ECHOR);
+        BUG_IF_NOT (findProtocol ("zzz", 3) == nullptr && findProtocol ("aaa", 3) == nullptr);
+    }
+
 
     //TODO fuzzing of parseTimestamp and parseProtocollIdentifier
 
@@ -1832,5 +2119,69 @@ void cInstructionParser::unitTest ()
 
         delete result.packets;
     }
+
+    // headers of control blocks
+    {
+        cInstructionParser parser (false);
+        cInstructionParser::cResult result;
+
+        auto parseBlock = [&] (const char* header)
+        {
+            parser.parseBlock (header, std::strlen (header), result);
+        };
+        parseBlock ("\n  ");
+        BUG_IF_NOT (result.control == cResult::BLOCK_BEGIN && result.repeat == 1 && !result.hasTimestamp);
+        parseBlock ("repeat (0)");
+        BUG_IF_NOT (result.repeat == 0);
+        parseBlock ("\n+20: repeat( 1000000 )\n");
+        BUG_IF_NOT (result.repeat == 1000000 && result.hasTimestamp && !result.isAbsolute && result.timestamp == 20);
+
+        const char* invalid[] = {"repeat", "repeat 5", "repeat (5", "repeat (-1)", "repeat (5) x",
+                "repeat (99999999999999999999)", "repeats (5)", "loop (5)", "10 repeat (5)"};
+        for (auto header : invalid)
+        {
+            bool catched = false;
+            try
+            {
+                parseBlock (header);
+            }
+            catch (ParseException& )
+            {
+                catched = true;
+            }
+            BUG_IF_NOT (catched);
+        }
+
+        // only the given length is parsed, the text behind it is ignored
+        const char script[] = "repeat (5) {eth(dmac=11:22:33:44:55:66)  ;eth(x";
+        parser.parseBlock (script, 11, result);
+        BUG_IF_NOT (result.repeat == 5);
+    }
+
+    // instructions are parsed up to the given length, errors refer to a copy of that part
+    {
+        const char script[] = "eth(dmac=11:22:33:44:55:66, payload=01)  ;eth(dmac=1);";
+        const char* second  = script + 42;
+        cInstructionParser parser (false);
+        cInstructionParser::cResult result;
+
+        parser.parse (script, 41, result);
+        BUG_IF_NOT (result.packets);
+        delete result.packets;
+        result.clear ();
+
+        bool catched = false;
+        try
+        {
+            parser.parse (second, 11, result);
+        }
+        catch (ParseException& e)
+        {
+            catched = true;
+            BUG_IF_NOT (!std::strcmp (e.instruction (), "eth(dmac=1)"));
+            BUG_IF_NOT (e.errorBegin () == e.instruction () + 9 && e.errorLen () == 1);
+        }
+        BUG_IF_NOT (catched);
+    }
 }
 #endif /*WITH_UNITTESTS*/
@@ -24,15 +24,17 @@
 #include <cstddef>    // size_t
 #include <cstdio>
 #include <list>
+#include <string>
 
 #include "ethernetpacket.hpp"
 #include "ipaddress.hpp"
 #include "macaddress.hpp"
 #include "linkable.hpp"
+#include "ippacket.hpp"
 
 class cParameterList;
+class cParameterName;
 class cParameter;
-class cIPPacket;
 
 
 class cInstructionParser
@@ -45,23 +47,35 @@ public:
         {
             clear ();
         }
+        // instructions, which start or end a control block, don't create packets
+        enum controlType
+        {
+            NONE, BLOCK_BEGIN, BLOCK_END
+        };
+
         void clear (void)
         {
             timestamp = 0;
             isAbsolute = false;
             hasTimestamp = false;
             packets = nullptr;
+            control = NONE;
+            repeat = 1;
         }
 
         bool hasTimestamp;
         uint64_t timestamp;
         bool isAbsolute;
         cLinkable* packets;
+        controlType control;
+        uint64_t repeat;    // number of executions of a block
     };
 
     cInstructionParser (bool ipOptionalDestMAC);
     ~cInstructionParser ();
-    void parse (const char* instruction, cResult& result, bool ignoreTrailingGarbage = false, bool noEthHeader = false);
+    void parse (const char* instruction, cResult& result);
+    void parse (const char* instruction, size_t len, cResult& result, bool ignoreTrailingGarbage = false, bool noEthHeader = false);
+    void parseBlock (const char* header, size_t len, cResult& result);
     static void printProtocolList (const char* proto = nullptr);
 
 #ifdef WITH_UNITTESTS
@@ -94,17 +108,23 @@ private:
     // helpers
     bool   compileMacHeader (cParameterList& params, cEthernetPacket* packet, bool noDestination, bool destIsOptional = false);
     size_t compileVLANTags  (cParameterList& params, cEthernetPacket* packet);
-    bool   parseIPv4Params  (cParameterList& params, cIPPacket* packet, bool noDestinationIP = false);
-    bool   parseIPv6Params  (cParameterList& params, cIPPacket* packet, bool noDestinationIP = false);
+    bool   parseIPv4Params  (cParameterList& params, cIPPacket* packet, bool noDestinationIP = false, bool allowMutations = false);
+    bool   parseIPv6Params  (cParameterList& params, cIPPacket* packet, bool noDestinationIP = false, bool allowMutations = false);
+    uint32_t parseMutableInt (cParameter* par, cIPPacket* packet, cIPPacket::mutableField field, uint32_t rangeEnd);
+    cIPv4  parseMutableIPv4 (cParameter* par, cIPPacket* packet, cIPPacket::mutableField field);
+    void   locateMutations  (cIPPacket* packet);
+    bool   useChecksumOffload (void) const;
+    bool   useSegmentationOffload (void) const;
     const uint8_t* compileEmbedded  (cParameter* emb, bool noEthHeader, size_t& len);
-    cMacAddress getParameterOrOwnMac (cParameterList& params, const char* par) const;
-    cIPv4  getParameterOrOwnIPv4 (cParameterList& params, const char* par) const;
-    cIPv6  getParameterOrOwnIPv6 (cParameterList& params, const char* par) const;
+    cMacAddress getParameterOrOwnMac (cParameterList& params, const cParameterName& par) const;
+    cIPv4  getParameterOrOwnIPv4 (cParameterList& params, const cParameterName& par) const;
+    cIPv6  getParameterOrOwnIPv6 (cParameterList& params, const cParameterName& par) const;
 
 
     void throwParseException (const char* msg, const char* val, size_t valLen = 0, const char* details = nullptr);
 
     const char* m_currentInstruction;
+    const char* m_currentEnd;
     bool        m_ipOptionalDestMAC;
     unsigned    m_recursionDepth;
 };
@@ -112,13 +132,17 @@ private:
 class ParseException
 {
 public:
-    ParseException (const char* inst, const char* errMsg, const char* errBegin, int errLen = 0)
-    : m_errMsg (errMsg), m_errorBegin (errBegin), m_inst (inst), m_details (), m_errorLen (errLen)
+    // the instruction is copied, as it is usually not terminated by zero and may be gone when the error is reported
+    ParseException (const char* inst, size_t instLen, const char* errMsg, const char* errBegin, int errLen = 0)
+    : ParseException (inst, instLen, errMsg, nullptr, errBegin, errLen)
     {
     }
-    ParseException (const char* inst, const char* errMsg, const char* details, const char* errBegin, int errLen)
-    : m_errMsg (errMsg), m_errorBegin (errBegin), m_inst (inst), m_details (!details ? "" : details), m_errorLen (errLen)
+    ParseException (const char* inst, size_t instLen, const char* errMsg, const char* details, const char* errBegin, int errLen)
+    : m_errMsg (errMsg), m_inst (inst ? std::string (inst, instLen) : std::string ()), m_hasInst (inst != nullptr),
+      m_details (!details ? "" : details), m_errorOffset (-1), m_errorLen (errLen)
     {
+        if (inst && errBegin >= inst && errBegin <= inst + instLen)
+            m_errorOffset = errBegin - inst;
     }
 
     const char* errorMsg () const
@@ -128,12 +152,12 @@ public:
 
     const char* instruction () const
     {
-        return m_inst;
+        return m_hasInst ? m_inst.c_str() : nullptr;
     }
 
     const char* errorBegin () const
     {
-        return m_errorBegin;
+        return m_errorOffset >= 0 ? m_inst.c_str() + m_errorOffset : nullptr;
     }
 
     int errorLen () const
@@ -150,9 +174,10 @@ public:
 
 private:
     const std::string m_errMsg;
-    const char* m_errorBegin;
-    const char* m_inst;
+    const std::string m_inst;
+    const bool m_hasInst;
     const std::string m_details;
+    ptrdiff_t m_errorOffset;
     int m_errorLen;
 };
 
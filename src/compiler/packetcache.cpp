@@ -0,0 +1,516 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ * TCPPUMP <https://github.com/amartin755/tcppump>
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "packetcache.hpp"
+#include "bug.hpp"
+#include "console.hpp"
+
+
+struct cacheHeader
+{
+    char     magic[8];      // "TCPPUMPC"
+    uint32_t byteOrder;     // BYTE_ORDER in byte order of the writer
+    uint32_t version;
+    uint8_t  key[16];
+    uint32_t flags;
+    uint32_t reserved;
+    uint64_t frameCnt;      // number of entries in the frame table, which directly follows the header
+    uint64_t loopCnt;       // number of entries in the loop table, which follows the frame table
+    uint64_t mutationCnt;   // number of entries in the mutation table, which follows the loop table
+    uint64_t valueCnt;      // number of entries in the value table, which follows the mutation table
+    uint64_t dataOffset;    // begin of frame data (page aligned)
+    uint64_t fileSize;
+};
+
+struct cacheFrame
+{
+    uint64_t offset;        // from begin of file; aligned to cFrameArena::FRAME_ALIGNMENT
+    uint64_t length;
+    uint64_t delay;         // nsec
+    uint16_t csumStart;     // see txOffload
+    uint16_t csumOffset;
+    uint8_t  gsoType;
+    uint8_t  reserved;
+    uint16_t gsoSize;
+    uint16_t gsoHdrLen;
+    uint16_t reserved2[3];
+};
+
+struct cacheLoop
+{
+    uint64_t begin;         // index of the first frame of the body
+    uint64_t end;           // index of the frame following the body
+    uint64_t count;
+    uint64_t delay;         // nsec
+};
+
+struct cacheMutation
+{
+    uint64_t frame;         // index of the frame, which contains the field
+    uint32_t offset;
+    uint32_t width;
+    uint32_t ipChecksum;
+    uint32_t l4Checksum;
+    uint32_t generator;
+    uint32_t flags;
+    uint32_t min;
+    uint32_t max;
+    uint64_t valueIdx;      // first entry in the value table
+    uint64_t valueCnt;
+};
+
+static const char     MAGIC[8]        = {'T', 'C', 'P', 'P', 'U', 'M', 'P', 'C'};
+static const uint32_t BYTE_ORDER      = 0x01020304;
+static const uint32_t FLAG_USER_TIME  = 0x00000001;
+static const uint32_t FLAG_UDP        = 0x00000001;    // of cacheMutation
+static const uint32_t FLAG_L4_PARTIAL = 0x00000002;    // of cacheMutation
+static const uint64_t PAGE_SIZE       = 4096;
+
+
+// size of the header and all tables, which precede the frame data
+static uint64_t tablesSize (const cacheHeader& header)
+{
+    return sizeof (cacheHeader) + header.frameCnt * sizeof (cacheFrame) + header.loopCnt * sizeof (cacheLoop)
+            + header.mutationCnt * sizeof (cacheMutation) + header.valueCnt * sizeof (uint32_t);
+}
+
+
+cPacketCache::cPacketCache (const char* file) : name (file), keyFinal (false)
+{
+    uint32_t version = VERSION;
+    addKey (&version, sizeof (version));
+}
+
+
+void cPacketCache::addKey (const void* data, size_t len)
+{
+    BUG_ON (keyFinal);
+    hash.update (data, len);
+}
+
+
+void cPacketCache::addKey (const std::string& s)
+{
+    // include the terminating zero, so "ab","c" and "a","bc" result in different keys
+    addKey (s.c_str (), s.size () + 1);
+}
+
+
+bool cPacketCache::addFileKey (const char* file)
+{
+    cMappedFile f;
+    if (!f.open (file))
+        return false;
+
+    uint64_t size = f.size ();
+    addKey (&size, sizeof (size));
+    addKey (f.data (), f.size ());
+    return true;
+}
+
+
+const uint8_t* cPacketCache::getKey (void)
+{
+    if (!keyFinal)
+    {
+        std::memcpy (key, hash.final (), sizeof (key));
+        keyFinal = true;
+    }
+    return key;
+}
+
+
+bool cPacketCache::load (cPacketData& data)
+{
+    if (!file.open (name.c_str (), true))
+        return false;
+
+    const uint8_t* p = file.data ();
+    const uint64_t size = file.size ();
+    const cacheHeader* header = (const cacheHeader*)p;
+
+    if (size < sizeof (cacheHeader) ||
+        std::memcmp (header->magic, MAGIC, sizeof (MAGIC)) ||
+        header->byteOrder != BYTE_ORDER ||
+        header->version != VERSION)
+    {
+        Console::PrintVerbose ("'%s' is not a cache file of this version\n", name.c_str ());
+        file.close ();
+        return false;
+    }
+    if (std::memcmp (header->key, getKey (), sizeof (key)))
+    {
+        Console::PrintVerbose ("Cache '%s' is outdated\n", name.c_str ());
+        file.close ();
+        return false;
+    }
+    if (header->fileSize != size ||
+        header->frameCnt > (size - sizeof (cacheHeader)) / sizeof (cacheFrame) ||
+        header->loopCnt > (size - sizeof (cacheHeader) - header->frameCnt * sizeof (cacheFrame)) / sizeof (cacheLoop) ||
+        header->mutationCnt > (size - sizeof (cacheHeader) - header->frameCnt * sizeof (cacheFrame)
+                - header->loopCnt * sizeof (cacheLoop)) / sizeof (cacheMutation) ||
+        header->valueCnt > (size - sizeof (cacheHeader) - header->frameCnt * sizeof (cacheFrame)
+                - header->loopCnt * sizeof (cacheLoop) - header->mutationCnt * sizeof (cacheMutation)) / sizeof (uint32_t) ||
+        header->dataOffset < tablesSize (*header) ||
+        header->dataOffset > size)
+    {
+        Console::PrintVerbose ("Cache '%s' is corrupt\n", name.c_str ());
+        file.close ();
+        return false;
+    }
+
+    const cacheFrame* table = (const cacheFrame*)(p + sizeof (cacheHeader));
+    for (uint64_t n = 0; n < header->frameCnt; n++)
+    {
+        if (table[n].offset < header->dataOffset || table[n].offset > size ||
+            table[n].length > size - table[n].offset || table[n].length < sizeof (mac_header_t) ||
+            (table[n].csumStart && (uint64_t)table[n].csumStart + table[n].csumOffset + 2 > table[n].length) ||
+            table[n].gsoType > txOffload::GSO_UDP ||
+            (table[n].gsoType != txOffload::GSO_NONE && (!table[n].csumStart || !table[n].gsoSize || !table[n].gsoHdrLen)))
+        {
+            Console::PrintVerbose ("Cache '%s' is corrupt\n", name.c_str ());
+            file.close ();
+            return false;
+        }
+    }
+
+    for (uint64_t n = 0; n < header->frameCnt; n++)
+    {
+        cTimeval delay;
+        txOffload offload;
+        delay.setNs (table[n].delay);
+        offload.csumStart  = table[n].csumStart;
+        offload.csumOffset = table[n].csumOffset;
+        offload.gsoType    = table[n].gsoType;
+        offload.gsoSize    = table[n].gsoSize;
+        offload.gsoHdrLen  = table[n].gsoHdrLen;
+        data.addFrame (file.data () + table[n].offset, (size_t)table[n].length, delay, offload);
+    }
+
+    const cacheLoop* loopTable = (const cacheLoop*)(table + header->frameCnt);
+    std::vector<cPacketData::loop> loops (header->loopCnt);
+    for (uint64_t n = 0; n < header->loopCnt; n++)
+    {
+        loops[n].begin = (size_t)loopTable[n].begin;
+        loops[n].end   = (size_t)loopTable[n].end;
+        loops[n].count = loopTable[n].count;
+        loops[n].delay.setNs (loopTable[n].delay);
+    }
+    if (!data.setLoops (loops))
+    {
+        Console::PrintVerbose ("Cache '%s' is corrupt\n", name.c_str ());
+        data.reset ();
+        file.close ();
+        return false;
+    }
+
+    const cacheMutation* mutationTable = (const cacheMutation*)(loopTable + header->loopCnt);
+    const uint32_t* valueTable = (const uint32_t*)(mutationTable + header->mutationCnt);
+    std::vector<cPacketData::mutation> mutations (header->mutationCnt);
+    for (uint64_t n = 0; n < header->mutationCnt; n++)
+    {
+        const cacheMutation& m = mutationTable[n];
+        cFieldMutation& f = mutations[n].field;
+        if (m.valueIdx > header->valueCnt || m.valueCnt > header->valueCnt - m.valueIdx)
+        {
+            Console::PrintVerbose ("Cache '%s' is corrupt\n", name.c_str ());
+            data.reset ();
+            file.close ();
+            return false;
+        }
+        mutations[n].frame = (size_t)m.frame;
+        f.offset     = m.offset;
+        f.width      = m.width;
+        f.ipChecksum = m.ipChecksum;
+        f.l4Checksum = m.l4Checksum;
+        f.gen        = (cFieldMutation::generator)m.generator;
+        f.isUdp      = !!(m.flags & FLAG_UDP);
+        f.l4Partial  = !!(m.flags & FLAG_L4_PARTIAL);
+        f.min        = m.min;
+        f.max        = m.max;
+        f.values.assign (valueTable + m.valueIdx, valueTable + m.valueIdx + m.valueCnt);
+    }
+    if (!data.setMutations (mutations))
+    {
+        Console::PrintVerbose ("Cache '%s' is corrupt\n", name.c_str ());
+        data.reset ();
+        file.close ();
+        return false;
+    }
+    data.hasUserTimestamps = !!(header->flags & FLAG_USER_TIME);
+
+    Console::PrintDebug ("Loaded %" PRIu64 " packets from cache '%s'\n", header->frameCnt, name.c_str ());
+    return true;
+}
+
+
+bool cPacketCache::store (const cPacketData& data)
+{
+    cacheHeader header;
+    const cPacketData::frame* frames = data.getFrames ();
+    const size_t frameCnt = data.getFrameCnt ();
+    const cPacketData::loop* loops = data.getLoops ();
+    const size_t loopCnt = data.getLoopCnt ();
+    const cPacketData::mutation* mutations = data.getMutations ();
+    const size_t mutationCnt = data.getMutationCnt ();
+    static const uint8_t padding[PAGE_SIZE] = {0};
+
+    std::memset (&header, 0, sizeof (header));
+    std::memcpy (header.magic, MAGIC, sizeof (MAGIC));
+    std::memcpy (header.key, getKey (), sizeof (key));
+    header.byteOrder  = BYTE_ORDER;
+    header.version    = VERSION;
+    header.flags      = data.hasUserTimestamps ? FLAG_USER_TIME : 0;
+    header.frameCnt   = frameCnt;
+    header.loopCnt    = loopCnt;
+    header.mutationCnt = mutationCnt;
+
+    std::vector<cacheMutation> mutationTable (mutationCnt);
+    std::vector<uint32_t> valueTable;
+    for (size_t n = 0; n < mutationCnt; n++)
+    {
+        const cFieldMutation& f = mutations[n].field;
+        cacheMutation& m = mutationTable[n];
+        m.frame      = mutations[n].frame;
+        m.offset     = (uint32_t)f.offset;
+        m.width      = f.width;
+        m.ipChecksum = (uint32_t)f.ipChecksum;
+        m.l4Checksum = (uint32_t)f.l4Checksum;
+        m.generator  = f.gen;
+        m.flags      = (f.isUdp ? FLAG_UDP : 0) | (f.l4Partial ? FLAG_L4_PARTIAL : 0);
+        m.min        = f.min;
+        m.max        = f.max;
+        m.valueIdx   = valueTable.size ();
+        m.valueCnt   = f.values.size ();
+        valueTable.insert (valueTable.end (), f.values.begin (), f.values.end ());
+    }
+    header.valueCnt   = valueTable.size ();
+    const uint64_t tables = tablesSize (header);
+    header.dataOffset = (tables + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+
+    std::vector<cacheFrame> table (frameCnt);
+    uint64_t offset = header.dataOffset;
+    for (size_t n = 0; n < frameCnt; n++)
+    {
+        table[n].offset = offset;
+        table[n].length = frames[n].length;
+        table[n].delay  = frames[n].delay.ns ();
+        table[n].csumStart  = frames[n].offload.csumStart;
+        table[n].csumOffset = frames[n].offload.csumOffset;
+        table[n].gsoType    = frames[n].offload.gsoType;
+        table[n].gsoSize    = frames[n].offload.gsoSize;
+        table[n].gsoHdrLen  = frames[n].offload.gsoHdrLen;
+        offset += (frames[n].length + cFrameArena::FRAME_ALIGNMENT - 1) & ~(cFrameArena::FRAME_ALIGNMENT - 1);
+    }
+    header.fileSize = offset;
+
+    std::vector<cacheLoop> loopTable (loopCnt);
+    for (size_t n = 0; n < loopCnt; n++)
+    {
+        loopTable[n].begin = loops[n].begin;
+        loopTable[n].end   = loops[n].end;
+        loopTable[n].count = loops[n].count;
+        loopTable[n].delay = loops[n].delay.ns ();
+    }
+
+    // write to a temporary file first, so that a concurrent reader never sees an incomplete cache
+    std::string tmpName (name + ".tmp");
+    FILE* fp = std::fopen (tmpName.c_str (), "wb");
+    if (!fp)
+        return false;
+
+    bool ok = std::fwrite (&header, sizeof (header), 1, fp) == 1;
+    if (ok && frameCnt)
+        ok = std::fwrite (table.data (), sizeof (cacheFrame), frameCnt, fp) == frameCnt;
+    if (ok && loopCnt)
+        ok = std::fwrite (loopTable.data (), sizeof (cacheLoop), loopCnt, fp) == loopCnt;
+    if (ok && mutationCnt)
+        ok = std::fwrite (mutationTable.data (), sizeof (cacheMutation), mutationCnt, fp) == mutationCnt;
+    if (ok && !valueTable.empty ())
+        ok = std::fwrite (valueTable.data (), sizeof (uint32_t), valueTable.size (), fp) == valueTable.size ();
+    if (ok)
+    {
+        size_t pad = (size_t)(header.dataOffset - tables);
+        ok = !pad || std::fwrite (padding, pad, 1, fp) == 1;
+    }
+    for (size_t n = 0; ok && n < frameCnt; n++)
+    {
+        size_t pad = (frames[n].length + cFrameArena::FRAME_ALIGNMENT - 1) / cFrameArena::FRAME_ALIGNMENT
+                * cFrameArena::FRAME_ALIGNMENT - frames[n].length;
+        ok = std::fwrite (frames[n].data, frames[n].length, 1, fp) == 1 &&
+                (!pad || std::fwrite (padding, pad, 1, fp) == 1);
+    }
+    ok = (std::fclose (fp) == 0) && ok;
+
+    if (ok && std::rename (tmpName.c_str (), name.c_str ()))
+    {
+        // rename does not replace existing files on all platforms
+        std::remove (name.c_str ());
+        ok = !std::rename (tmpName.c_str (), name.c_str ());
+    }
+    if (!ok)
+        std::remove (tmpName.c_str ());
+
+    return ok;
+}
+
+
+std::string cPacketCache::defaultName (const char* script)
+{
+    std::string s (script);
+    const std::string ext (".pump");
+
+    if (s.size () > ext.size () && !s.compare (s.size () - ext.size (), ext.size (), ext))
+        return s + "c";
+    return s + ".pumpc";
+}
+
+
+#ifdef WITH_UNITTESTS
+
+void cPacketCache::unitTest ()
+{
+    Console::PrintDebug("-- " __FILE__ " --\n");
+
+    BUG_IF_NOT (defaultName ("a.pump") == "a.pumpc");
+    BUG_IF_NOT (defaultName ("a.txt") == "a.txt.pumpc");
+    BUG_IF_NOT (defaultName (".pump") == ".pump.pumpc");
+
+    const char* cacheFile = "unittest.pumpc";
+    uint8_t frame1[60], frame2[1514];
+    for (size_t n = 0; n < sizeof (frame1); n++)
+        frame1[n] = uint8_t(n);
+    for (size_t n = 0; n < sizeof (frame2); n++)
+        frame2[n] = uint8_t(~n);
+
+    cPacketData out;
+    cTimeval t;
+    out.addFrame (frame1, sizeof (frame1), t);
+    t.setNs (1234567891);
+    out.beginLoop (3, cTimeval (1));
+    txOffload offload;
+    offload.csumStart  = 34;
+    offload.csumOffset = 6;
+    offload.gsoType    = txOffload::GSO_UDP;
+    offload.gsoSize    = 1480;
+    offload.gsoHdrLen  = 34;
+    out.addFrame (frame2, sizeof (frame2), t, offload);
+    BUG_IF_NOT (out.endLoop ());
+    out.hasUserTimestamps = true;
+    BUG_IF_NOT (out.getPacketCnt () == 4);
+    {
+        std::vector<cPacketData::mutation> mutations (2);
+        mutations[0].frame = 0;
+        mutations[0].field.offset = 30;
+        mutations[0].field.width  = 4;
+        mutations[0].field.ipChecksum = 24;
+        mutations[0].field.min = 10;
+        mutations[0].field.max = 20;
+        mutations[1].frame = 1;
+        mutations[1].field.offset = 34;
+        mutations[1].field.width  = 2;
+        mutations[1].field.gen    = cFieldMutation::LIST;
+        mutations[1].field.l4Checksum = 40;
+        mutations[1].field.isUdp  = true;
+        mutations[1].field.l4Partial = true;
+        mutations[1].field.values = {7, 8, 9};
+        BUG_IF_NOT (out.setMutations (mutations));
+        // fields must fit into their frames
+        mutations[0].field.offset = sizeof (frame1) - 1;
+        BUG_IF_NOT (!out.setMutations (mutations));
+        BUG_IF_NOT (out.getMutationCnt () == 2);
+    }
+
+    {
+        cPacketCache cache (cacheFile);
+        cache.addKey (std::string ("key"));
+        BUG_IF_NOT (cache.store (out));
+    }
+    {
+        // same key
+        cPacketCache cache (cacheFile);
+        cache.addKey (std::string ("key"));
+        cPacketData in;
+        BUG_IF_NOT (cache.load (in));
+        BUG_IF_NOT (in.getFrameCnt () == 2);
+        BUG_IF_NOT (in.getPacketCnt () == 4);
+        BUG_IF_NOT (in.getTotalPacketBytes () == sizeof (frame1) + 3 * sizeof (frame2));
+        BUG_IF_NOT (in.getLoopCnt () == 1);
+        const cPacketData::loop& l = in.getLoops ()[0];
+        BUG_IF_NOT (l.begin == 1 && l.end == 2 && l.count == 3 && l.delay.s () == 1);
+        BUG_IF_NOT (in.hasUserTimestamps);
+        const cPacketData::frame* f = in.getFrames ();
+        BUG_IF_NOT (f[0].length == sizeof (frame1) && !std::memcmp (f[0].data, frame1, sizeof (frame1)));
+        BUG_IF_NOT (f[1].length == sizeof (frame2) && !std::memcmp (f[1].data, frame2, sizeof (frame2)));
+        BUG_IF_NOT (f[0].delay.ns () == 0 && f[1].delay.ns () == 1234567891);
+        BUG_IF_NOT (!f[0].offload.needsChecksum () && f[1].offload.csumStart == 34 && f[1].offload.csumOffset == 6);
+        BUG_IF_NOT (!f[0].offload.isSuperFrame () && f[1].offload.gsoType == txOffload::GSO_UDP && f[1].offload.gsoSize == 1480);
+        BUG_IF_NOT (f[1].offload.gsoHdrLen == 34);
+        BUG_IF_NOT (((uintptr_t)f[0].data % cFrameArena::FRAME_ALIGNMENT) == 0);
+        BUG_IF_NOT (((uintptr_t)f[1].data % cFrameArena::FRAME_ALIGNMENT) == 0);
+        BUG_IF_NOT (in.getMutationCnt () == 2);
+        const cPacketData::mutation* m = in.getMutations ();
+        BUG_IF_NOT (m[0].frame == 0 && m[0].field.offset == 30 && m[0].field.width == 4 && m[0].field.ipChecksum == 24);
+        BUG_IF_NOT (m[0].field.gen == cFieldMutation::INCREMENT && m[0].field.min == 10 && m[0].field.max == 20);
+        BUG_IF_NOT (m[1].frame == 1 && m[1].field.gen == cFieldMutation::LIST && m[1].field.isUdp && m[1].field.l4Partial);
+        BUG_IF_NOT (!m[0].field.isUdp && !m[0].field.l4Partial);
+        BUG_IF_NOT (m[1].field.l4Checksum == 40 && m[1].field.values == std::vector<uint32_t> ({7, 8, 9}));
+
+        // frames can be modified in memory
+        f[0].data[0] = 0xff;
+    }
+    {
+        // different key
+        cPacketCache cache (cacheFile);
+        cache.addKey (std::string ("ke"));
+        cache.addKey (std::string ("y"));
+        cPacketData in;
+        BUG_IF_NOT (!cache.load (in));
+        BUG_IF_NOT (in.getFrameCnt () == 0);
+    }
+    {
+        // truncated file
+        cMappedFile f;
+        BUG_IF_NOT (f.open (cacheFile));
+        std::string content ((const char*)f.data (), f.size () - 1);
+        BUG_IF_NOT (content[4096] == 0);   // modification above is not written back
+        f.close ();
+
+        FILE* fp = std::fopen (cacheFile, "wb");
+        BUG_IF_NOT (fp && std::fwrite (content.data (), content.size (), 1, fp) == 1);
+        std::fclose (fp);
+
+        cPacketCache cache (cacheFile);
+        cache.addKey (std::string ("key"));
+        cPacketData in;
+        BUG_IF_NOT (!cache.load (in));
+    }
+    std::remove (cacheFile);
+
+    // not existing file
+    cPacketCache cache (cacheFile);
+    cPacketData in;
+    BUG_IF_NOT (!cache.load (in));
+}
+#endif
@@ -0,0 +1,65 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ * TCPPUMP <https://github.com/amartin755/tcppump>
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PACKETCACHE_HPP_
+#define PACKETCACHE_HPP_
+
+#include <string>
+
+#include "packetdata.hpp"
+#include "mappedfile.hpp"
+#include "md5.hpp"
+
+/*
+ * Cache file (.pumpc) for the compiled and resolved packets of script files.
+ * The cache is only valid, if its key matches. The key is a hash over everything that
+ * affects the compilation (script contents, settings, options).
+ * A loaded cache is mapped into memory, the frames are used directly from the mapping.
+ * Therefore the cache object must exist as long as the packet data is used.
+ */
+class cPacketCache
+{
+public:
+    cPacketCache (const char* file);
+
+    void addKey (const void* data, size_t len);
+    void addKey (const std::string& s);
+    bool addFileKey (const char* file);
+    bool load (cPacketData& data);
+    bool store (const cPacketData& data);
+    const char* getName (void) const {return name.c_str();}
+
+    static std::string defaultName (const char* script);
+
+    static const uint32_t VERSION = 7;
+
+#ifdef WITH_UNITTESTS
+    static void unitTest ();
+#endif
+
+private:
+    const uint8_t* getKey (void);
+
+    std::string name;
+    cMD5 hash;
+    uint8_t key[16];
+    bool keyFinal;
+    cMappedFile file;
+};
+
+#endif /* PACKETCACHE_HPP_ */
@@ -1,7 +1,7 @@
 // SPDX-License-Identifier: GPL-3.0-only
 /*
  * TCPPUMP <https://github.com/amartin755/tcppump>
- * Copyright (C) 2012-2021 Andreas Martin (netnag@mailbox.org)
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -20,30 +20,64 @@
 #ifndef PACKETDATA_HPP_
 #define PACKETDATA_HPP_
 
+#include <vector>
+#include <memory>
+#include <cstring>
+
 #include "ethernetpacket.hpp"
 #include "ippacket.hpp"
+#include "fieldmutation.hpp"
 #include "timeval.hpp"
 #include "linkable.hpp"
+#include "framearena.hpp"
+#include "mappedfile.hpp"
+#include "bug.hpp"
 
+/*
+ * The compiler adds packet objects to a list, which can be altered by the following stages (filter, resolver).
+ * Finally, pack() converts the list into a flat table of frames, which is processed by the output.
+ * The packet objects exist only until then.
+ * Repeated blocks of a script are stored only once. Loop descriptors refer to their frames and are
+ * executed by the output, so the packet and byte counts include all repetitions.
+ * Header fields with values per transmission are patched in place by the output after each transmission
+ * of their frame (see mutate).
+ */
 class cPacketData
 {
 public:
+    struct frame
+    {
+        uint8_t* data;      // stored in arena
+        size_t   length;
+        cTimeval delay;     // relative to the previous frame
+        txOffload offload;  // work left to the kernel or network adapter
+    };
+
+    struct loop
+    {
+        size_t   begin;     // first frame of the body
+        size_t   end;       // frame following the body
+        uint64_t count;     // number of executions of the body
+        cTimeval delay;     // before the first execution, relative to the previous frame
+    };
+
+    struct mutation
+    {
+        size_t frame;       // index of the frame, which contains the field
+        cFieldMutation field;
+    };
+
     cPacketData ()
     {
         hasUserTimestamps = false;
         head = tail = nullptr;
-        elements = ethPackets = ipv4Packets = totalBytes = 0;
+        elements = ethPackets = ipv4Packets = totalBytes = storedFrames = 0;
+        repetitions = 1;
     }
 
     ~cPacketData ()
     {
-        for (cLinkable* p = getFirst(); p != nullptr; )
-        {
-            cLinkable* next = p->getNext();
-            delete p;
-            p = next;
-        }
-
+        clear ();
     }
 
     void add (cLinkable* packet)
@@ -65,6 +99,7 @@ public:
     void addPacket (cLinkable* packet)
     {
         add (packet);
+        shrinkToFit (packet);
         updateStats (packet);
     }
 
@@ -78,6 +113,7 @@ public:
         return tail;
     }
 
+    // number of packets and bytes sent by one pass, including all loop repetitions
     size_t getPacketCnt (void) const
     {
         return ethPackets;
@@ -88,6 +124,216 @@ public:
         return totalBytes;
     }
 
+    /*
+     * Packets added until the matching endLoop() form the body of a loop, which is executed count times.
+     * Loops can be nested; the descriptors are stored in the order of their begin.
+     */
+    void beginLoop (uint64_t count, const cTimeval& delay)
+    {
+        BUG_ON (!count);
+        openLoops.push_back (loops.size ());
+        loops.push_back ({storedFrames, storedFrames, count, delay});
+        repetitions *= count;
+    }
+
+    // returns false, if the loop was discarded, because its body contains no frames
+    bool endLoop (void)
+    {
+        BUG_ON (openLoops.empty ());
+        const size_t idx = openLoops.back ();
+        openLoops.pop_back ();
+        repetitions /= loops[idx].count;
+
+        if (loops[idx].begin == storedFrames)
+        {
+            loops.resize (idx); // including all inner (empty) loops
+            return false;
+        }
+        loops[idx].end = storedFrames;
+        return true;
+    }
+
+    bool inLoop (void) const
+    {
+        return !openLoops.empty ();
+    }
+
+    const loop* getLoops (void) const
+    {
+        return loops.data ();
+    }
+
+    size_t getLoopCnt (void) const
+    {
+        return loops.size ();
+    }
+
+    /*
+     * Sets the loops of the existing frames (e.g. loaded from a cache) and recalculates the packet and byte counts.
+     * Returns false, if the loops don't refer to the frames or are not properly nested.
+     */
+    bool setLoops (const std::vector<loop>& l)
+    {
+        BUG_ON (head || inLoop ());
+        std::vector<size_t> nesting;   // ends of the enclosing loops
+        for (size_t n = 0; n < l.size (); n++)
+        {
+            if (!l[n].count || l[n].begin >= l[n].end || l[n].end > frames.size () || (n && l[n].begin < l[n-1].begin))
+                return false;
+            while (!nesting.empty () && l[n].begin >= nesting.back ())
+                nesting.pop_back ();
+            if (!nesting.empty () && l[n].end > nesting.back ())
+                return false;
+            nesting.push_back (l[n].end);
+        }
+
+        loops = l;
+        size_t idx = 0;
+        uint64_t packets = 0, bytes = 0;
+        countFrames (0, frames.size (), idx, packets, bytes);
+        ethPackets = (size_t)packets;
+        totalBytes = (size_t)bytes;
+        return true;
+    }
+
+    bool hasMutations (void) const
+    {
+        return !mutations.empty ();
+    }
+
+    const mutation* getMutations (void) const
+    {
+        return mutations.data ();
+    }
+
+    size_t getMutationCnt (void) const
+    {
+        return mutations.size ();
+    }
+
+    /*
+     * Sets the mutable fields of the existing frames (e.g. loaded from a cache).
+     * Returns false, if the fields are not sorted by frame or don't fit into their frames.
+     */
+    bool setMutations (const std::vector<mutation>& m)
+    {
+        BUG_ON (head);
+        for (size_t n = 0; n < m.size (); n++)
+        {
+            const cFieldMutation& f = m[n].field;
+            if (m[n].frame >= frames.size () || (n && m[n].frame < m[n-1].frame))
+                return false;
+            const size_t length = frames[m[n].frame].length;
+            if (!f.width || f.width > 4 || ((f.offset + f.width + 1) & ~(size_t)1) > length ||
+                (f.ipChecksum && f.ipChecksum + 2 > length) || (f.l4Checksum && f.l4Checksum + 2 > length))
+                return false;
+            if (f.gen == cFieldMutation::LIST ? f.values.empty () : f.gen > cFieldMutation::LIST || f.min > f.max)
+                return false;
+        }
+        mutations = m;
+        indexMutations ();
+        return true;
+    }
+
+    // changes the fields of frame n to the values of its next transmission
+    void mutate (size_t n) const
+    {
+        for (size_t i = mutationIdx[n]; i < mutationIdx[n + 1]; i++)
+            mutations[i].field.apply (frames[n].data);
+    }
+
+    // discards all packets and frames; the memory of the arena is kept for reuse
+    void reset (void)
+    {
+        clear ();
+        frames.clear ();
+        arena.reset ();
+        files.clear ();
+        loops.clear ();
+        openLoops.clear ();
+        mutations.clear ();
+        mutationIdx.clear ();
+        hasUserTimestamps = false;
+        ethPackets = ipv4Packets = totalBytes = storedFrames = 0;
+        repetitions = 1;
+    }
+
+    const cFrameArena& getArena (void) const
+    {
+        return arena;
+    }
+
+    void pack (void)
+    {
+        frames.reserve (storedFrames);
+
+        for (cLinkable* p = getFirst(); p != nullptr; p = p->getNext())
+        {
+            cEthernetPacket* eth = dynamic_cast<cEthernetPacket*>(p);
+            if (eth)
+            {
+                frames.push_back ({eth->get(), eth->getLength(), eth->getTime(), eth->getOffload()});
+            }
+            else
+            {
+                cIPPacket* ipv4 = dynamic_cast<cIPPacket*>(p);
+                if (ipv4)
+                {
+                    for (auto & m : ipv4->getMutations())
+                        mutations.push_back ({frames.size (), m});
+
+                    // all fragments are sent at once
+                    cTimeval delay = ipv4->getTime();
+                    for (auto & f : ipv4->getAllEthernetPackets())
+                    {
+                        frames.push_back ({f.get(), f.getLength(), delay, f.getOffload()});
+                        delay.clear ();
+                    }
+                }
+            }
+        }
+
+        if (!mutations.empty ())
+            indexMutations ();
+
+        // the frames remain in the arena
+        clear ();
+    }
+
+    // adds a frame without packet object, which is not stored in the arena (e.g. part of a mapped file)
+    void addFrame (uint8_t* data, size_t length, const cTimeval& delay, const txOffload& offload = txOffload ())
+    {
+        frames.push_back ({data, length, delay, offload});
+        storedFrames++;
+        ethPackets += repetitions;
+        totalBytes += length * repetitions;
+    }
+
+    // adds a copy of a frame without packet object
+    void copyFrame (const uint8_t* data, size_t length, const cTimeval& delay)
+    {
+        uint8_t* p = arena.alloc (length);
+        std::memcpy (p, data, length);
+        addFrame (p, length, delay);
+    }
+
+    // keeps a file mapped as long as its frames are used
+    void keep (const std::shared_ptr<cMappedFile>& file)
+    {
+        if (files.empty () || files.back () != file)
+            files.push_back (file);
+    }
+
+    const frame* getFrames (void) const
+    {
+        return frames.data ();
+    }
+
+    size_t getFrameCnt (void) const
+    {
+        return frames.size ();
+    }
+
     // TODO encapsulate
     bool hasUserTimestamps; // is true, if at least one timestamp in timestamp list is user defined (no default value)
 
@@ -95,37 +341,116 @@ public:
 
 private:
 
-    // FIXME  byte and packet counting will not work anymore when we have loops
+    void clear (void)
+    {
+        for (cLinkable* p = getFirst(); p != nullptr; )
+        {
+            cLinkable* next = p->getNext();
+            delete p;
+            p = next;
+        }
+        head = tail = nullptr;
+        elements = 0;
+    }
+
+    // Packets are complete, when they are added. So the (MTU sized) buffers of the compiler can be replaced
+    // by right-sized frames, which are stored contiguously in the arena.
+    void shrinkToFit (cLinkable* packet)
+    {
+        cEthernetPacket* eth = dynamic_cast<cEthernetPacket*>(packet);
+        if (eth)
+        {
+            eth->shrinkToFit (arena);
+        }
+        else
+        {
+            cIPPacket* ipv4 = dynamic_cast<cIPPacket*>(packet);
+            if (ipv4)
+            {
+                for (auto & p : ipv4->getAllEthernetPackets())
+                {
+                    p.shrinkToFit (arena);
+                }
+            }
+        }
+    }
+
+    // packets within loops are counted as often as they are sent
     void updateStats (cLinkable* packet)
     {
         cEthernetPacket* eth = dynamic_cast<cEthernetPacket*>(packet);
         if (eth)
         {
-            ethPackets++;
-            totalBytes += eth->getLength();
+            storedFrames++;
+            ethPackets += repetitions;
+            totalBytes += eth->getLength() * repetitions;
         }
         else
         {
             cIPPacket* ipv4 = dynamic_cast<cIPPacket*>(packet);
             if (ipv4)
             {
-                ipv4Packets++;
+                ipv4Packets += repetitions;
                 const std::list<cEthernetPacket>& fragments = ipv4->getAllEthernetPackets();
 
                 for (auto & p : fragments)
                 {
-                    ethPackets++;
-                    totalBytes += p.getLength();
+                    storedFrames++;
+                    ethPackets += repetitions;
+                    totalBytes += p.getLength() * repetitions;
                 }
             }
         }
     }
+
+    // the mutations of frame n are [mutationIdx[n], mutationIdx[n + 1])
+    void indexMutations (void)
+    {
+        mutationIdx.assign (frames.size () + 1, 0);
+        for (auto & m : mutations)
+            mutationIdx[m.frame + 1]++;
+        for (size_t n = 0; n < frames.size (); n++)
+            mutationIdx[n + 1] += mutationIdx[n];
+    }
+
+    // counts the packets and bytes of the frames [n, end), loops[idx] is the next loop to be considered
+    void countFrames (size_t n, size_t end, size_t& idx, uint64_t& packets, uint64_t& bytes) const
+    {
+        while (n < end)
+        {
+            const size_t next = idx < loops.size () && loops[idx].begin < end ? loops[idx].begin : end;
+            for (; n < next; n++)
+            {
+                packets++;
+                bytes += frames[n].length;
+            }
+            if (n == end)
+                break;
+
+            const loop& l = loops[idx++];
+            uint64_t bodyPackets = 0, bodyBytes = 0;
+            countFrames (l.begin, l.end, idx, bodyPackets, bodyBytes);
+            packets += bodyPackets * l.count;
+            bytes   += bodyBytes * l.count;
+            n = l.end;
+        }
+    }
+
     cLinkable* head;
     cLinkable* tail;
     size_t elements;
     size_t ethPackets;
     size_t ipv4Packets;
     size_t totalBytes;
+    size_t storedFrames;    // frames of the list and the frame table, without repetitions
+    uint64_t repetitions;   // product of the counts of all open loops
+    cFrameArena arena;
+    std::vector<frame> frames;
+    std::vector<loop> loops;
+    std::vector<size_t> openLoops;
+    std::vector<mutation> mutations;    // sorted by frame
+    std::vector<size_t> mutationIdx;
+    std::vector<std::shared_ptr<cMappedFile>> files; // mapped files, which contain frames
 };
 
 #endif /* PACKETDATA_HPP_ */
@@ -1,7 +1,7 @@
 // SPDX-License-Identifier: GPL-3.0-only
 /*
  * TCPPUMP <https://github.com/amartin755/tcppump>
- * Copyright (C) 2012-2025 Andreas Martin (netnag@mailbox.org)
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -22,6 +22,7 @@
 #include <cerrno>
 #include <cstdlib>
 #include <stdexcept>      // std::invalid_argument
+#include <algorithm>
 
 #include "parameterlist.hpp"
 
@@ -41,6 +42,7 @@ cParameter::cParameter (const cParameter& obj)
 {
     parameter = obj.parameter;
     parLen    = obj.parLen;
+    id        = obj.id;
     value     = obj.value;
     valLen    = obj.valLen;
     index     = obj.index;
@@ -68,6 +70,7 @@ void cParameter::clear ()
 {
     parameter = NULL;
     parLen    = 0;
+    id        = 0;
     value     = NULL;
     valLen    = 0;
     index     = -1;
@@ -211,6 +214,90 @@ uint8_t cParameter::asInt8 (uint8_t  rangeBegin, uint8_t rangeEnd) const
 }
 
 
+/*
+ * Parses a value, that changes with each transmission. Ranges [a-b] are counted up, with '*' prefix
+ * the values are random. Lists [a|b|c] are repeated. Items are integers or IPv4 addresses.
+ */
+cFieldMutation cParameter::asMutation (uint32_t rangeEnd, bool isIPv4) const
+{
+    BUG_ON (!isMutable ());
+
+    cFieldMutation m;
+    const char* p   = value + 1;
+    const char* end = value + valLen;
+
+    if (p < end && *p == '*')
+    {
+        m.gen = cFieldMutation::RANDOM;
+        if (++p == end)
+        {
+            m.max = rangeEnd;
+            return m;
+        }
+    }
+    if (end - p < 3 || *p != '[' || *(end - 1) != ']')
+        throw FormatException (exParFormat, value, (int)valLen);
+    p++;
+    end--;
+
+    // all items are separated either by '-' (range) or by '|' (list)
+    char separator = 0;
+    std::vector<uint32_t> items;
+    for (;;)
+    {
+        const char* e = p;
+        while (e < end && *e != '-' && *e != '|')
+            e++;
+        items.push_back (mutationItem (p, e - p, rangeEnd, isIPv4));
+        if (e == end)
+            break;
+        if ((separator && separator != *e) || (*e == '-' && items.size () > 1))
+            throw FormatException (exParFormat, value, (int)valLen);
+        separator = *e;
+        p = e + 1;
+    }
+
+    if (separator == '-')
+    {
+        if (items[0] > items[1])
+            throw FormatException (exParRange, value, (int)valLen);
+        m.min = items[0];
+        m.max = items[1];
+    }
+    else
+    {
+        if (m.gen == cFieldMutation::RANDOM)
+            throw FormatException (exParFormat, value, (int)valLen);
+        m.gen = cFieldMutation::LIST;
+        m.values.swap (items);
+    }
+    return m;
+}
+
+
+uint32_t cParameter::mutationItem (const char* p, size_t len, uint32_t rangeEnd, bool isIPv4) const
+{
+    if (isIPv4)
+    {
+        cIPv4 ip;
+        if (!len || std::memchr (p, '*', len) || !ip.set (p, len))
+            throw FormatException (exParFormat, value, (int)valLen);
+        return ntohl (ip.get ().s_addr);
+    }
+
+    if (!len || !std::isdigit ((unsigned char)*p))
+        throw FormatException (exParFormat, value, (int)valLen);
+    char* numend;
+    errno = 0;
+    unsigned long long v = strtoull (p, &numend, 0);
+    if (numend != p + len)
+        throw FormatException (exParFormat, value, (int)valLen);
+    if (v > rangeEnd || errno == ERANGE)
+        throw FormatException (exParRange, value, (int)valLen);
+    return (uint32_t)v;
+}
+
+
 double cParameter::asDouble (double rangeBegin, double rangeEnd) const
 {
     BUG_ON (rangeEnd < rangeBegin);
@@ -285,7 +372,7 @@ const uint8_t* cParameter::asStream (bool allowEmbPacket, bool &isEmbedded, size
             data = (uint8_t*) new uint32_t[randLen / 4 + 1]; // ensure 32bit alignment
             dataLen = randLen;
 
-            cRandom::rand (data, dataLen);
+            cRandom::fill (data, dataLen);
         }
         else if ( (allowEmbPacket && (*value == '"' || *value == '<')) ||
                  (!allowEmbPacket && *value == '"'))
@@ -358,7 +445,14 @@ void cParameter::throwValueException (void) const
 
 cParameterList::cParameterList (const char* parameters, bool ignoreTrailingGarbage)
 {
-    parseError = parseParameters (parameters, ignoreTrailingGarbage);
+    parseError = parseParameters (parameters, parameters + std::strlen (parameters), ignoreTrailingGarbage);
+}
+
+
+// the list ends after len characters, it doesn't need to be terminated by zero
+cParameterList::cParameterList (const char* parameters, size_t len, bool ignoreTrailingGarbage)
+{
+    parseError = parseParameters (parameters, parameters + len, ignoreTrailingGarbage);
 }
 
 
@@ -386,44 +480,50 @@ void cParameterList::checkForUnusedParameters (void)
 }
 
 
-//FIXME there's a lot of room for improvement; too many string compares
-cParameter* cParameterList::findParameter (const cParameter* startAfter, const char* stopAt, const char* parameter, bool isOptional)
+// the names are only compared if the ids match
+// returns the index of the first parameter 'name' at or behind position 'from', or -1
+int cParameterList::firstIndex (const cParameterName& name, unsigned from) const
+{
+    for (auto it = std::lower_bound (byId.begin (), byId.end (), cIndexEntry {name.id (), from});
+            it != byId.end () && it->id == name.id (); ++it)
+    {
+        if (list[it->index].is (name))
+            return (int)it->index;
+    }
+    return -1;
+}
+
+cParameter* cParameterList::findParameter (const cParameter* startAfter, const cParameterName& stopAt, const cParameterName& parameter, bool isOptional)
 {
     unsigned n = 0;
 
     if (startAfter)
         n = startAfter->index >= 0 ? startAfter->index + 1 : (unsigned)list.size();
-    size_t len = strlen (parameter);
-    size_t len2 = stopAt ? strlen (stopAt) : 0;
 
-    for (; n < list.size (); n++)
+    int found = firstIndex (parameter, n);
+    if (found >= 0)
     {
-        cParameter &par = list.at (n);
-
-        if (stopAt && len2 == par.parLen && !strncmp (stopAt, par.parameter, par.parLen))
+        int stop = stopAt ? firstIndex (stopAt, n) : -1;
+        if (stop < 0 || found < stop)
         {
-            break;
-        }
-        if (len == par.parLen && !strncmp (parameter, par.parameter, par.parLen))
-        {
-            used.at(n) = true;
-            return &par;
+            used[found] = true;
+            return &list[found];
         }
     }
 
     if (!isOptional)
-        throw FormatException (exParUnknown, parameter, (int)len);
+        throw FormatException (exParUnknown, parameter, (int)parameter.length ());
 
     return NULL;
 }
 
-cParameter* cParameterList::findParameter (const char* parameter, bool isOptional)
+cParameter* cParameterList::findParameter (const cParameterName& parameter, bool isOptional)
 {
     return findParameter (nullptr, nullptr, parameter, isOptional);
 }
 
 
-cParameter* cParameterList::findParameter (const cParameter* startAfter, const char* stopAt, const char* parameter, uint32_t optionalValue)
+cParameter* cParameterList::findParameter (const cParameter* startAfter, const cParameterName& stopAt, const cParameterName& parameter, uint32_t optionalValue)
 {
     cParameter* p = findParameter (startAfter, stopAt, parameter, true);
     if (p)
@@ -438,7 +538,7 @@ cParameter* cParameterList::findParameter (const cParameter* startAfter, const c
 }
 
 
-cParameter* cParameterList::findParameter (const cParameter* startAfter, const char* stopAt, const char* parameter, double optionalValue)
+cParameter* cParameterList::findParameter (const cParameter* startAfter, const cParameterName& stopAt, const cParameterName& parameter, double optionalValue)
 {
     cParameter* p = findParameter (startAfter, stopAt, parameter, true);
     if (p)
@@ -453,7 +553,7 @@ cParameter* cParameterList::findParameter (const cParameter* startAfter, const c
 }
 
 
-cParameter* cParameterList::findParameter (const cParameter* startAfter, const char* stopAt, const char* parameter, const cMacAddress& optionalValue)
+cParameter* cParameterList::findParameter (const cParameter* startAfter, const cParameterName& stopAt, const cParameterName& parameter, const cMacAddress& optionalValue)
 {
     cParameter* p = findParameter (startAfter, stopAt, parameter, true);
     if (p)
@@ -468,7 +568,7 @@ cParameter* cParameterList::findParameter (const cParameter* startAfter, const c
 }
 
 
-cParameter* cParameterList::findParameter (const cParameter* startAfter, const char* stopAt, const char* parameter, const cIPv4& optionalValue)
+cParameter* cParameterList::findParameter (const cParameter* startAfter, const cParameterName& stopAt, const cParameterName& parameter, const cIPv4& optionalValue)
 {
     cParameter* p = findParameter (startAfter, stopAt, parameter, true);
     if (p)
@@ -483,31 +583,31 @@ cParameter* cParameterList::findParameter (const cParameter* startAfter, const c
 }
 
 
-cParameter* cParameterList::findParameter (const char* parameter, uint32_t optionalValue)
+cParameter* cParameterList::findParameter (const cParameterName& parameter, uint32_t optionalValue)
 {
     return findParameter (nullptr, nullptr, parameter, optionalValue);
 }
 
 
-cParameter* cParameterList::findParameter (const char* parameter, double optionalValue)
+cParameter* cParameterList::findParameter (const cParameterName& parameter, double optionalValue)
 {
     return findParameter (nullptr, nullptr, parameter, optionalValue);
 }
 
 
-cParameter* cParameterList::findParameter (const char* parameter, const cMacAddress& optionalValue)
+cParameter* cParameterList::findParameter (const cParameterName& parameter, const cMacAddress& optionalValue)
 {
     return findParameter (nullptr, nullptr, parameter, optionalValue);
 }
 
 
-cParameter* cParameterList::findParameter (const char* parameter, const cIPv4& optionalValue)
+cParameter* cParameterList::findParameter (const cParameterName& parameter, const cIPv4& optionalValue)
 {
     return findParameter (nullptr, nullptr, parameter, optionalValue);
 }
 
 // returns nullptr on success. Otherwise a pointer to the syntax error
-const char* cParameterList::parseParameters (const char* parameters, bool ignoreTrailingGarbage)
+const char* cParameterList::parseParameters (const char* parameters, const char* end, bool ignoreTrailingGarbage)
 {
     static const char BOOLVALUE[] = "01";
     const char* p = parameters;
@@ -516,6 +616,7 @@ const char* cParameterList::parseParameters (const char* parameters, bool ignore
     bool isEmbedded = false;
 
     list.clear ();
+    byId.clear ();
     used.clear ();
 
     /*
@@ -531,10 +632,10 @@ const char* cParameterList::parseParameters (const char* parameters, bool ignore
      */
 
     // caller must ensure that parameter list starts with '('
-    BUG_ON (*p != '(');
+    BUG_ON (p >= end || *p != '(');
     p++;
 
-    while (*p != '\0' && *p != ')')
+    while (p < end && *p != ')')
     {
         const char* token;
         v.clear();
@@ -550,6 +651,7 @@ const char* cParameterList::parseParameters (const char* parameters, bool ignore
         p = cParseHelper::nextKeyEnd (p);
         v.parameter = token;
         v.parLen    = p - token;
+        v.id        = cParameterName::hash (token, v.parLen);
         p = cParseHelper::skipWhitespaces (p);
         if (!cParseHelper::isOneOf (*p, ",)")) //--> parameter with value
         {
@@ -570,10 +672,10 @@ const char* cParameterList::parseParameters (const char* parameters, bool ignore
             if (isString || isEmbedded)
             {
                 p++;
-                const char* end = std::strchr (p, isString ? '"' : '>');
-                if (!end)
+                const char* last = (const char*)std::memchr (p, isString ? '"' : '>', end - p);
+                if (!last)
                     return p;
-                p = *end == '\0' ? end : end + 1;
+                p = last + 1;
             }
             else
                 p = cParseHelper::nextValueEnd (p);
@@ -589,6 +691,10 @@ const char* cParameterList::parseParameters (const char* parameters, bool ignore
         v.index = (int)list.size ();
         list.push_back (v);
         used.push_back(false);
+        byId.push_back ({v.id, (unsigned)v.index});
+        // parameter lists are short, thus the new entry is sorted in place
+        for (size_t n = byId.size () - 1; n > 0 && byId[n] < byId[n - 1]; n--)
+            std::swap (byId[n], byId[n - 1]);
 
         p = cParseHelper::skipWhitespaces (p);
         if (!cParseHelper::isOneOf (*p, ",)"))
@@ -598,14 +704,14 @@ const char* cParameterList::parseParameters (const char* parameters, bool ignore
             p++;
     }
 
-    if (*p != ')')
+    if (p >= end || *p != ')')
         return p;
 
     if (!ignoreTrailingGarbage)
     {
         p++;
         p = cParseHelper::skipWhitespaces (p);
-        if (*p != '\0')
+        if (p < end)
             return p;
     }
     return nullptr; // everything ok
@@ -633,6 +739,23 @@ void cParameterList::unitTest ()
         BUG_IF_NOT (0);
     }
 
+    // repeated parameters, e.g. VLAN tags, are searched behind a parameter and up to the next group
+    {
+        cParameterList obj ("(vid=1, prio=3, vid=2, vid=3, prio=5, dei=1)");
+        BUG_IF_NOT (obj.isValid ());
+        const cParameter* vid = obj.findParameter ("vid");
+        BUG_IF_NOT (vid->asInt32 () == 1);
+        BUG_IF_NOT (obj.findParameter (vid, "vid", "prio", (uint32_t)0)->asInt32 () == 3);
+        vid = obj.findParameter (vid, nullptr, "vid");
+        BUG_IF_NOT (vid->asInt32 () == 2);
+        BUG_IF_NOT (obj.findParameter (vid, "vid", "prio", (uint32_t)0)->asInt32 () == 0);
+        vid = obj.findParameter (vid, nullptr, "vid");
+        BUG_IF_NOT (vid->asInt32 () == 3);
+        BUG_IF_NOT (obj.findParameter (vid, "vid", "prio", (uint32_t)0)->asInt32 () == 5);
+        BUG_IF_NOT (obj.findParameter (vid, "vid", "dei", (uint32_t)0)->asInt32 () == 1);
+        BUG_IF_NOT (!obj.findParameter (vid, nullptr, "vid", true));
+    }
+
     {
         cParameterList obj ("(first=100, second = 200, third   =300, fourth=x12)");
         BUG_IF_NOT (obj.isValid ());
@@ -738,6 +861,18 @@ void cParameterList::unitTest ()
         BUG_IF_NOT (0);
     }
 
+    {
+        // ids of names are constant expressions and equal to the ids of parsed names
+        static constexpr cParameterName name ("second");
+        static_assert (name.id () == cParameterName::hash ("second", 6), "");
+        static_assert (name.length () == 6, "");
+        cParameterList obj ("(first=100, second=200, second=300, third=400)");
+        BUG_IF_NOT (obj.findParameter(name)->asInt32() == 200);
+        BUG_IF_NOT (obj.findParameter(obj.findParameter(name), nullptr, name)->asInt32() == 300);
+        BUG_IF_NOT (!obj.findParameter(obj.findParameter(name), "third", "first", true));
+        BUG_IF_NOT (!obj.findParameter("secon", true));
+        BUG_IF_NOT (!obj.findParameter("seconds", true));
+    }
     {
         cParameterList obj ("(first=100.firstsecond = 200, third   =300)");
         BUG_IF_NOT (!obj.isValid ());
@@ -1334,6 +1469,48 @@ void cParameterList::unitTest ()
         BUG ("unexpected exception");
     }
 
+    // values per transmission
+    {
+        cParameterList obj ("(a=+[1-5], b=+*[0x10-0x20], c=+[3|1|2], d=+[10.0.0.255-10.0.1.1], e=+*, f=+[7], "
+                "g=+[5-1], h=+[1-2-3], i=+[1|2-3], j=+*[1|2], k=+[1-256], l=+[], m=+1)");
+        BUG_IF_NOT (obj.isValid ());
+        BUG_IF_NOT (obj.findParameter ("a")->isMutable ());
+
+        cFieldMutation m = obj.findParameter ("a")->asMutation (0xff, false);
+        BUG_IF_NOT (m.gen == cFieldMutation::INCREMENT && m.min == 1 && m.max == 5);
+        m = obj.findParameter ("b")->asMutation (0xff, false);
+        BUG_IF_NOT (m.gen == cFieldMutation::RANDOM && m.min == 0x10 && m.max == 0x20);
+        m = obj.findParameter ("c")->asMutation (0xff, false);
+        BUG_IF_NOT (m.gen == cFieldMutation::LIST && m.values == std::vector<uint32_t> ({3, 1, 2}));
+        BUG_IF_NOT (m.initial () == 3 && m.values == std::vector<uint32_t> ({1, 2, 3}));
+        m = obj.findParameter ("d")->asMutation (0xffffffff, true);
+        BUG_IF_NOT (m.gen == cFieldMutation::INCREMENT && m.min == 0x0a0000ff && m.max == 0x0a000101);
+        m = obj.findParameter ("e")->asMutation (0xffff, false);
+        BUG_IF_NOT (m.gen == cFieldMutation::RANDOM && m.min == 0 && m.max == 0xffff);
+        m = obj.findParameter ("f")->asMutation (0xff, false);
+        BUG_IF_NOT (m.gen == cFieldMutation::LIST && m.values.size () == 1);
+
+        const struct {const char* par; int error;} invalid[] = {
+            {"g", exParRange}, {"h", exParFormat}, {"i", exParFormat}, {"j", exParFormat},
+            {"k", exParRange}, {"l", exParFormat}, {"m", exParFormat}, {"d", exParFormat}};
+        for (const auto& t : invalid)
+        {
+            catched = false;
+            try
+            {
+                const cParameter* par = obj.findParameter (t.par);
+                BUG_IF_NOT (par->isMutable ());
+                par->asMutation (0xff, false);
+            }
+            catch (FormatException& e)
+            {
+                catched = true;
+                BUG_IF_NOT (e.what () == t.error);
+            }
+            BUG_IF_NOT (catched);
+        }
+    }
+
     // TODO fuzzing
 }
 #endif
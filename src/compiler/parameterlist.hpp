@@ -1,7 +1,7 @@
 // SPDX-License-Identifier: GPL-3.0-only
 /*
  * TCPPUMP <https://github.com/amartin755/tcppump>
- * Copyright (C) 2012-2021 Andreas Martin (netnag@mailbox.org)
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -22,13 +22,67 @@
 
 #include <vector>
 #include <cfloat>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
 
 #include "ipaddress.hpp"
 #include "macaddress.hpp"
 #include "uuid.hpp"
+#include "fieldmutation.hpp"
 #include "formatexception.hpp"
 #include "bug.hpp"
 
+
+/*
+ * Name of a parameter. Its id is a hash (FNV-1a) of the name, which is calculated at compile time
+ * for the names of the syntax tables. Lookups compare ids and only compare the names if the ids match.
+ */
+class cParameterName
+{
+public:
+    constexpr cParameterName (const char* name)
+    : m_name (name), m_len (length (name)), m_id (hash (name, length (name)))
+    {
+    }
+    constexpr cParameterName (std::nullptr_t)
+    : m_name (nullptr), m_len (0), m_id (0)
+    {
+    }
+    constexpr operator const char* () const
+    {
+        return m_name;
+    }
+    constexpr const char* c_str () const
+    {
+        return m_name;
+    }
+    constexpr size_t length () const
+    {
+        return m_len;
+    }
+    constexpr uint32_t id () const
+    {
+        return m_id;
+    }
+
+    static constexpr uint32_t hash (const char* s, size_t len, uint32_t h = 2166136261u)
+    {
+        return len ? hash (s + 1, len - 1, (h ^ (uint8_t)*s) * 16777619u) : h;
+    }
+
+private:
+    static constexpr size_t length (const char* s)
+    {
+        return *s ? 1 + length (s + 1) : 0;
+    }
+
+    const char* m_name;
+    size_t      m_len;
+    uint32_t    m_id;
+};
+
+
 class cParameter
 {
 public:
@@ -61,21 +115,35 @@ public:
         }
     }
 
+    // values with prefix '+' change with each transmission (e.g. +[1-10], +*[1-10], +[1|5|7])
+    bool isMutable () const
+    {
+        return valLen && *value == '+';
+    }
+    cFieldMutation asMutation (uint32_t rangeEnd, bool isIPv4) const;
+
     std::pair<const char*, size_t> name () const
     {
         return std::pair<const char*, size_t> (parameter, parLen);
     }
 
+    bool is (const cParameterName& name) const
+    {
+        return id == name.id () && parLen == name.length () && !std::memcmp (parameter, name.c_str (), parLen);
+    }
+
     void throwValueException (void) const;
 
 private:
     void clear ();
     int isRandom (bool allowRange) const;
     int isRandomInteger (uint64_t& min, uint64_t& max) const;
+    uint32_t mutationItem (const char* p, size_t len, uint32_t rangeEnd, bool isIPv4) const;
     const uint8_t* asStream (bool allowEmbPacket, bool &isEmbedded, size_t& len, size_t maxLen = SIZE_MAX);
 
     const char* parameter;
     size_t      parLen;
+    uint32_t    id;
     const char* value;
     size_t      valLen;
     int         index;
@@ -129,19 +197,20 @@ class cParameterList
 {
 public:
     cParameterList (const char*, bool ignoreTrailingGarbage = false);
+    cParameterList (const char*, size_t len, bool ignoreTrailingGarbage = false);
     bool isValid (void);
     const char* getParseError (void);
     void checkForUnusedParameters (void);
-    cParameter* findParameter (const cParameter* startAfter, const char* stopAt, const char* parameter, bool isOptional = false);
-    cParameter* findParameter (const char* parameter, bool isOptional = false);
-    cParameter* findParameter (const char* parameter, uint32_t optionalValue);
-    cParameter* findParameter (const char* parameter, double optionalValue);
-    cParameter* findParameter (const char* parameter, const cMacAddress& optionalValue);
-    cParameter* findParameter (const char* parameter, const cIPv4& optionalValue);
-    cParameter* findParameter (const cParameter* startAfter, const char* stopAt, const char* parameter, uint32_t optionalValue);
-    cParameter* findParameter (const cParameter* startAfter, const char* stopAt, const char* parameter, double optionalValue);
-    cParameter* findParameter (const cParameter* startAfter, const char* stopAt, const char* parameter, const cMacAddress& optionalValue);
-    cParameter* findParameter (const cParameter* startAfter, const char* stopAt, const char* parameter, const cIPv4& optionalValue);
+    cParameter* findParameter (const cParameter* startAfter, const cParameterName& stopAt, const cParameterName& parameter, bool isOptional = false);
+    cParameter* findParameter (const cParameterName& parameter, bool isOptional = false);
+    cParameter* findParameter (const cParameterName& parameter, uint32_t optionalValue);
+    cParameter* findParameter (const cParameterName& parameter, double optionalValue);
+    cParameter* findParameter (const cParameterName& parameter, const cMacAddress& optionalValue);
+    cParameter* findParameter (const cParameterName& parameter, const cIPv4& optionalValue);
+    cParameter* findParameter (const cParameter* startAfter, const cParameterName& stopAt, const cParameterName& parameter, uint32_t optionalValue);
+    cParameter* findParameter (const cParameter* startAfter, const cParameterName& stopAt, const cParameterName& parameter, double optionalValue);
+    cParameter* findParameter (const cParameter* startAfter, const cParameterName& stopAt, const cParameterName& parameter, const cMacAddress& optionalValue);
+    cParameter* findParameter (const cParameter* startAfter, const cParameterName& stopAt, const cParameterName& parameter, const cIPv4& optionalValue);
 
     typedef std::vector<cParameter>::iterator iterator;
     typedef std::vector<cParameter>::const_iterator const_iterator;
@@ -160,8 +229,22 @@ public:
 #endif
 
 private:
-    const char* parseParameters (const char*, bool);
+    const char* parseParameters (const char*, const char* end, bool);
+    int firstIndex (const cParameterName& name, unsigned from) const;
+
+    // position of a parameter in list
+    struct cIndexEntry
+    {
+        uint32_t id;
+        unsigned index;
+        bool operator< (const cIndexEntry& e) const
+        {
+            return id < e.id || (id == e.id && index < e.index);
+        }
+    };
+
     std::vector<cParameter> list;
+    std::vector<cIndexEntry> byId;  // sorted by id and position, built by parseParameters
     std::vector<bool> used;
     const char* parseError;
     cDefaultParameter defaultParameter;
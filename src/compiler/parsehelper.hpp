@@ -1,7 +1,7 @@
 // SPDX-License-Identifier: GPL-3.0-only
 /*
  * TCPPUMP <https://github.com/amartin755/tcppump>
- * Copyright (C) 2012-2021 Andreas Martin (netnag@mailbox.org)
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -44,13 +44,13 @@ public:
     }
     static const char* nextValueStart (const char* p)
     {
-        // Values always start with an alphabetic character, a number, ", < or *
-        return nextTokenStart (p, true, true, "\"*<");
+        // Values always start with an alphabetic character, a number, ", <, * or +
+        return nextTokenStart (p, true, true, "\"*<+");
     }
     static const char* nextValueEnd (const char* p)
     {
-        // alphabetic characters, numbers, '.' and ':' are allowed
-        return nextTokenEnd (p, true, true, ".:*[-]");
+        // alphabetic characters, numbers, '.', ':' and the characters of ranges and lists are allowed
+        return nextTokenEnd (p, true, true, ".:*+[-|]");
     }
     static const char* nextTokenStart (const char* p, bool isAlpha, bool isDigit, const char* accept);
     static const char* nextTokenEnd (const char* p, bool isAlpha, bool isDigit, const char* accept);
@@ -1,7 +1,7 @@
 // SPDX-License-Identifier: GPL-3.0-only
 /*
  * TCPPUMP <https://github.com/amartin755/tcppump>
- * Copyright (C) 2012-2025 Andreas Martin (netnag@mailbox.org)
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -19,10 +19,11 @@
 
 #include <cstdarg>
 #include <cstdio>
+#include <cstring>
 
 #include "asciibackend.hpp"
 #include "fileioexception.hpp"
-#include "ethernetpacket.hpp"
+#include "timeval.hpp"
 
 
 cAsciiBackend::cAsciiBackend (const char* file, bool printPacketNumber,
@@ -52,10 +53,10 @@ cAsciiBackend::~cAsciiBackend ()
     }
 }
 
-void cAsciiBackend::write (const cTimeval& sendTime, cEthernetPacket& p)
+void cAsciiBackend::write (const cTimeval& sendTime, const uint8_t* frame, size_t length)
 {
     struct timeval t = sendTime.timeval();
-    const uint8_t* data = p.get();
+    const uint8_t* data = frame;
 
     if (m_printPacketNumber)
     {
@@ -70,12 +71,12 @@ void cAsciiBackend::write (const cTimeval& sendTime, cEthernetPacket& p)
     if (m_hexdump)
     {
         write ("\n");
-        dump (data, p.getLength());
+        dump (data, length);
         m_writtenPackets++;
         return;
     }
 
-    for (size_t n = 0; n < p.getLength(); n++)
+    for (size_t n = 0; n < length; n++)
     {
         write ("%02x%s", unsigned(*data++), m_byteSeparator.c_str());
     }
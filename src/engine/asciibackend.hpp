@@ -1,7 +1,7 @@
 // SPDX-License-Identifier: GPL-3.0-only
 /*
  * TCPPUMP <https://github.com/amartin755/tcppump>
- * Copyright (C) 2012-2025 Andreas Martin (netnag@mailbox.org)
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -35,7 +35,7 @@ public:
     cAsciiBackend& operator= (const cAsciiBackend&&) = delete;
     
     cAsciiBackend (const char* file, bool printPacketNumber, bool printPacketTime, bool hexdump, const char* colSeparator, const char* byteSeparator);
-    void write (const cTimeval& sendTime, cEthernetPacket& p);
+    void write (const cTimeval& sendTime, const uint8_t* frame, size_t length);
     void statistic (uint64_t& sentPackets, uint64_t& sentBytes, double& duration) const;
     ~cAsciiBackend ();
 
@@ -1,7 +1,7 @@
 // SPDX-License-Identifier: GPL-3.0-only
 /*
  * TCPPUMP <https://github.com/amartin755/tcppump>
- * Copyright (C) 2012-2021 Andreas Martin (netnag@mailbox.org)
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -17,6 +17,8 @@
  */
 
 
+#include <cstring>
+
 #include "filter.hpp"
 #include "console.hpp"
 
@@ -51,6 +53,15 @@ cPacketData& cFilter::operator<< (cPacketData& input)
 
             // TODO add more filters
         }
+
+        // frames without packet object (e.g. from PCAP files)
+        for (size_t n = 0; n < input.getFrameCnt(); n++)
+        {
+            if (forcedDMAC)
+            {
+                std::memcpy (input.getFrames()[n].data, forcedDMAC->get(), forcedDMAC->size());
+            }
+        }
     }
     return input;
 }
@@ -1,7 +1,7 @@
 // SPDX-License-Identifier: GPL-3.0-only
 /*
  * TCPPUMP <https://github.com/amartin755/tcppump>
- * Copyright (C) 2012-2025 Andreas Martin (netnag@mailbox.org)
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -29,9 +29,16 @@
 #include "pcapbackend.hpp"
 #include "asciibackend.hpp"
 
+#if HAVE_MSVC
+#include <xmmintrin.h>
+#define prefetch(p) _mm_prefetch ((const char*)(p), _MM_HINT_T0)
+#else
+#define prefetch(p) __builtin_prefetch (p)
+#endif
+
 
 cOutput::cOutput (const cPreprocessor &p)
-: m_outfile (nullptr), m_preproc (p), m_netif (nullptr), m_realtimeMode (false), m_repeat (1)
+: m_outfile (nullptr), m_preproc (p), m_netif (nullptr), m_rateLimit (nullptr), m_realtimeMode (false), m_repeat (1)
 {
 }
 
@@ -60,6 +67,14 @@ void cOutput::prepare (const char* file, const char* format, int repeat)
     {
         m_outfile = new cPcapBackend (file);
     }
+    else if (fileFormat == "pcapns")
+    {
+        m_outfile = new cPcapBackend (file, cPcapFileIO::PCAP_NS);
+    }
+    else if (fileFormat == "pcapng")
+    {
+        m_outfile = new cPcapBackend (file, cPcapFileIO::PCAPNG);
+    }
     else if (fileFormat == "text")
     {
         m_outfile = new cAsciiBackend (file, true, true, false, "\t", " ");
@@ -80,64 +95,135 @@ void cOutput::prepare (const char* file, const char* format, int repeat)
 
 cPacketData& cOutput::operator<< (cPacketData& input)
 {
-    cTimeval sendTime;
     bool endless = !m_repeat;
-    bool queuedOutput = m_netif;
 
+    begin (input.getPacketCnt() * m_repeat, input.getTotalPacketBytes() * m_repeat);
+
+    // without preprocessing and values per transmission, all loops send exactly the same frames
+    if (m_netif && m_repeat != 1 && !m_preproc.modifiesPackets() && !input.hasMutations())
+        m_netif->prepareRepetition (input.getPacketCnt());
 
-    if (queuedOutput)
+    while (!cSignal::sigintSignalled() && (endless || m_repeat--))
     {
-        m_netif->prepareSendQueue(input.getPacketCnt() * m_repeat,
-                input.getTotalPacketBytes() * m_repeat,
-                m_realtimeMode);
+        send (input);
     }
 
-    while (!cSignal::sigintSignalled() && (endless || m_repeat--))
+    end ();
+
+    return input;
+}
+
+cPacketStream& cOutput::operator<< (cPacketStream& input)
+{
+    cPacketData* window;
+
+    // the number of packets is unknown; loops are done by the stream
+    begin (0, 0);
+
+    while (!cSignal::sigintSignalled() && (window = input.next ()) != nullptr)
+    {
+        send (*window);
+        input.release (window);
+    }
+
+    end ();
+    input.stop ();
+
+    return input;
+}
+
+void cOutput::begin (size_t packetCnt, size_t totalBytes)
+{
+    m_sendTime.clear ();
+
+    if (m_rateLimit)
+        m_rateLimit->reset ();
+
+    if (m_netif)
     {
-        for (cLinkable* p = input.getFirst(); !cSignal::sigintSignalled() && (p != nullptr); p = p->getNext())
+        // rate limited packets are sent time-triggered
+        m_netif->prepareSendQueue(packetCnt, totalBytes, m_realtimeMode || m_rateLimit);
+    }
+}
+
+void cOutput::send (const cPacketData& input)
+{
+    size_t loop = 0;
+    send (input, 0, input.getFrameCnt(), loop);
+}
+
+/*
+ * Sends the frames [n, end). Loops, starting within this range, are executed; loop is the index
+ * of the next loop and is advanced behind all executed ones.
+ */
+void cOutput::send (const cPacketData& input, size_t n, size_t end, size_t& loop)
+{
+    const cPacketData::frame* frames = input.getFrames();
+    const cPacketData::loop* loops = input.getLoops();
+    const size_t loopCnt = input.getLoopCnt();
+    const bool mutate = input.hasMutations();
+
+    while (n < end && !cSignal::sigintSignalled())
+    {
+        const size_t next = loop < loopCnt && loops[loop].begin < end ? loops[loop].begin : end;
+
+        for (; n < next && !cSignal::sigintSignalled(); n++)
         {
-            sendTime.add (p->getTime());
-            cEthernetPacket* eth;
-            cIPPacket* ipv4;
+            // frames are stored back to back; fetch the header of the next but one frame in advance
+            if (n + 2 < next)
+                prefetch (frames[n + 2].data);
 
-            if ((eth = dynamic_cast<cEthernetPacket*>(p)) != nullptr)
-            {
-                processPacket (sendTime, *eth);
-            }
-            else if ((ipv4 = dynamic_cast<cIPPacket*>(p)) != nullptr)
-            {
-                std::list<cEthernetPacket>& packets = ipv4->getAllEthernetPackets();
+            m_sendTime.add (frames[n].delay);
+            processPacket (m_sendTime, frames[n]);
+
+            // the frame was copied by the send path, so it can be prepared for its next transmission
+            if (mutate)
+                input.mutate (n);
+        }
+        if (n < next)
+            break;  // interrupted
 
-                for (auto & currPacket : packets)
-                {
-                    processPacket (sendTime, currPacket);
-                }
+        if (n < end)
+        {
+            const cPacketData::loop& l = loops[loop++];
+            const size_t inner = loop;
+
+            m_sendTime.add (l.delay);
+            for (uint64_t i = 0; i < l.count && !cSignal::sigintSignalled(); i++)
+            {
+                loop = inner;
+                send (input, l.begin, l.end, loop);
             }
+            n = l.end;
         }
     }
+}
 
-    if (queuedOutput)
+void cOutput::end (void)
+{
+    if (m_netif)
     {
         m_netif->flushSendQueue();
     }
-
-    return input;
 }
 
-void cOutput::processPacket (const cTimeval& sendTime, cEthernetPacket& p)
+void cOutput::processPacket (const cTimeval& scheduledTime, const cPacketData::frame& f)
 {
-    m_preproc.process (p);    // execute packet preprocessor hooks
+    m_preproc.process (f.data);    // execute packet preprocessor hooks
+
+    // the rate limit overrides the packet timestamps
+    const cTimeval sendTime = m_rateLimit ? m_rateLimit->next (f.length, f.offload) : scheduledTime;
 
     if (m_netif)
     {
-        if(!m_netif->sendPacket (p.get(), p.getLength(), sendTime))
+        if(!m_netif->sendPacket (f.data, f.length, sendTime, f.offload))
         {
             throw std::runtime_error("Could not send packet.");
         }
     }
     else
     {
-        m_outfile->write (sendTime, p);
+        m_outfile->write (sendTime, f.data, f.length);
     }
 }
 
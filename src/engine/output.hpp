@@ -1,7 +1,7 @@
 // SPDX-License-Identifier: GPL-3.0-only
 /*
  * TCPPUMP <https://github.com/amartin755/tcppump>
- * Copyright (C) 2012-2025 Andreas Martin (netnag@mailbox.org)
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -25,6 +25,8 @@
 #include "packetdata.hpp"
 #include "netinterface.hpp"
 #include "preprocessor.hpp"
+#include "ratelimiter.hpp"
+#include "packetstream.hpp"
 
 
 class cFileBackend;
@@ -36,16 +38,24 @@ public:
     ~cOutput ();
     void prepare (cNetInterface &netif, bool realtime, int repeat);
     void prepare (const char* outfile, const char* format, int repeat);
+    void setRateLimit (cRateLimiter* limiter) {m_rateLimit = limiter;}
     cPacketData& operator<< (cPacketData& input);
+    cPacketStream& operator<< (cPacketStream& input);
     void statistic (uint64_t& sentPackets, uint64_t& sentBytes, double& duration) const;
 
 
 private:
     cFileBackend* m_outfile;
-    inline void processPacket (const cTimeval& sendTime, cEthernetPacket& p);
+    void begin (size_t packetCnt, size_t totalBytes);
+    void send (const cPacketData& input);
+    void send (const cPacketData& input, size_t n, size_t end, size_t& loop);
+    void end (void);
+    inline void processPacket (const cTimeval& sendTime, const cPacketData::frame& f);
     const cPreprocessor &m_preproc;
     cNetInterface *m_netif;
+    cRateLimiter *m_rateLimit;
     bool m_realtimeMode;
+    cTimeval m_sendTime;
     int m_repeat;
 };
 
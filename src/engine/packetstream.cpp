@@ -0,0 +1,166 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ * TCPPUMP <https://github.com/amartin755/tcppump>
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "packetstream.hpp"
+#include "bug.hpp"
+#include "console.hpp"
+
+
+cPacketStream::cPacketStream (cCompiler& c, cFilter& f, cResolver* r, cScheduler& s)
+: compiler (c), filter (f), resolver (r), scheduler (s),
+  produced (0), consumed (0), finished (false), stopping (false)
+{
+}
+
+
+cPacketStream::~cPacketStream ()
+{
+    stop ();
+}
+
+
+void cPacketStream::start (const std::vector<std::string>& input, int repeat)
+{
+    BUG_ON (producer.joinable ());
+
+    compiler.open (input);
+    produced = consumed = 0;
+    finished = stopping = false;
+    error    = nullptr;
+
+    producer = std::thread (&cPacketStream::run, this, repeat);
+}
+
+
+void cPacketStream::stop (void)
+{
+    if (producer.joinable ())
+    {
+        {
+            std::lock_guard<std::mutex> guard (lock);
+            stopping = true;
+        }
+        cond.notify_all ();
+        producer.join ();
+    }
+}
+
+
+void cPacketStream::run (int repeat)
+{
+    bool endless = !repeat;
+
+    try
+    {
+        while (endless || repeat--)
+        {
+            size_t total = 0;
+            size_t cnt;
+
+            do
+            {
+                cPacketData* w;
+                {
+                    std::unique_lock<std::mutex> guard (lock);
+                    cond.wait (guard, [this] {return stopping || produced - consumed < WINDOWS;});
+                    if (stopping)
+                        return;
+                    w = &windows[produced % WINDOWS];
+                }
+
+                w->reset ();
+                cnt = compiler.produce (*w, WINDOW_PACKETS);
+                if (cnt)
+                {
+                    filter << *w;
+                    if (resolver)
+                        *resolver << *w;
+                    scheduler << *w;
+
+                    {
+                        std::lock_guard<std::mutex> guard (lock);
+                        produced++;
+                    }
+                    cond.notify_all ();
+                    total += cnt;
+                }
+            }
+            while (cnt >= WINDOW_PACKETS);
+
+            // an empty input would loop forever
+            if (!total)
+                break;
+
+            compiler.rewind ();
+        }
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> guard (lock);
+        error = std::current_exception ();
+    }
+
+    {
+        std::lock_guard<std::mutex> guard (lock);
+        finished = true;
+    }
+    cond.notify_all ();
+}
+
+
+// returns true, if the first window has user defined timestamps; waits until it is compiled
+bool cPacketStream::hasUserTimestamps (void)
+{
+    std::unique_lock<std::mutex> guard (lock);
+    cond.wait (guard, [this] {return finished || produced > consumed;});
+
+    return produced > consumed && windows[consumed % WINDOWS].hasUserTimestamps;
+}
+
+
+/*
+ * Returns the next compiled window, which must be handed back by release after it was sent.
+ * Returns nullptr at the end of the stream. Exceptions of the producer are rethrown here.
+ */
+cPacketData* cPacketStream::next (void)
+{
+    std::unique_lock<std::mutex> guard (lock);
+    cond.wait (guard, [this] {return finished || produced > consumed;});
+
+    if (produced > consumed)
+        return &windows[consumed % WINDOWS];
+
+    if (error)
+    {
+        std::exception_ptr e = error;
+        error = nullptr;
+        std::rethrow_exception (e);
+    }
+    return nullptr;
+}
+
+
+void cPacketStream::release (cPacketData* window)
+{
+    {
+        std::lock_guard<std::mutex> guard (lock);
+        BUG_ON (window != &windows[consumed % WINDOWS]);
+        consumed++;
+    }
+    cond.notify_all ();
+}
@@ -0,0 +1,78 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ * TCPPUMP <https://github.com/amartin755/tcppump>
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PACKETSTREAM_HPP_
+#define PACKETSTREAM_HPP_
+
+#include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+
+#include "packetdata.hpp"
+#include "compiler.hpp"
+#include "filter.hpp"
+#include "resolver.hpp"
+#include "scheduler.hpp"
+
+/*
+ * Streaming variant of the packet-flow-chain. A producer thread compiles the input piecewise into
+ * a fixed number of windows, each one passing compiler -> filter -> resolver -> scheduler.
+ * The output consumes the windows in order and hands them back for reuse. So the memory usage
+ * doesn't depend on the size of the input and sending starts as soon as the first window is ready.
+ * Loops (-l) are done by compiling the input again.
+ */
+class cPacketStream
+{
+public:
+    cPacketStream (cCompiler& compiler, cFilter& filter, cResolver* resolver, cScheduler& scheduler);
+    ~cPacketStream ();
+    cPacketStream (const cPacketStream&) = delete;
+    cPacketStream& operator= (const cPacketStream&) = delete;
+
+    void start (const std::vector<std::string>& input, int repeat);
+    void stop (void);
+    bool hasUserTimestamps (void);
+    cPacketData* next (void);
+    void release (cPacketData* window);
+
+    static const size_t WINDOWS        = 4;
+    static const size_t WINDOW_PACKETS = 4096;
+
+private:
+    void run (int repeat);
+
+    cCompiler&  compiler;
+    cFilter&    filter;
+    cResolver*  resolver;
+    cScheduler& scheduler;
+
+    cPacketData windows[WINDOWS];
+    size_t      produced;   // number of windows, that were handed over to the consumer
+    size_t      consumed;   // number of windows, that were handed back by the consumer
+    bool        finished;   // end of input reached or error
+    bool        stopping;
+    std::exception_ptr error;
+    std::mutex  lock;
+    std::condition_variable cond;
+    std::thread producer;
+};
+
+#endif /* PACKETSTREAM_HPP_ */
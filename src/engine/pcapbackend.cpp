@@ -1,7 +1,7 @@
 // SPDX-License-Identifier: GPL-3.0-only
 /*
  * TCPPUMP <https://github.com/amartin755/tcppump>
- * Copyright (C) 2012-2025 Andreas Martin (netnag@mailbox.org)
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -19,22 +19,21 @@
 
 #include "pcapbackend.hpp"
 #include "fileioexception.hpp"
-#include "ethernetpacket.hpp"
 
 
-cPcapBackend::cPcapBackend (const char* file) : m_pcapWrittenPackets(0), m_pcapWrittenBytes(0)
+cPcapBackend::cPcapBackend (const char* file, cPcapFileIO::fileFormat format) : m_pcapWrittenPackets(0), m_pcapWrittenBytes(0)
 {
-    if (!m_outfile.open (file, true))
+    if (!m_outfile.open (file, true, format))
         throw FileIOException (FileIOException::OPEN, file);
 
 }
 
-void cPcapBackend::write (const cTimeval& sendTime, cEthernetPacket& p)
+void cPcapBackend::write (const cTimeval& sendTime, const uint8_t* frame, size_t length)
 {
-    if (!m_outfile.write (sendTime, p.get(), (int)p.getLength(), true))
+    if (!m_outfile.write (sendTime, frame, (int)length, true))
         throw FileIOException (FileIOException::WRITE, m_outfile.name());
     m_pcapWrittenPackets++;
-    m_pcapWrittenBytes += (uint64_t)p.getLength ();
+    m_pcapWrittenBytes += (uint64_t)length;
 }
 
 void cPcapBackend::statistic (uint64_t& sentPackets, uint64_t& sentBytes, double& duration) const
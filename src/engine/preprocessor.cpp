@@ -1,7 +1,7 @@
 // SPDX-License-Identifier: GPL-3.0-only
 /*
  * TCPPUMP <https://github.com/amartin755/tcppump>
- * Copyright (C) 2012-2021 Andreas Martin (netnag@mailbox.org)
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -17,6 +17,8 @@
  */
 
 
+#include <cstring>
+
 #include "preprocessor.hpp"
 
 cPreprocessor::cPreprocessor(bool randSrcMac, bool randDstMac) :
@@ -25,10 +27,12 @@ cPreprocessor::cPreprocessor(bool randSrcMac, bool randDstMac) :
 
 }
 
-void cPreprocessor::process (cEthernetPacket& packet) const
+void cPreprocessor::process (uint8_t* frame) const
 {
+    mac_header_t* header = (mac_header_t*)frame;
+
     if (randomSrcMac)
-        packet.setRandomSrcMac();
+        std::memcpy (&header->src, cMacAddress (true, false).get(), sizeof (header->src));
     if (randomDstMac)
-        packet.setRandomDestMac();
+        std::memcpy (&header->dest, cMacAddress (true, false).get(), sizeof (header->dest));
 }
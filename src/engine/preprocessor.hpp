@@ -1,7 +1,7 @@
 // SPDX-License-Identifier: GPL-3.0-only
 /*
  * TCPPUMP <https://github.com/amartin755/tcppump>
- * Copyright (C) 2012-2021 Andreas Martin (netnag@mailbox.org)
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -27,7 +27,8 @@ class cPreprocessor
 {
 public:
     cPreprocessor (bool randomSrcMac, bool randomDstMac);
-    void process (cEthernetPacket& packet) const;
+    void process (uint8_t* frame) const;
+    bool modifiesPackets (void) const {return randomSrcMac || randomDstMac;}
 
 private:
     bool randomSrcMac;
@@ -0,0 +1,195 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ * TCPPUMP <https://github.com/amartin755/tcppump>
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <cstdlib>
+#include <cstring>
+
+#include "ratelimiter.hpp"
+#include "bug.hpp"
+
+// ethernet overhead on the wire
+static const size_t ETH_MIN_FRAME = 60;  // without FCS
+static const size_t ETH_FCS       = 4;
+static const size_t ETH_PREAMBLE  = 7;
+static const size_t ETH_SFD       = 1;
+static const size_t ETH_IFG       = 12;
+
+
+cRateLimiter::cRateLimiter ()
+{
+    unit       = PPS;
+    value      = 0.0;
+    bitRate    = 0.0;
+    packetRate = 0.0;
+    tNs        = 0.0;
+}
+
+bool cRateLimiter::parse (const char* rate)
+{
+    char* end;
+    double multiplier = 1.0;
+
+    value = std::strtod (rate, &end);
+    if (end == rate || !(value > 0.0))
+        return false;
+
+    switch (*end)
+    {
+    case 'k':
+        multiplier = 1e3;
+        end++;
+        break;
+    case 'M':
+        multiplier = 1e6;
+        end++;
+        break;
+    case 'G':
+        multiplier = 1e9;
+        end++;
+        break;
+    }
+
+    if (!std::strcmp (end, "pps"))
+    {
+        unit       = PPS;
+        packetRate = value * multiplier;
+    }
+    else if (!std::strcmp (end, "bps"))
+    {
+        unit    = BPS;
+        bitRate = value * multiplier;
+    }
+    else if (!std::strcmp (end, "%") && multiplier == 1.0 && value <= 100.0)
+    {
+        unit = PERCENT;
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
+
+bool cRateLimiter::setLinkSpeed (uint64_t bps)
+{
+    if (unit != PERCENT)
+        return true;
+    if (!bps)
+        return false;
+
+    bitRate = (double)bps * value / 100.0;
+    return true;
+}
+
+size_t cRateLimiter::wireLength (size_t length)
+{
+    if (length < ETH_MIN_FRAME)
+        length = ETH_MIN_FRAME;
+
+    return ETH_PREAMBLE + ETH_SFD + length + ETH_FCS + ETH_IFG;
+}
+
+cTimeval cRateLimiter::next (size_t length, const txOffload& offload)
+{
+    BUG_ON (bitRate <= 0.0 && packetRate <= 0.0);
+
+    cTimeval t;
+    t.setNs ((uint64_t)tNs / TICK_NS * TICK_NS);
+
+    size_t segLength, lastLength;
+    size_t segments = offload.segments (length, segLength, lastLength);
+
+    if (unit == PPS)
+        tNs += (double)segments * 1e9 / packetRate;
+    else
+        tNs += (double)(((segments - 1) * wireLength (segLength) + wireLength (lastLength)) * 8) * 1e9 / bitRate;
+
+    return t;
+}
+
+
+#ifdef WITH_UNITTESTS
+
+void cRateLimiter::unitTest (void)
+{
+    cRateLimiter r;
+
+    BUG_IF_NOT (!r.parse (""));
+    BUG_IF_NOT (!r.parse ("100"));
+    BUG_IF_NOT (!r.parse ("-1pps"));
+    BUG_IF_NOT (!r.parse ("0bps"));
+    BUG_IF_NOT (!r.parse ("10Xbps"));
+    BUG_IF_NOT (!r.parse ("101%"));
+    BUG_IF_NOT (!r.parse ("1k%"));
+    BUG_IF_NOT (!r.parse ("1ppsx"));
+
+    BUG_IF_NOT (wireLength (0) == 84);
+    BUG_IF_NOT (wireLength (60) == 84);
+    BUG_IF_NOT (wireLength (1514) == 1538);
+
+    BUG_IF_NOT (r.parse ("2kpps"));
+    BUG_IF_NOT (!r.isRelative ());
+    BUG_IF_NOT (r.next (100).us () == 0);
+    BUG_IF_NOT (r.next (1000).us () == 500);
+    BUG_IF_NOT (r.next (10).us () == 1000);
+
+    // TCP super-frame with 4000 bytes payload --> segments of 1514, 1514 and 1134 bytes
+    txOffload superFrame;
+    superFrame.csumStart = 34;
+    superFrame.gsoType   = txOffload::GSO_TCPV4;
+    superFrame.gsoSize   = 1460;
+    superFrame.gsoHdrLen = 54;
+    r.reset ();
+    BUG_IF_NOT (r.next (4054, superFrame).us () == 0);
+    BUG_IF_NOT (r.next (60).us () == 1500);
+
+    // 84 bytes --> 672 ns
+    BUG_IF_NOT (r.parse ("1Gbps"));
+    r.reset ();
+    cTimeval t;
+    BUG_IF_NOT (r.next (60).ns () == 0);
+    BUG_IF_NOT (r.next (60).ns () == 0);        // same tick --> burst
+    BUG_IF_NOT (r.next (60).ns () == 1000);
+    r.reset ();
+    for (int n = 0; n < 1000; n++)
+        t = r.next (60);
+    BUG_IF_NOT (t.us () == 671);
+
+    // 2 * 1538 + 1158 bytes --> 33872 ns
+    r.reset ();
+    r.next (4054, superFrame);
+    BUG_IF_NOT (r.next (60).ns () == 33000);
+
+    BUG_IF_NOT (r.parse ("1.5Mbps"));
+    r.reset ();
+    r.next (1514);
+    BUG_IF_NOT (r.next (1514).us () == 8202);
+
+    BUG_IF_NOT (r.parse ("40%"));
+    BUG_IF_NOT (r.isRelative ());
+    BUG_IF_NOT (!r.setLinkSpeed (0));
+    BUG_IF_NOT (r.setLinkSpeed (10000000000ULL));
+    BUG_IF_NOT (r.getBitRate () == 4e9);
+    r.reset ();
+    r.next (1514);
+    BUG_IF_NOT (r.next (1514).us () == 3);
+}
+
+#endif
@@ -0,0 +1,70 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ * TCPPUMP <https://github.com/amartin755/tcppump>
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef RATELIMITER_HPP_
+#define RATELIMITER_HPP_
+
+#include <cstdint>
+#include <cstddef>
+
+#include "timeval.hpp"
+#include "txoffload.hpp"
+
+/*
+ * Calculates the send times of packets for a given rate (virtual scheduling, which is
+ * equivalent to a token bucket). Bit rates are wire rates, i.e. preamble, SFD, FCS and
+ * inter-frame gap are counted, thus 100% is exactly the link speed.
+ * Send times are quantized to ticks of TICK_NS. Packets within the same tick get the same
+ * send time and are sent as burst, thus at high rates not every packet needs its own wait
+ * and syscall. The schedule itself is calculated in ns, thus rounding errors don't accumulate.
+ * Super-frames (GSO) are counted as the segments or fragments they are split into.
+ */
+class cRateLimiter
+{
+public:
+    cRateLimiter ();
+
+    // rate is "<n>[k|M|G]pps", "<n>[k|M|G]bps" or "<n>%" of link speed
+    bool parse (const char* rate);
+    bool isRelative (void) const {return unit == PERCENT;}
+    bool setLinkSpeed (uint64_t bps);
+    double getBitRate (void) const {return bitRate;}
+    double getPacketRate (void) const {return packetRate;}
+
+    void reset (void) {tNs = 0.0;}
+    cTimeval next (size_t length, const txOffload& offload = txOffload ());
+
+    static const uint64_t TICK_NS = 1000;
+
+    // number of bytes on the wire of an ethernet frame without FCS
+    static size_t wireLength (size_t length);
+
+#ifdef WITH_UNITTESTS
+    static void unitTest (void);
+#endif
+
+private:
+    enum {PPS, BPS, PERCENT} unit;
+    double value;
+    double bitRate;
+    double packetRate;
+    double tNs;         // send time of the next packet
+};
+
+#endif /* RATELIMITER_HPP_ */
@@ -1,7 +1,7 @@
 // SPDX-License-Identifier: GPL-3.0-only
 /*
  * TCPPUMP <https://github.com/amartin755/tcppump>
- * Copyright (C) 2012-2021 Andreas Martin (netnag@mailbox.org)
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -18,6 +18,8 @@
 
 
 #include <utility>
+#include <set>
+#include <vector>
 #include <stdexcept>
 #include "resolver.hpp"
 #include "console.hpp"
@@ -33,44 +35,61 @@ cPacketData& cResolver::operator<< (cPacketData& input)
 {
     Console::PrintDebug ("Resolving ...\n");
 
+    // collect all unknown hosts first, so that they can be resolved at once
+    std::set<cIPv4> unknown;
     for (cLinkable* p = input.getFirst(); p != nullptr; p = p->getNext())
     {
         cIPPacket* ipv4 = dynamic_cast<cIPPacket*>(p);
 
         if (ipv4 && !ipv4->getFirstEthernetPacket().hasDestMac())
         {
-            cMacAddress dmac;
+            // only the MAC of the first destination could be patched into the frame
+            if (ipv4->hasMutation (cIPPacket::FIELD_DESTINATION))
+                throw std::runtime_error("Destination MAC of packets with changing destination IP can't be resolved, dmac must be set.");
+
             cIPv4 dip;
             ipv4->getDestination(dip);
 
-            try
+            if (cache.find (dip) == cache.end())
+                unknown.insert (dip);
+        }
+    }
+
+    if (!unknown.empty())
+    {
+        Console::PrintMostVerbose ("Try to resolve MAC of %u host(s) ...\n", unsigned (unknown.size()));
+        bool resolved = arper.resolve (std::vector<cIPv4> (unknown.begin(), unknown.end()), cache);
+
+        for (const auto& dip : unknown)
+        {
+            std::string sIP;
+            dip.get (sIP);
+
+            auto host = cache.find (dip);
+            if (host != cache.end())
             {
-                dmac = cache.at (dip);
+                const uint8_t* dmac = (const uint8_t*)host->second.get();
+                Console::PrintMostVerbose ("%s is at %02x:%02x:%02x:%02x:%02x:%02x \n", sIP.c_str(),
+                        dmac[0], dmac[1], dmac[2], dmac[3], dmac[4], dmac[5]);
             }
-            catch (const std::out_of_range&)
+            else
             {
-                std::string sIP;
-                dip.get (sIP);
-
-                Console::PrintMostVerbose ("Try to resolve MAC of host %s ... ", sIP.c_str());
-                if (arper.resolve(dip, dmac))
-                {
-                    Console::PrintMostVerbose (" is at %02x:%02x:%02x:%02x:%02x:%02x \n",
-                            ((const uint8_t*)dmac.get())[0],
-                            ((const uint8_t*)dmac.get())[1],
-                            ((const uint8_t*)dmac.get())[2],
-                            ((const uint8_t*)dmac.get())[3],
-                            ((const uint8_t*)dmac.get())[4],
-                            ((const uint8_t*)dmac.get())[5]);
-                    cache.insert ({dip, dmac});
-                }
-                else
-                {
-                    Console::PrintError ("TIMEOUT! %s unreachable\n", sIP.c_str());
-                    throw std::runtime_error("Could not resolve host(s).");
-                }
+                Console::PrintError ("TIMEOUT! %s unreachable\n", sIP.c_str());
             }
-            ipv4->setDestMac (dmac);
+        }
+        if (!resolved)
+            throw std::runtime_error("Could not resolve host(s).");
+    }
+
+    for (cLinkable* p = input.getFirst(); p != nullptr; p = p->getNext())
+    {
+        cIPPacket* ipv4 = dynamic_cast<cIPPacket*>(p);
+
+        if (ipv4 && !ipv4->getFirstEthernetPacket().hasDestMac())
+        {
+            cIPv4 dip;
+            ipv4->getDestination(dip);
+            ipv4->setDestMac (cache.at (dip));
         }
     }
 
@@ -1,7 +1,7 @@
 // SPDX-License-Identifier: GPL-3.0-only
 /*
  * TCPPUMP <https://github.com/amartin755/tcppump>
- * Copyright (C) 2012-2021 Andreas Martin (netnag@mailbox.org)
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -20,6 +20,9 @@
 #ifndef ARP_HPP_
 #define ARP_HPP_
 
+#include <map>
+#include <vector>
+
 #include "macaddress.hpp"
 #include "ipaddress.hpp"
 
@@ -30,6 +33,8 @@ class cArp
 public:
     cArp (cNetInterface& ifc);
     bool resolve (const cIPv4& ip, cMacAddress& mac);
+    // resolves all hosts at once and adds their MACs to 'macs'; returns false if at least one host is unreachable
+    bool resolve (const std::vector<cIPv4>& hosts, std::map<cIPv4, cMacAddress>& macs);
 
 private:
     cNetInterface& ifc;
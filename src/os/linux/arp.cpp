@@ -1,7 +1,7 @@
 // SPDX-License-Identifier: GPL-3.0-only
 /*
  * TCPPUMP <https://github.com/amartin755/tcppump>
- * Copyright (C) 2012-2021 Andreas Martin (netnag@mailbox.org)
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -17,12 +17,18 @@
  */
 
 #include <cstring>
+#include <cerrno>
 #include <chrono>
+#include <set>
 
 #include <unistd.h>
 #include <sys/socket.h>
+#include <sys/epoll.h>
 #include <linux/if_packet.h>
 #include <linux/if_ether.h>     /* IEEE 802.3 Ethernet constants */
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/neighbour.h>
 #include <net/if.h>
 
 #include "arp.hpp"
@@ -35,15 +41,129 @@
 
 using namespace std;
 
+static const int ARP_ATTEMPTS    = 2;       // requests per host
+static const int ARP_INTERVAL_MS = 1000;    // time between two requests to the same host
+
+
+// Takes the hosts, that are known by the neighbour table of the kernel, out of 'pending'.
+// Failures are not fatal, the remaining hosts are resolved via ARP anyway.
+static void lookupNeighbours (int ifIndex, set<cIPv4>& pending, map<cIPv4, cMacAddress>& macs)
+{
+    int nlSock;
+
+    errno = 0;
+    if ((nlSock = socket (AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE)) < 0)
+    {
+        Console::PrintDebug ("Unable to open netlink socket. %s.\n", strerror(errno));
+        return;
+    }
+
+    struct
+    {
+        struct nlmsghdr nh;
+        struct ndmsg    ndm;
+    } req;
+    memset (&req, 0, sizeof (req));
+    req.nh.nlmsg_len      = NLMSG_LENGTH (sizeof (struct ndmsg));
+    req.nh.nlmsg_type     = RTM_GETNEIGH;
+    req.nh.nlmsg_flags    = NLM_F_REQUEST | NLM_F_DUMP;
+    req.nh.nlmsg_seq      = 1;
+    req.ndm.ndm_family    = AF_INET;
+    req.ndm.ndm_ifindex   = ifIndex;
+
+    struct sockaddr_nl kernel;
+    memset (&kernel, 0, sizeof (kernel));
+    kernel.nl_family = AF_NETLINK;
+
+    errno = 0;
+    if (sendto (nlSock, &req, req.nh.nlmsg_len, 0, (struct sockaddr*)&kernel, sizeof (kernel)) < 0)
+    {
+        Console::PrintDebug ("RTM_GETNEIGH failed. %s.\n", strerror(errno));
+        close (nlSock);
+        return;
+    }
+
+    // entries in these states have a valid link layer address
+    const uint16_t validStates = NUD_REACHABLE | NUD_STALE | NUD_DELAY | NUD_PROBE | NUD_PERMANENT;
+    alignas (struct nlmsghdr) uint8_t buf[32768];
+    bool done = false;
+
+    while (!done && !pending.empty())
+    {
+        ssize_t len = recv (nlSock, buf, sizeof (buf), 0);
+        if (len < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            Console::PrintDebug ("Reading neighbour table failed. %s.\n", strerror(errno));
+            break;
+        }
+
+        for (struct nlmsghdr* nh = (struct nlmsghdr*)buf; NLMSG_OK (nh, (size_t)len); nh = NLMSG_NEXT (nh, len))
+        {
+            if (nh->nlmsg_type == NLMSG_DONE || nh->nlmsg_type == NLMSG_ERROR)
+            {
+                done = true;
+                break;
+            }
+            if (nh->nlmsg_type != RTM_NEWNEIGH || nh->nlmsg_len < NLMSG_LENGTH (sizeof (struct ndmsg)))
+                continue;
+
+            const struct ndmsg* ndm = (const struct ndmsg*)NLMSG_DATA (nh);
+            if (ndm->ndm_family != AF_INET || ndm->ndm_ifindex != ifIndex || !(ndm->ndm_state & validStates))
+                continue;
+
+            const struct in_addr* dst = nullptr;
+            const void* lladdr        = nullptr;
+            int attrLen = (int)(nh->nlmsg_len - NLMSG_LENGTH (sizeof (struct ndmsg)));
+
+            for (struct rtattr* rta = (struct rtattr*)((uint8_t*)ndm + NLMSG_ALIGN (sizeof (struct ndmsg)));
+                    RTA_OK (rta, attrLen); rta = RTA_NEXT (rta, attrLen))
+            {
+                if (rta->rta_type == NDA_DST && RTA_PAYLOAD (rta) == sizeof (struct in_addr))
+                    dst = (const struct in_addr*)RTA_DATA (rta);
+                else if (rta->rta_type == NDA_LLADDR && RTA_PAYLOAD (rta) == cMacAddress::size())
+                    lladdr = RTA_DATA (rta);
+            }
+
+            if (dst && lladdr)
+            {
+                auto host = pending.find (cIPv4 (*dst));
+                if (host != pending.end())
+                {
+                    cMacAddress mac;
+                    mac.set (lladdr, cMacAddress::size());
+                    macs[*host] = mac;
+                    pending.erase (host);
+                }
+            }
+        }
+    }
+
+    close (nlSock);
+}
+
+
 cArp::cArp (cNetInterface& i) : ifc(i)
 {
 }
 
 bool cArp::resolve (const cIPv4& ip, cMacAddress& mac)
 {
-    bool resolved = false;
+    map<cIPv4, cMacAddress> macs;
+
+    if (!resolve (vector<cIPv4> {ip}, macs))
+        return false;
+
+    mac = macs[ip];
+    return true;
+}
+
+bool cArp::resolve (const vector<cIPv4>& hosts, map<cIPv4, cMacAddress>& macs)
+{
+    set<cIPv4> pending (hosts.begin(), hosts.end());
     struct sockaddr_ll device;
-    int arpSock;
+    int arpSock, epollFd;
     cMacAddress myMac;
     cIPv4 myIP;
     // We don't really need an "opened" interface here. This is a sanity check, to accept validated interfaces only.
@@ -51,68 +171,126 @@ bool cArp::resolve (const cIPv4& ip, cMacAddress& mac)
     BUG_ON (!ifc.getMAC(myMac));
     BUG_ON (!ifc.getIPv4(myIP));
 
+    int ifIndex = (int)if_nametoindex (ifc.getName());
+
+    lookupNeighbours (ifIndex, pending, macs);
+    Console::PrintDebug ("%u of %u hosts found in neighbour table\n",
+            unsigned (hosts.size() - pending.size()), unsigned (hosts.size()));
+    if (pending.empty())
+        return true;
 
     errno = 0;
-    if ((arpSock = socket (PF_PACKET, SOCK_RAW, htons (ETH_P_ARP))) < 0)
+    if ((arpSock = socket (PF_PACKET, SOCK_RAW | SOCK_CLOEXEC, htons (ETH_P_ARP))) < 0)
     {
         Console::PrintError ("Unable to open raw socket. %s.\n", strerror(errno));
         return false;
     }
 
     memset (&device, 0, sizeof(device));
-    device.sll_ifindex = if_nametoindex (ifc.getName());
-    device.sll_family  = AF_PACKET;
-    device.sll_halen   = htons (sizeof (myMac));
+    device.sll_ifindex  = ifIndex;
+    device.sll_family   = AF_PACKET;
+    device.sll_protocol = htons (ETH_P_ARP);
+    device.sll_halen    = htons (sizeof (myMac));
     memcpy (device.sll_addr, &myMac, sizeof (myMac));
 
-    uint8_t buf[64] = {0};
-    cArpPacket arpReq;
-//    arp.probe (myMac, ip); // use probe instead of 'whoHas' to hide our IP address, because it could be overwritten by user
-    arpReq.whoHas (myMac, myIP, ip);
+    // only replies received on our interface are of interest
+    errno = 0;
+    if (bind (arpSock, (struct sockaddr*)&device, sizeof (device)))
+    {
+        Console::PrintError ("Unable to bind raw socket. %s.\n", strerror(errno));
+        close (arpSock);
+        return false;
+    }
+
+    // many hosts may answer at almost the same time
+    int rcvBuf = 1 << 20;
+    setsockopt (arpSock, SOL_SOCKET, SO_RCVBUF, &rcvBuf, sizeof (rcvBuf));
 
-    for (int n = 0; n < 2 && !resolved; n++)
+    errno = 0;
+    if ((epollFd = epoll_create1 (EPOLL_CLOEXEC)) < 0)
     {
-        struct timeval tv;
-        tv.tv_sec = 1;
-        tv.tv_usec = 0;
-        errno = 0;
-        if (setsockopt (arpSock, SOL_SOCKET, SO_RCVTIMEO, (const char*)&tv, sizeof tv))
-        {
-            Console::PrintError ("Unable to set socket timeout. %s.\n", strerror(errno));
+        Console::PrintError ("Unable to create epoll instance. %s.\n", strerror(errno));
+        close (arpSock);
+        return false;
+    }
+    struct epoll_event ev;
+    memset (&ev, 0, sizeof (ev));
+    ev.events = EPOLLIN;
+    ev.data.fd = arpSock;
+    epoll_ctl (epollFd, EPOLL_CTL_ADD, arpSock, &ev);
+
+    auto tStart   = chrono::steady_clock::now();
+    auto deadline = tStart + chrono::milliseconds (ARP_ATTEMPTS * ARP_INTERVAL_MS);
+    auto nextSend = tStart;
+    int attempts  = 0;
+    bool failed   = false;
+    uint8_t buf[128];
+
+    while (!pending.empty() && !failed)
+    {
+        auto now = chrono::steady_clock::now();
+        if (now >= deadline)
             break;
+
+        // (re)send a request to every host, that did not reply so far
+        if (attempts < ARP_ATTEMPTS && now >= nextSend)
+        {
+            cArpPacket arpReq;
+            for (const auto& ip : pending)
+            {
+                arpReq.whoHas (myMac, myIP, ip);
+                errno = 0;
+                if (sendto (arpSock, arpReq.get(), arpReq.getLength(), 0,
+                        (struct sockaddr *) &device, sizeof (device)) != (ssize_t)arpReq.getLength())
+                {
+                    Console::PrintError ("error: %s\n", strerror (errno));
+                    failed = true;
+                    break;
+                }
+            }
+            attempts++;
+            nextSend = now + chrono::milliseconds (ARP_INTERVAL_MS);
+            continue;
         }
 
-        auto tStart = chrono::steady_clock::now();
-        errno = 0;
-        if (sendto (arpSock, arpReq.get(), arpReq.getLength(), 0,
-                (struct sockaddr *) &device, sizeof (device)) != (ssize_t)arpReq.getLength())
+        auto wakeup = attempts < ARP_ATTEMPTS ? min (nextSend, deadline) : deadline;
+        int timeout = (int)chrono::duration_cast<chrono::milliseconds>(wakeup - now).count() + 1;
+
+        int ready = epoll_wait (epollFd, &ev, 1, timeout);
+        if (ready < 0 && errno != EINTR)
         {
-            Console::PrintError ("error: %s\n", strerror (errno));
+            Console::PrintError ("epoll_wait failed. %s.\n", strerror (errno));
             break;
         }
+        if (ready <= 0)
+            continue;
 
-        do
+        // drain the socket
+        ssize_t len;
+        while ((len = recv (arpSock, buf, sizeof(buf), MSG_DONTWAIT)) >= 0)
         {
-            if (recv (arpSock, buf, sizeof(buf), 0) >=
-                    ssize_t(sizeof(mac_header_t) + sizeof (arp_t)))
-            {
-                mac_header_t* mHeader = (mac_header_t*)buf;
-                arp_t* arp            = (arp_t*)(buf + sizeof (mac_header_t));
+            if (len < ssize_t(sizeof(mac_header_t) + sizeof (arp_t)))
+                continue;
+
+            mac_header_t* mHeader = (mac_header_t*)buf;
+            arp_t* arp            = (arp_t*)(buf + sizeof (mac_header_t));
 
-                if (mHeader->ethertypeLength == htons (ETH_P_ARP) &&
-                    arp->isReply()                                &&
-                    cIPv4 (arp->srcIp) == ip)
+            if (mHeader->ethertypeLength == htons (ETH_P_ARP) && arp->isReply())
+            {
+                auto host = pending.find (cIPv4 (arp->srcIp));
+                if (host != pending.end())
                 {
+                    cMacAddress mac;
                     mac.set ((void*)&arp->srcMac, sizeof (arp->srcMac));
-                    resolved = true;
-                    break;
+                    macs[*host] = mac;
+                    pending.erase (host);
                 }
             }
         }
-        while (chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - tStart).count() < 1000);
     }
 
+    close (epollFd);
     close (arpSock);
 
-    return resolved;
+    return pending.empty();
 }
@@ -17,6 +17,8 @@
  */
 
 
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
 #include <cstring>
 #include <string>
 #include <cstdio>
@@ -26,32 +28,133 @@
 #include <unistd.h>
 #include <sys/ioctl.h>
 #include <sys/socket.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <sched.h>
+#include <pthread.h>
 #include <linux/if_packet.h>
+#include <linux/errqueue.h>
+#include <linux/net_tstamp.h>
 #include <net/ethernet.h>
 #include <net/if.h>           // struct ifreq
 #include <netinet/in.h>
 #include <net/if_arp.h>       // ARPHRD_ETHER
 #include <ifaddrs.h>
 #include <netdb.h>            // NI_MAXHOST, NI_NUMERICHOST
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 #include "interface.hpp"
 
 #include "bug.hpp"
 #include "console.hpp"
-#include "sleep.hpp"
 #include "signal.hpp"
 
+// upper limits of the tx ring (number of frames and memory)
+static const size_t TX_RING_MAX_FRAMES = 4096;
+static const size_t TX_RING_MAX_SIZE   = 16 * 1024 * 1024;
+// offset of ethernet frame within a tx ring frame (see Documentation/networking/packet_mmap.rst)
+static const size_t TX_RING_DATA_OFFSET = TPACKET_ALIGN (sizeof (struct tpacket2_hdr));
 
-cInterface::cInterface(const char* ifname, bool needPriviledges)
+
+// frames are passed directly to the driver; they are dropped if its queue is full
+static void enableQdiscBypass (int handle)
+{
+    int one = 1;
+    errno = 0;
+    if (setsockopt (handle, SOL_PACKET, PACKET_QDISC_BYPASS, &one, sizeof (one)) < 0)
+        Console::PrintVerbose ("Warning: Could not bypass qdisc layer. %s.\n", strerror(errno));
+}
+
+// struct virtio_net_hdr of <linux/virtio_net.h>, which can't be included by C++ code (member named 'class')
+struct vnet_hdr_t
+{
+    uint8_t  flags;
+    uint8_t  gsoType;
+    uint16_t hdrLen;        // length of the headers, which must be in the linear part of the kernel's buffer
+    uint16_t gsoSize;
+    uint16_t csumStart;
+    uint16_t csumOffset;
+};
+static_assert (sizeof (vnet_hdr_t) == 10, "vnet_hdr_t is not natural aligned");
+static const uint8_t VNET_HDR_F_NEEDS_CSUM = 1;
+static const uint8_t VNET_HDR_GSO_NONE     = 0;
+static const uint8_t VNET_HDR_GSO_TCPV4    = 1;
+static const uint8_t VNET_HDR_GSO_UDP      = 3;    // IP fragmentation (UFO), not UDP segmentation
+static const uint8_t VNET_HDR_GSO_TCPV6    = 4;
+
+// all frames sent via the socket are prefixed by a virtio_net_hdr, which contains their offload information
+static bool enableVnetHdr (int handle)
+{
+    int one = 1;
+    errno = 0;
+    return setsockopt (handle, SOL_PACKET, PACKET_VNET_HDR, &one, sizeof (one)) == 0;
+}
+
+/*
+ * Describes a frame and its optional virtio header (vnetHdr may be NULL) by iov, which must have two elements.
+ * Returns the number of used elements.
+ */
+static size_t frameIov (struct iovec* iov, const uint8_t* vnetHdr, size_t vnetHdrLen, const uint8_t* payload, size_t length)
+{
+    size_t n = 0;
+    if (vnetHdr)
+    {
+        iov[n].iov_base = (void*)vnetHdr;
+        iov[n].iov_len  = vnetHdrLen;
+        n++;
+    }
+    iov[n].iov_base = (void*)payload;
+    iov[n].iov_len  = length;
+
+    return n + 1;
+}
+
+
+cInterface::cInterface(const char* ifname, bool needPriviledges, const txOptions& opt)
 : name (ifname)
 {
-    ifcHandle   = -1;
-    ifIndex     = 0;
-    sentPackets = 0;
-    sentBytes   = 0;
-    firstPacket = true;
-    mtu         = 0;
-    linkSpeed   = 0;
+    ifcHandle      = -1;
+    ifIndex        = 0;
+    sentPackets    = 0;
+    sentBytes      = 0;
+    droppedPackets = 0;
+    firstPacket    = true;
+    lastPaceResult = true;
+    synchronized   = false;
+    mtu            = 0;
+    linkSpeed      = 0;
+
+    noTxRing      = opt.noTxRing;
+    catchUp       = opt.catchUp;
+    launchTime    = opt.launchTime;
+    launchLead    = opt.launchLead * 1000;
+    launchActive  = false;
+    launchStart   = 0;
+    launchLast    = 0;
+    launchPending = 0;
+    launchMissed  = 0;
+    launchInvalid = 0;
+    txTimestamps  = opt.txTimestamps;
+    tsCsvFile     = opt.tsCsvFile;
+    timestamps    = nullptr;
+    scheduleStart = 0;
+    qdiscBypass   = opt.qdiscBypass;
+    txThreads     = opt.txThreads;
+    vnetHdrLen    = opt.csumOffload ? sizeof (vnet_hdr_t) : 0;
+    currWorker    = 0;
+    workerPackets = 0;
+    txBatch       = opt.txBatch ? opt.txBatch : 1;
+    queueActive   = false;
+    ringHandle    = -1;
+    ring          = nullptr;
+    ringSize      = 0;
+    ringFrameSize = 0;
+    ringFrameNr   = 0;
+    ringFrameIdx  = 0;
+    ringPending   = 0;
+    memset (&device, 0, sizeof(device));
 
     ifIndex = if_nametoindex (name.c_str ());
     if (!ifIndex)
@@ -108,6 +211,14 @@ bool cInterface::open ()
     }
     int opt = 0;
     setsockopt (ifcHandle, SOL_SOCKET, SO_RCVBUF, &opt, sizeof (opt));
+    if (qdiscBypass)
+        enableQdiscBypass (ifcHandle);
+    if (vnetHdrLen && !enableVnetHdr (ifcHandle))
+    {
+        Console::PrintError ("Checksum offload (PACKET_VNET_HDR) is not supported. %s.\n", strerror(errno));
+        close ();
+        return false;
+    }
 
     getMAC (myMac);
     mtu       = getMTU ();
@@ -117,7 +228,11 @@ bool cInterface::open ()
     myMac.get(macAsString);
     Console::PrintDebug ("Successfully opened %s mac=%s\n", name.c_str(), macAsString.c_str());
 
-    lastSentPacket.clear();
+    memset (&device, 0, sizeof(device));
+    device.sll_ifindex = ifIndex;
+    device.sll_family  = AF_PACKET;
+    device.sll_halen   = htons (sizeof (myMac));
+    memcpy (device.sll_addr, &myMac, sizeof (myMac));
 
     return (isOpen());
 }
@@ -125,6 +240,12 @@ bool cInterface::open ()
 
 bool cInterface::close ()
 {
+    txRingClose ();
+    sendQueueClose ();
+    workersStop ();
+    delete timestamps;
+    timestamps = nullptr;
+
     // aleady closed
     if (ifcHandle > 0)
         ::close (ifcHandle);
@@ -136,64 +257,1022 @@ bool cInterface::close ()
     return true;
 }
 
-bool cInterface::prepareSendQueue (__attribute__((unused)) size_t packetCnt,
-        __attribute__((unused)) size_t totalBytes, __attribute__((unused)) bool synchronized)
+// packetCnt = 0 means endless loop
+bool cInterface::prepareSendQueue (size_t packetCnt, __attribute__((unused)) size_t totalBytes, bool synchronized)
 {
+    paceInit (synchronized);
+
     if (synchronized)
     {
-        cTimeval accuracy = tcppump::SleepInit ();
-        Console::PrintMostVerbose ("System timer accuracy is %u usec. For packet delays below that value we do busy waiting.\n", (unsigned)accuracy.us());
+        if (txTimestamps)
+        {
+            timestamps = new cTxTimestamps;
+            if (!timestamps->start (ifcHandle, tsCsvFile))
+            {
+                delete timestamps;
+                timestamps = nullptr;
+                return false;
+            }
+        }
+        if (launchTime)
+        {
+            if (!launchTimeOpen ())
+                return false;
+        }
+        // packets with the same send time are handed over to the kernel at once
+        else if (txBatch > 1)
+        {
+            sendQueueOpen ();
+        }
+    }
+    else
+    {
+        if (launchTime)
+            Console::PrintVerbose ("Warning: Launch time is only used for time-triggered transmission.\n");
+        if (txTimestamps)
+            Console::PrintVerbose ("Warning: Tx timestamps are only used for time-triggered transmission.\n");
+
+        // in max. throughput mode the packets are handed over to the kernel in batches, either via tx ring or sendmmsg
+        if (txThreads > 1)
+        {
+            if (workersStart ())
+                return true;
+            Console::PrintVerbose ("Warning: Could not start tx threads. Sending from main thread.\n");
+        }
+        if (!noTxRing)
+        {
+            if (txRingOpen (packetCnt))
+            {
+                Console::PrintMostVerbose ("Using tx ring with %zu frames of %zu bytes\n", ringFrameNr, ringFrameSize);
+                return true;
+            }
+            Console::PrintVerbose ("Warning: Could not set up tx ring. Falling back to sendmmsg.\n");
+        }
+        if (txBatch > 1)
+        {
+            sendQueueOpen ();
+            Console::PrintMostVerbose ("Using send queue with batches of %zu packets\n", txBatch);
+        }
+    }
+
+    return true;
+}
+
+/*
+ * Send all frames, which are stored back-to-back in buffer, with as few syscalls as possible.
+ * The lengths of the frames are passed via iov_len, iov_base is set here. msgs must have at least iov.size() elements.
+ * addr may be NULL for bound sockets. The indices of frames, which were dropped because the socket buffer or
+ * the driver queue (qdisc bypass) was full, are appended to dropped.
+ */
+static bool sendFrames (int handle, struct sockaddr_ll* addr, uint8_t* buffer,
+        std::vector<struct iovec>& iov, std::vector<struct mmsghdr>& msgs, std::vector<size_t>& dropped)
+{
+    size_t cnt = iov.size ();
+    uint8_t* p = buffer;
+
+    BUG_ON (msgs.size () < cnt);
+
+    for (size_t n = 0; n < cnt; n++)
+    {
+        iov[n].iov_base = p;
+        p += iov[n].iov_len;
+
+        memset (&msgs[n], 0, sizeof (msgs[n]));
+        msgs[n].msg_hdr.msg_name    = addr;
+        msgs[n].msg_hdr.msg_namelen = addr ? sizeof (*addr) : 0;
+        msgs[n].msg_hdr.msg_iov     = &iov[n];
+        msgs[n].msg_hdr.msg_iovlen  = 1;
+    }
+
+    // sendmmsg may send less messages than requested; continue with the first unsent one
+    size_t sent = 0;
+    while (sent < cnt)
+    {
+        errno = 0;
+        int ret = sendmmsg (handle, &msgs[sent], (unsigned)(cnt - sent), 0);
+        if (ret < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            // the first unsent frame is dropped, like the kernel does it for full queues anyway
+            if (errno == ENOBUFS || errno == EAGAIN)
+            {
+                dropped.push_back (sent++);
+                continue;
+            }
+            Console::PrintError ("error: %s\n", strerror (errno));
+            return false;
+        }
+        sent += (size_t)ret;
     }
 
-    // STUB
     return true;
 }
 
-bool cInterface::sendPacket (const uint8_t* payload, size_t length, const cTimeval& t)
+
+/*
+ * Transmit thread with its own packet socket, pinned to one cpu.
+ * The main thread fills batches of frames, which are sent by the worker via sendmmsg.
+ * Each worker has MAX_BATCHES batch buffers, which are allocated by the worker thread itself.
+ * Thus, they are located on the numa node of the worker cpu (first touch policy).
+ */
+class cTxWorker
+{
+public:
+    static const size_t MAX_BATCHES = 4;
+
+    cTxWorker (int ifIndex, int cpu, bool qdiscBypass, size_t vnetHdrLen, size_t batchSize, size_t maxFrameSize)
+    : sentPackets (0), sentBytes (0), droppedPackets (0), cpu (cpu), ifIndex (ifIndex), qdiscBypass (qdiscBypass), vnetHdrLen (vnetHdrLen),
+      batchSize (batchSize), maxFrameSize (maxFrameSize), handle (-1), in (0), out (0), filled (0),
+      ready (false), terminate (false), failed (false)
+    {
+    }
+
+    ~cTxWorker ()
+    {
+        finish ();
+    }
+
+    bool start (void)
+    {
+        errno = 0;
+        if ((handle = socket (PF_PACKET, SOCK_RAW, 0)) < 0)
+        {
+            Console::PrintError ("Unable to open raw socket. %s.\n", strerror(errno));
+            return false;
+        }
+
+        struct sockaddr_ll addr;
+        memset (&addr, 0, sizeof(addr));
+        addr.sll_family  = AF_PACKET;
+        addr.sll_ifindex = ifIndex;
+        int opt = 0;
+        setsockopt (handle, SOL_SOCKET, SO_RCVBUF, &opt, sizeof (opt));
+        errno = 0;
+        if (bind (handle, (struct sockaddr *) &addr, sizeof (addr)) < 0)
+        {
+            Console::PrintError ("Unable to bind raw socket. %s.\n", strerror(errno));
+            return false;
+        }
+        if (qdiscBypass)
+            enableQdiscBypass (handle);
+        if (vnetHdrLen && !enableVnetHdr (handle))
+            return false;
+
+        // wait until the worker has allocated its buffers
+        thread = std::thread (&cTxWorker::run, this);
+        std::unique_lock<std::mutex> lock (mutex);
+        cond.wait (lock, [this]{return ready;});
+
+        return !failed;
+    }
+
+    // called by main thread; returns false if worker has failed
+    // segments and bytes are the frames on the wire, which differ for super-frames
+    bool add (const uint8_t* vnetHdr, const uint8_t* payload, size_t length, size_t segments, size_t bytes)
+    {
+        cBatch& b = batches[in];
+        struct iovec iov;
+
+        b.stats.push_back ({segments, bytes});
+
+        iov.iov_base = nullptr;
+        iov.iov_len  = length;
+        if (vnetHdr)
+        {
+            iov.iov_len += vnetHdrLen;
+            b.buffer.insert (b.buffer.end(), vnetHdr, vnetHdr + vnetHdrLen);
+        }
+        b.iov.push_back (iov);
+        b.buffer.insert (b.buffer.end(), payload, payload + length);
+
+        return b.iov.size () < batchSize || commit ();
+    }
+
+    // hand over current batch to the worker thread
+    bool commit (void)
+    {
+        std::unique_lock<std::mutex> lock (mutex);
+
+        if (batches[in].iov.empty ())
+            return !failed;
+
+        filled++;
+        in = (in + 1) % MAX_BATCHES;
+        cond.notify_all ();
+
+        // wait until the next batch is available
+        cond.wait (lock, [this]{return filled < MAX_BATCHES || failed;});
+
+        return !failed;
+    }
+
+    // send all pending frames and terminate the worker thread
+    bool finish (void)
+    {
+        bool success = true;
+
+        if (thread.joinable ())
+        {
+            // failed is read under the lock, as long as the thread runs
+            success = commit ();
+            {
+                std::lock_guard<std::mutex> lock (mutex);
+                terminate = true;
+                cond.notify_all ();
+            }
+            thread.join ();
+        }
+        if (handle >= 0)
+            ::close (handle);
+        handle = -1;
+
+        // the thread has been joined, no lock needed
+        return success && !failed;
+    }
+
+    // statistic, must only be read after finish()
+    uint64_t sentPackets;
+    uint64_t sentBytes;
+    uint64_t droppedPackets;
+    const int cpu;
+
+private:
+    struct cBatch
+    {
+        std::vector<uint8_t> buffer;
+        std::vector<struct iovec> iov;
+        std::vector<txFrameStat> stats;
+    };
+
+    void run (void)
+    {
+        cpu_set_t set;
+        CPU_ZERO (&set);
+        CPU_SET (cpu, &set);
+        int err = pthread_setaffinity_np (pthread_self (), sizeof (set), &set);
+        if (err)
+            Console::PrintVerbose ("Warning: Could not pin tx thread to cpu %d. %s.\n", cpu, strerror(err));
+
+        std::vector<struct mmsghdr> msgs (batchSize);
+        std::vector<size_t> dropped;
+        for (auto& b : batches)
+        {
+            b.iov.reserve (batchSize);
+            b.stats.reserve (batchSize);
+            b.buffer.resize (batchSize * maxFrameSize);  // touch memory to allocate it on our numa node
+            b.buffer.clear ();
+        }
+
+        std::unique_lock<std::mutex> lock (mutex);
+        ready = true;
+        cond.notify_all ();
+
+        while (1)
+        {
+            cond.wait (lock, [this]{return filled > 0 || terminate;});
+            if (!filled)
+                break;
+
+            cBatch& b = batches[out];
+            lock.unlock ();
+
+            dropped.clear ();
+            bool success = sendFrames (handle, nullptr, b.buffer.data (), b.iov, msgs, dropped);
+            if (success)
+            {
+                for (const auto& s : b.stats)
+                {
+                    sentPackets += s.packets;
+                    sentBytes   += s.bytes;
+                }
+                for (size_t n : dropped)
+                {
+                    sentPackets    -= b.stats[n].packets;
+                    sentBytes      -= b.stats[n].bytes;
+                    droppedPackets += b.stats[n].packets;
+                }
+            }
+            b.iov.clear ();
+            b.buffer.clear ();
+            b.stats.clear ();
+
+            lock.lock ();
+            out = (out + 1) % MAX_BATCHES;
+            filled--;
+            if (!success)
+                failed = true;
+            cond.notify_all ();
+            if (failed)
+                break;
+        }
+    }
+
+    const int ifIndex;
+    const bool qdiscBypass;
+    const size_t vnetHdrLen;
+    const size_t batchSize;
+    const size_t maxFrameSize;
+    int handle;
+
+    cBatch batches[MAX_BATCHES];
+    size_t in;      // batch currently filled by main thread
+    size_t out;     // batch currently sent by worker thread
+    size_t filled;  // number of batches owned by worker thread
+    bool ready;
+    bool terminate;
+    bool failed;
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::thread thread;
+};
+
+
+void cInterface::paceInit (bool synchronized)
 {
-    cTimeval sleepTime (t);
-    sleepTime.sub (lastSentPacket);
+    this->synchronized = synchronized;
 
+    if (synchronized)
+    {
+        uint64_t latency = pacer.init (catchUp);
+        Console::PrintMostVerbose ("Wakeup latency of system timer is %" PRIu64 " nsec. Below that value we do busy waiting.\n", latency);
+    }
+}
+
+/*
+ * Wait until send time t of the next packet is reached. t is relative to the first packet,
+ * thus the time needed for sending is not accumulated.
+ * Returns false, if the packet shall not be sent, because it's too late.
+ */
+bool cInterface::pace (const cTimeval& t)
+{
     if (firstPacket)
     {
+        struct timespec ts;
+        clock_gettime (CLOCK_REALTIME, &ts);
+        scheduleStart = (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+
         firstPacket = false;
         tStart = std::chrono::high_resolution_clock::now();
     }
-
-    if (!sleepTime.isNull())
+    else if (t == lastSendTime)
     {
-        tcppump::Sleep (sleepTime);
-        lastSentPacket.add(sleepTime);
+        // same send time as previous packet (e.g. high rates), no need to wait again
+        return lastPaceResult;
     }
 
-    struct sockaddr_ll device;
+    lastSendTime   = t;
+    lastPaceResult = !synchronized || pacer.wait (t.ns ());
 
-    memset (&device, 0, sizeof(device));
+    return lastPaceResult;
+}
 
-    device.sll_ifindex = ifIndex;
-    device.sll_family  = AF_PACKET;
-    device.sll_halen   = htons (sizeof (myMac));
-    memcpy (device.sll_addr, &myMac, sizeof (myMac));
+void cInterface::paceFinish (void)
+{
+    if (!synchronized)
+        return;
 
-    errno = 0;
-    if (sendto (ifcHandle, payload, length, 0, (struct sockaddr *) &device, sizeof (device)) != (ssize_t)length)
+    if (pacer.getLatePackets ())
     {
-        Console::PrintError ("error: %s\n", strerror (errno));
+        Console::PrintVerbose ("%" PRIu64 " packets were late (max. %" PRIu64 " usec)",
+                pacer.getLatePackets (), pacer.getMaxLateness () / 1000);
+        if (pacer.getSkippedPackets ())
+            Console::PrintVerbose (", %" PRIu64 " of them were skipped", pacer.getSkippedPackets ());
+        Console::PrintVerbose ("\n");
+    }
+    pacer.restoreTimerSlack ();
+    synchronized = false;
+}
+
+bool cInterface::sendPacket (const uint8_t* payload, size_t length, const cTimeval& t, const txOffload& offload)
+{
+    // in realtime mode, pending packets are sent before waiting for a later send time
+    if (synchronized && queueActive && t != lastSendTime && !queueIov.empty () && !sendQueueSubmit ())
         return false;
+
+    if (!pace (t))
+        return true;
+
+    if (timestamps)
+        timestamps->add (scheduleStart + t.ns () + (launchActive ? launchLead : 0));
+
+    // the virtio header is placed in front of the frame by the send functions, the frame isn't copied for it
+    vnet_hdr_t hdr;
+    const uint8_t* vnetHdr = nullptr;
+    if (vnetHdrLen)
+    {
+        setVnetHdr (hdr, offload);
+        vnetHdr = (const uint8_t*)&hdr;
+    }
+
+    // statistics count super-frames as the frames they are split into
+    size_t segLength, lastLength;
+    const size_t segments = offload.segments (length, segLength, lastLength);
+    const size_t bytes    = (segments - 1) * segLength + lastLength;
+
+    if (launchActive)
+    {
+        if (!launchTimeSend (vnetHdr, payload, length, t))
+            return false;
+    }
+    else if (!workers.empty ())
+    {
+        // batches are distributed round robin over all workers
+        if (!workers[currWorker]->add (vnetHdr, payload, length, segments, bytes))
+            return false;
+        if (++workerPackets >= txBatch)
+        {
+            workerPackets = 0;
+            currWorker    = (currWorker + 1) % workers.size ();
+        }
+        // statistics are updated by the workers
+        return true;
+    }
+    else if (ring && vnetHdrLen + length <= ringFrameSize - TX_RING_DATA_OFFSET)
+    {
+        if (!txRingSend (vnetHdr, payload, length))
+            return false;
+    }
+    else if (queueActive)
+    {
+        if (!sendQueueAdd (vnetHdr, payload, length, segments, bytes))
+            return false;
+    }
+    else
+    {
+        // packet doesn't fit into a ring frame; drain the ring first to keep the packet order
+        if (ring && !txRingKick (true))
+            return false;
+
+        struct iovec iov[2];
+        struct msghdr msg;
+        memset (&msg, 0, sizeof (msg));
+        msg.msg_name    = &device;
+        msg.msg_namelen = sizeof (device);
+        msg.msg_iov     = iov;
+        msg.msg_iovlen  = frameIov (iov, vnetHdr, vnetHdrLen, payload, length);
+
+        errno = 0;
+        if (sendmsg (ifcHandle, &msg, 0) != (ssize_t)(length + (vnetHdr ? vnetHdrLen : 0)))
+        {
+            Console::PrintError ("error: %s\n", strerror (errno));
+            return false;
+        }
     }
     // update statistics
-    sentPackets++;
-    sentBytes += (uint64_t)length;
+    sentPackets += segments;
+    sentBytes   += (uint64_t)bytes;
 
     Console::PrintDebug ("sent %zu bytes\n", length);
 
     return true;
 }
 
+/*
+ * Fills the virtio header of a frame with its offload information.
+ * The header fields are in host byte order (legacy virtio).
+ */
+void cInterface::setVnetHdr (vnet_hdr_t& hdr, const txOffload& offload)
+{
+    memset (&hdr, 0, sizeof (hdr));
+    hdr.gsoType = VNET_HDR_GSO_NONE;
+    if (offload.needsChecksum ())
+    {
+        hdr.flags      = VNET_HDR_F_NEEDS_CSUM;
+        hdr.csumStart  = offload.csumStart;
+        hdr.csumOffset = offload.csumOffset;
+        // the checksum field must be within the linear part
+        hdr.hdrLen     = (uint16_t)(offload.csumStart + offload.csumOffset + 2);
+    }
+    if (offload.isSuperFrame ())
+    {
+        static const uint8_t gsoTypes[] = {VNET_HDR_GSO_NONE, VNET_HDR_GSO_TCPV4, VNET_HDR_GSO_TCPV6, VNET_HDR_GSO_UDP};
+        BUG_ON (offload.gsoType >= sizeof (gsoTypes));
+        hdr.gsoType = gsoTypes[offload.gsoType];
+        hdr.gsoSize = offload.gsoSize;
+    }
+}
+
+
 bool cInterface::flushSendQueue (void)
 {
-    // STUB
+    bool success = true;
+
+    paceFinish ();
+
+    if (!workers.empty ())
+    {
+        success = workersStop ();
+    }
+    else if (queueActive)
+    {
+        success = sendQueueSubmit ();
+        sendQueueClose ();
+    }
+    else if (ring)
+    {
+        // wait until the kernel has sent all frames of the ring
+        success = txRingKick (true);
+        txRingClose ();
+    }
+
+    if (droppedPackets)
+    {
+        Console::PrintError ("Warning: %" PRIu64 " packets were dropped, because the send queue was full.\n", droppedPackets);
+        droppedPackets = 0;
+    }
+
+    // wait until all launch times have passed, to get all deadline misses
+    if (launchActive)
+        launchTimeDrain (true);
+
+    if (timestamps)
+    {
+        timestamps->finish ();
+        launchMissed  += timestamps->getLaunchMissed ();
+        launchInvalid += timestamps->getLaunchInvalid ();
+        delete timestamps;
+        timestamps = nullptr;
+    }
+
+    if (launchActive)
+    {
+        if (launchMissed || launchInvalid)
+            Console::PrintVerbose ("%" PRIu64 " packets missed their launch time, %" PRIu64 " packets had an invalid launch time\n",
+                    launchMissed, launchInvalid);
+        launchActive = false;
+    }
+
+    return success;
+}
+
+
+bool cInterface::txRingOpen (size_t packetCnt)
+{
+    BUG_ON (ring);
+
+    // the ring needs its own socket, because as soon as a socket has a tx ring, all packets must be sent via the ring
+    errno = 0;
+    if ((ringHandle = socket (PF_PACKET, SOCK_RAW, 0)) < 0)
+    {
+        Console::PrintDebug ("tx-ring: %s\n", strerror (errno));
+        return false;
+    }
+
+    // each frame holds the tpacket header and an ethernet frame with max. size (incl. two vlan tags)
+    size_t frameLen = TX_RING_DATA_OFFSET + vnetHdrLen + (mtu ? mtu : ETHERMTU) + sizeof (struct ether_header) + 8;
+    ringFrameSize   = TPACKET_ALIGNMENT;
+    while (ringFrameSize < frameLen)
+        ringFrameSize <<= 1;
+
+    // blocks must be a multiple of the page size; as both are powers of 2, frames never cross block boundaries
+    size_t blockSize = (size_t)sysconf (_SC_PAGESIZE);
+    if (blockSize < ringFrameSize)
+        blockSize = ringFrameSize;
+    size_t framesPerBlock = blockSize / ringFrameSize;
+
+    size_t frames = packetCnt && packetCnt < TX_RING_MAX_FRAMES ? packetCnt : TX_RING_MAX_FRAMES;
+    if (frames > TX_RING_MAX_SIZE / ringFrameSize)
+        frames = TX_RING_MAX_SIZE / ringFrameSize;
+    if (!frames)
+        frames = 1;
+
+    struct tpacket_req req;
+    req.tp_block_size = (unsigned)blockSize;
+    req.tp_block_nr   = (unsigned)((frames + framesPerBlock - 1) / framesPerBlock);
+    req.tp_frame_size = (unsigned)ringFrameSize;
+    req.tp_frame_nr   = req.tp_block_nr * (unsigned)framesPerBlock;
+
+    int version = TPACKET_V2;
+    int sndbuf  = (int)(req.tp_block_nr * blockSize);
+
+    struct sockaddr_ll addr;
+    memset (&addr, 0, sizeof(addr));
+    addr.sll_family  = AF_PACKET;
+    addr.sll_ifindex = ifIndex;
+
+    errno = 0;
+    if ((vnetHdrLen && !enableVnetHdr (ringHandle)) ||
+        setsockopt (ringHandle, SOL_PACKET, PACKET_VERSION, &version, sizeof (version)) < 0 ||
+        setsockopt (ringHandle, SOL_PACKET, PACKET_TX_RING, &req, sizeof (req)) < 0 ||
+        bind (ringHandle, (struct sockaddr *) &addr, sizeof (addr)) < 0)
+    {
+        Console::PrintDebug ("tx-ring: %s\n", strerror (errno));
+        txRingClose ();
+        return false;
+    }
+    // avoid stalls of the kernel because of socket buffer exhaustion; the kernel may limit this to wmem_max
+    setsockopt (ringHandle, SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof (sndbuf));
+    if (qdiscBypass)
+        enableQdiscBypass (ringHandle);
+
+    size_t size = (size_t)req.tp_block_nr * blockSize;
+    void* p = mmap (NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, ringHandle, 0);
+    if (p == MAP_FAILED)
+    {
+        Console::PrintDebug ("tx-ring: %s\n", strerror (errno));
+        txRingClose ();
+        return false;
+    }
+
+    ring         = (uint8_t*)p;
+    ringSize     = size;
+    ringFrameNr  = req.tp_frame_nr;
+    ringFrameIdx = 0;
+    ringPending  = 0;
+
+    return true;
+}
+
+
+// the frame is copied into the ring, directly behind its virtio header (vnetHdr may be NULL)
+bool cInterface::txRingSend (const uint8_t* vnetHdr, const uint8_t* payload, size_t length)
+{
+    struct tpacket2_hdr* hdr = (struct tpacket2_hdr*)(ring + ringFrameIdx * ringFrameSize);
+
+    // frame still owned by the kernel -> ring is full; wait until the kernel has sent the pending frames
+    while (__atomic_load_n (&hdr->tp_status, __ATOMIC_ACQUIRE) != TP_STATUS_AVAILABLE)
+    {
+        if (!txRingKick (true))
+            return false;
+    }
+
+    uint8_t* frame = (uint8_t*)hdr + TX_RING_DATA_OFFSET;
+    if (vnetHdr)
+    {
+        memcpy (frame, vnetHdr, vnetHdrLen);
+        frame  += vnetHdrLen;
+    }
+    memcpy (frame, payload, length);
+    hdr->tp_len = (uint32_t)(frame - ((uint8_t*)hdr + TX_RING_DATA_OFFSET) + length);
+    __atomic_store_n (&hdr->tp_status, TP_STATUS_SEND_REQUEST, __ATOMIC_RELEASE);
+
+    ringFrameIdx = (ringFrameIdx + 1) % ringFrameNr;
+
+    // hand over a batch of frames with a single syscall, at the latest when half of the ring is filled
+    if (++ringPending >= txBatch || ringPending >= ringFrameNr / 2)
+        return txRingKick (false);
+
+    return true;
+}
+
+
+// wait = true: block until all frames are sent by the kernel
+bool cInterface::txRingKick (bool wait)
+{
+    if (!ringPending && !wait)
+        return true;
+
+    errno = 0;
+    if (send (ringHandle, NULL, 0, wait ? 0 : MSG_DONTWAIT) < 0)
+    {
+        // the non-blocking kick may stop at socket buffer exhaustion; the remaining frames are sent with the next kick
+        if (errno != EINTR && (wait || (errno != EAGAIN && errno != ENOBUFS)))
+        {
+            Console::PrintError ("error: %s\n", strerror (errno));
+            return false;
+        }
+    }
+    ringPending = 0;
+
+    return true;
+}
+
+
+void cInterface::sendQueueOpen (void)
+{
+    queueMsgs.resize (txBatch);
+    queueIov.reserve (txBatch);
+    queueStats.reserve (txBatch);
+    queueBuffer.reserve (txBatch * ((mtu ? mtu : ETHERMTU) + sizeof (struct ether_header)));
+    queueActive = true;
+}
+
+
+bool cInterface::sendQueueAdd (const uint8_t* vnetHdr, const uint8_t* payload, size_t length,
+        size_t segments, size_t bytes)
+{
+    struct iovec iov;
+
+    // frames are copied, because the caller may reuse its packet buffer immediately.
+    // iov_base is set in sendQueueSubmit, as the buffer may be reallocated until then
+    iov.iov_base = nullptr;
+    iov.iov_len  = length;
+    if (vnetHdr)
+    {
+        iov.iov_len += vnetHdrLen;
+        queueBuffer.insert (queueBuffer.end(), vnetHdr, vnetHdr + vnetHdrLen);
+    }
+    queueIov.push_back (iov);
+    queueStats.push_back ({segments, bytes});
+    queueBuffer.insert (queueBuffer.end(), payload, payload + length);
+
+    if (queueIov.size () >= txBatch)
+        return sendQueueSubmit ();
+
+    return true;
+}
+
+
+bool cInterface::sendQueueSubmit (void)
+{
+    queueDropped.clear ();
+    if (!sendFrames (ifcHandle, &device, queueBuffer.data (), queueIov, queueMsgs, queueDropped))
+        return false;
+
+    // the statistic was already updated, when the frames were added
+    for (size_t n : queueDropped)
+    {
+        sentPackets    -= queueStats[n].packets;
+        sentBytes      -= queueStats[n].bytes;
+        droppedPackets += queueStats[n].packets;
+    }
+    queueIov.clear ();
+    queueBuffer.clear ();
+    queueStats.clear ();
+
+    return true;
+}
+
+
+void cInterface::sendQueueClose (void)
+{
+    queueIov.clear ();
+    queueBuffer.clear ();
+    queueStats.clear ();
+    queueActive = false;
+}
+
+
+bool cInterface::launchTimeOpen (void)
+{
+#if HAVE_SO_TXTIME
+    struct sock_txtime txtime;
+
+    // launch times are CLOCK_TAI, as required by the etf qdisc
+    memset (&txtime, 0, sizeof (txtime));
+    txtime.clockid = CLOCK_TAI;
+    txtime.flags   = SOF_TXTIME_REPORT_ERRORS;
+
+    errno = 0;
+    if (setsockopt (ifcHandle, SOL_SOCKET, SO_TXTIME, &txtime, sizeof (txtime)) < 0)
+    {
+        Console::PrintError ("Could not enable launch time (SO_TXTIME). %s.\n", strerror(errno));
+        return false;
+    }
+
+    // dropped packets are reported via error queue, which is limited by the receive buffer
+    int rcvbuf = 1024 * 1024;
+    setsockopt (ifcHandle, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof (rcvbuf));
+
+    launchActive  = true;
+    launchStart   = 0;
+    launchPending = 0;
+    launchMissed  = 0;
+    launchInvalid = 0;
+
+    Console::PrintMostVerbose ("Packets are handed over %" PRIu64 " usec before their launch time\n", launchLead / 1000);
+
+    return true;
+#else
+    Console::PrintError ("Launch time (SO_TXTIME) is not supported\n");
+    return false;
+#endif
+}
+
+
+bool cInterface::launchTimeSend (const uint8_t* vnetHdr, const uint8_t* payload, size_t length, const cTimeval& t)
+{
+#if HAVE_SO_TXTIME
+    union
+    {
+        char buf[CMSG_SPACE (sizeof (uint64_t))];
+        struct cmsghdr align;
+    } control;
+    struct msghdr msg;
+    struct iovec iov[2];
+
+    // packets are handed over by the pacer exactly launchLead before their launch time
+    if (!launchStart)
+    {
+        struct timespec ts;
+        clock_gettime (CLOCK_TAI, &ts);
+        launchStart = (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec - t.ns () + launchLead;
+    }
+    launchLast = launchStart + t.ns ();
+
+    memset (&msg, 0, sizeof (msg));
+    msg.msg_name       = &device;
+    msg.msg_namelen    = sizeof (device);
+    msg.msg_iov        = iov;
+    msg.msg_iovlen     = frameIov (iov, vnetHdr, vnetHdrLen, payload, length);
+    msg.msg_control    = control.buf;
+    msg.msg_controllen = sizeof (control.buf);
+
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR (&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type  = SCM_TXTIME;
+    cmsg->cmsg_len   = CMSG_LEN (sizeof (uint64_t));
+    memcpy (CMSG_DATA (cmsg), &launchLast, sizeof (uint64_t));
+
+    errno = 0;
+    if (sendmsg (ifcHandle, &msg, 0) != (ssize_t)(length + (vnetHdr ? vnetHdrLen : 0)))
+    {
+        Console::PrintError ("error: %s\n", strerror (errno));
+        return false;
+    }
+
+    if (++launchPending >= txBatch)
+        launchTimeDrain (false);
+
     return true;
+#else
+    (void)vnetHdr; (void)payload; (void)length; (void)t;
+    return false;
+#endif
+}
+
+
+// read deadline misses and invalid launch times from error queue
+void cInterface::launchTimeDrain (bool wait)
+{
+#if HAVE_SO_TXTIME
+    if (wait && launchLast)
+    {
+        // the etf qdisc reports misses at the latest at the launch time
+        uint64_t t = launchLast + 1000000;
+        struct timespec ts;
+        ts.tv_sec  = (time_t)(t / 1000000000ULL);
+        ts.tv_nsec = (long)(t % 1000000000ULL);
+        while (clock_nanosleep (CLOCK_TAI, TIMER_ABSTIME, &ts, NULL) == EINTR && !cSignal::sigintSignalled ())
+            ;
+    }
+
+    // the error queue is read by the timestamp thread
+    if (timestamps)
+        return;
+
+    while (1)
+    {
+        char control[256];
+        char data[64];
+        struct iovec iov;
+        struct msghdr msg;
+
+        iov.iov_base = data;
+        iov.iov_len  = sizeof (data);
+        memset (&msg, 0, sizeof (msg));
+        msg.msg_iov        = &iov;
+        msg.msg_iovlen     = 1;
+        msg.msg_control    = control;
+        msg.msg_controllen = sizeof (control);
+
+        if (recvmsg (ifcHandle, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0)
+            break;
+
+        for (struct cmsghdr* cmsg = CMSG_FIRSTHDR (&msg); cmsg; cmsg = CMSG_NXTHDR (&msg, cmsg))
+        {
+            if (cmsg->cmsg_level != SOL_PACKET || cmsg->cmsg_type != PACKET_TX_TIMESTAMP)
+                continue;
+
+            struct sock_extended_err serr;
+            memcpy (&serr, CMSG_DATA (cmsg), sizeof (serr));
+            if (serr.ee_origin != SO_EE_ORIGIN_TXTIME)
+                continue;
+
+            if (serr.ee_code == SO_EE_CODE_TXTIME_MISSED)
+                launchMissed++;
+            else
+                launchInvalid++;
+        }
+    }
+    launchPending = 0;
+#else
+    (void)wait;
+#endif
+}
+
+
+bool cInterface::workersStart (void)
+{
+    int numaNode = getNumaNode ();
+    std::vector<int> cpus = getCpus (numaNode);
+    size_t maxFrameSize = vnetHdrLen + (mtu ? mtu : ETHERMTU) + sizeof (struct ether_header) + 8;
+
+    if (cpus.empty ())
+        return false;
+
+    for (unsigned n = 0; n < txThreads; n++)
+    {
+        cTxWorker* w = new cTxWorker (ifIndex, cpus[n % cpus.size ()], qdiscBypass, vnetHdrLen, txBatch, maxFrameSize);
+        workers.push_back (w);
+        if (!w->start ())
+        {
+            workersStop ();
+            return false;
+        }
+    }
+    currWorker    = 0;
+    workerPackets = 0;
+
+    Console::PrintMostVerbose ("Using %u tx threads on numa node %d\n", txThreads, numaNode);
+
+    return true;
+}
+
+
+bool cInterface::workersStop (void)
+{
+    bool success = true;
+
+    for (auto w : workers)
+    {
+        success &= w->finish ();
+
+        // merge statistic of all threads
+        sentPackets    += w->sentPackets;
+        sentBytes      += w->sentBytes;
+        droppedPackets += w->droppedPackets;
+        Console::PrintMoreVerbose ("tx thread on cpu %d sent %" PRIu64 " packets\n", w->cpu, w->sentPackets);
+
+        delete w;
+    }
+    workers.clear ();
+
+    return success;
+}
+
+
+/*
+ * Returns the cpus of numa node, on which we may run. If numaNode is unknown (-1),
+ * all cpus of our affinity mask are returned.
+ */
+std::vector<int> cInterface::getCpus (int numaNode)
+{
+    std::vector<int> all, local;
+    cpu_set_t set;
+
+    CPU_ZERO (&set);
+    if (sched_getaffinity (0, sizeof (set), &set) < 0)
+        return all;
+
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+    {
+        if (CPU_ISSET (cpu, &set))
+            all.push_back (cpu);
+    }
+
+    if (numaNode < 0)
+        return all;
+
+    // format of cpulist is like "0-3,8,10-11"
+    char path[64];
+    char s[256] = {0};
+    std::snprintf (path, sizeof (path), "/sys/devices/system/node/node%d/cpulist", numaNode);
+    FILE* fp = std::fopen (path, "r");
+    if (!fp)
+        return all;
+    size_t len = std::fread (s, 1, sizeof(s) - 1, fp);
+    std::fclose (fp);
+    s[len] = '\0';
+
+    for (char* p = s; *p && *p != '\n'; )
+    {
+        char* end;
+        long first = std::strtol (p, &end, 10);
+        long last  = first;
+        if (end == p)
+            break;
+        if (*end == '-')
+        {
+            p = end + 1;
+            last = std::strtol (p, &end, 10);
+        }
+        for (long cpu = first; cpu <= last && cpu < CPU_SETSIZE; cpu++)
+        {
+            if (CPU_ISSET (cpu, &set))
+                local.push_back ((int)cpu);
+        }
+        p = *end == ',' ? end + 1 : end;
+    }
+
+    return local.empty () ? all : local;
+}
+
+
+void cInterface::txRingClose (void)
+{
+    if (ring)
+        munmap (ring, ringSize);
+    if (ringHandle >= 0)
+        ::close (ringHandle);
+
+    ringHandle    = -1;
+    ring          = nullptr;
+    ringSize      = 0;
+    ringFrameNr   = 0;
+    ringFrameIdx  = 0;
+    ringPending   = 0;
 }
 
 
@@ -368,6 +1447,28 @@ uint32_t cInterface::getMTU (void)
 }
 
 
+// returns the numa node of the network adapter or -1 if unknown
+int cInterface::getNumaNode (void)
+{
+    std::string path ("/sys/class/net/");
+    char s[32] = {0};
+
+    path += name + "/device/numa_node";
+
+    FILE* fp = std::fopen (path.c_str(), "r");
+    if (!fp)
+        return -1;
+
+    int node = -1;
+    if (std::fread (s, 1, sizeof(s) - 1, fp))
+        node = (int)std::strtol (s, NULL, 10);
+
+    std::fclose (fp);
+
+    return node;
+}
+
+
 uint64_t cInterface::getLinkSpeed (void)
 {
     if (!linkSpeed)
@@ -386,9 +1487,12 @@ uint64_t cInterface::getLinkSpeed (void)
             return 0;
         }
 
+        // speed is -1 or not readable, if the link is down or the driver doesn't report it
         if (std::fread (s, 1, sizeof(s) - 1, fp))
         {
-            linkSpeed = (uint64_t)std::strtoul(s, NULL, 10) * (uint64_t)1000000;
+            long speed = std::strtol (s, NULL, 10);
+            if (speed > 0)
+                linkSpeed = (uint64_t)speed * (uint64_t)1000000;
         }
 
         std::fclose (fp);
@@ -1,7 +1,7 @@
 // SPDX-License-Identifier: GPL-3.0-only
 /*
  * TCPPUMP <https://github.com/amartin755/tcppump>
- * Copyright (C) 2012-2021 Andreas Martin (netnag@mailbox.org)
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -24,22 +24,37 @@
 #include <cstdint>
 #include <cstddef>
 #include <chrono>
+#include <vector>
+#include <sys/socket.h>
+#include <linux/if_packet.h>
 
 #include "ipaddress.hpp"
 #include "macaddress.hpp"
 #include "timeval.hpp"
 #include "netinterface.hpp"
+#include "pacer.hpp"
+#include "txtimestamps.hpp"
 
+// forward declarations
+class cTxWorker;
+struct vnet_hdr_t;
+
+// frames on the wire of a queued frame, for the statistic
+struct txFrameStat
+{
+    size_t packets;
+    size_t bytes;
+};
 
 
 class cInterface : public cNetInterface
 {
 public:
-    cInterface(const char* ifname, bool needPriviledges);
+    cInterface(const char* ifname, bool needPriviledges, const txOptions& opt);
     virtual ~cInterface();
     bool open ();
     bool close ();
-    bool sendPacket (const uint8_t* payload, size_t length, const cTimeval& t);
+    bool sendPacket (const uint8_t* payload, size_t length, const cTimeval& t, const txOffload& offload);
     bool prepareSendQueue (size_t packetCnt, size_t totalBytes, bool synchronized);
     bool flushSendQueue (void);
     void getSendStatistic (uint64_t& sentPackets, uint64_t& sentBytes, double& duration) const;
@@ -48,25 +63,105 @@ public:
     bool getIPv6 (cIPv6&);
     uint32_t getMTU (void);
     uint64_t getLinkSpeed (void);
+    int getNumaNode (void);
     bool isOpen () const;
     const char* getName (void) const;
     bool isReady (void) const;
 
-private:
+protected:
+    void paceInit (bool synchronized);
+    bool pace (const cTimeval& t);
+    void paceFinish (void);
+
     std::string name;
-    int ifcHandle;
     int ifIndex;
-    cMacAddress myMac;
-    cIPv4 myIP;
-    cIPv6 myIPv6;
     uint32_t mtu;
-    uint64_t linkSpeed;
-    cTimeval lastSentPacket;
 
+    // number of packets that are handed over to the kernel with one syscall
+    size_t txBatch;
+
+    bool synchronized;
     bool firstPacket;
+    cTimeval lastSendTime;
+    bool lastPaceResult;
+    uint64_t scheduleStart; // CLOCK_REALTIME of first packet
     std::chrono::high_resolution_clock::time_point tStart;
     uint64_t sentPackets;
     uint64_t sentBytes;
+    uint64_t droppedPackets;    // queue was full
+
+private:
+    bool txRingOpen (size_t packetCnt);
+    bool txRingSend (const uint8_t* vnetHdr, const uint8_t* payload, size_t length);
+    bool txRingKick (bool wait);
+    void txRingClose (void);
+    void sendQueueOpen (void);
+    bool sendQueueAdd (const uint8_t* vnetHdr, const uint8_t* payload, size_t length,
+            size_t segments, size_t bytes);
+    bool sendQueueSubmit (void);
+    void sendQueueClose (void);
+    bool workersStart (void);
+    bool workersStop (void);
+    static std::vector<int> getCpus (int numaNode);
+    bool launchTimeOpen (void);
+    bool launchTimeSend (const uint8_t* vnetHdr, const uint8_t* payload, size_t length, const cTimeval& t);
+    void launchTimeDrain (bool wait);
+    static void setVnetHdr (vnet_hdr_t& hdr, const txOffload& offload);
+
+    int ifcHandle;
+    cMacAddress myMac;
+    cIPv4 myIP;
+    cIPv6 myIPv6;
+    uint64_t linkSpeed;
+    struct sockaddr_ll device;
+
+    // PACKET_MMAP tx ring, only used in max. throughput mode
+    bool noTxRing;
+    int ringHandle;
+    uint8_t* ring;
+    size_t ringSize;
+    size_t ringFrameSize;
+    size_t ringFrameNr;
+    size_t ringFrameIdx;
+    size_t ringPending;
+
+    // sendmmsg based send queue, used in max. throughput mode if tx ring is not available and
+    // in realtime mode for packets with the same send time
+    bool queueActive;
+    std::vector<struct mmsghdr> queueMsgs;
+    std::vector<struct iovec> queueIov;
+    std::vector<uint8_t> queueBuffer;
+    std::vector<txFrameStat> queueStats;
+    std::vector<size_t> queueDropped;
+
+    // absolute deadline pacing in realtime mode
+    cPacer pacer;
+    txOptions::catchUpPolicy catchUp;
+
+    // launch time of each packet is passed to the kernel (SO_TXTIME), only used in realtime mode
+    bool launchTime;
+    bool launchActive;
+    uint64_t launchLead;    // ns
+    uint64_t launchStart;   // CLOCK_TAI of first packet
+    uint64_t launchLast;    // launch time of last packet
+    size_t launchPending;   // packets sent since error queue was read
+    uint64_t launchMissed;
+    uint64_t launchInvalid;
+
+    // kernel tx timestamps, only used in realtime mode
+    bool txTimestamps;
+    const char* tsCsvFile;
+    cTxTimestamps* timestamps;
+
+    // parallel transmission by multiple threads, each with its own socket
+    unsigned txThreads;
+    bool qdiscBypass;
+    std::vector<cTxWorker*> workers;
+    size_t currWorker;
+    size_t workerPackets;   // number of packets added to current worker
+
+    // checksum offload, frames are prefixed by a virtio_net_hdr (PACKET_VNET_HDR) on all sockets
+    size_t vnetHdrLen;      // 0 if disabled
 };
 
 #endif /* INTERFACE_H_ */
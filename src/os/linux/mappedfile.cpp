@@ -0,0 +1,102 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ * TCPPUMP <https://github.com/amartin755/tcppump>
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "mappedfile.hpp"
+
+
+cMappedFile::cMappedFile () : m_data (nullptr), m_size (0), m_open (false)
+{
+}
+
+
+cMappedFile::~cMappedFile ()
+{
+    close ();
+}
+
+
+bool cMappedFile::open (const char* file, bool copyOnWrite)
+{
+    close ();
+
+    int fd = ::open (file, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat (fd, &st) || !S_ISREG (st.st_mode))
+    {
+        ::close (fd);
+        return false;
+    }
+
+    // mapping an empty file is not possible, but it is still a valid file
+    if (st.st_size > 0)
+    {
+        void* p = mmap (nullptr, (size_t)st.st_size, copyOnWrite ? PROT_READ | PROT_WRITE : PROT_READ,
+                MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED)
+        {
+            ::close (fd);
+            return false;
+        }
+        m_data = (uint8_t*)p;
+        m_size = (size_t)st.st_size;
+    }
+
+    // the mapping remains valid after closing the file
+    ::close (fd);
+    m_open = true;
+    return true;
+}
+
+
+void cMappedFile::close (void)
+{
+    if (m_data)
+        munmap (m_data, m_size);
+
+    m_data = nullptr;
+    m_size = 0;
+    m_open = false;
+}
+
+
+void cMappedFile::sequential (void)
+{
+    if (m_data)
+        madvise (m_data, m_size, MADV_SEQUENTIAL);
+}
+
+
+void cMappedFile::willNeed (size_t offset, size_t length)
+{
+    if (offset >= m_size)
+        return;
+    if (length > m_size - offset)
+        length = m_size - offset;
+
+    // madvise requires a page aligned address
+    const size_t aligned = offset & ~((size_t)sysconf (_SC_PAGESIZE) - 1);
+    madvise (m_data + aligned, length + offset - aligned, MADV_WILLNEED);
+}
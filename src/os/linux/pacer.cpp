@@ -0,0 +1,231 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ * TCPPUMP <https://github.com/amartin755/tcppump>
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+#include <cerrno>
+#include <sys/prctl.h>
+
+#include "pacer.hpp"
+#include "signal.hpp"
+#include "bug.hpp"
+
+#ifdef WITH_UNITTESTS
+#include "console.hpp"
+#endif
+
+// limits of adaptive spin window
+static const uint64_t MIN_SPIN_NS = 2000;
+static const uint64_t MAX_SPIN_NS = 2000000;
+// if we are more than this behind schedule, the catch-up policy is applied
+static const uint64_t CATCH_UP_THRESHOLD_NS = 1000000;
+static const uint64_t NS_PER_SEC = 1000000000;
+
+
+cPacer::cPacer ()
+{
+    policy         = cNetInterface::txOptions::CATCHUP_BURST;
+    started        = false;
+    base           = 0;
+    spinNs         = MAX_SPIN_NS;
+    latencyAvg     = MAX_SPIN_NS / 2;
+    oldSlack       = -1;
+    latePackets    = 0;
+    skippedPackets = 0;
+    maxLateness    = 0;
+}
+
+cPacer::~cPacer ()
+{
+    restoreTimerSlack ();
+}
+
+uint64_t cPacer::now (void)
+{
+    struct timespec ts;
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * NS_PER_SEC + (uint64_t)ts.tv_nsec;
+}
+
+uint64_t cPacer::init (catchUpPolicy policy)
+{
+    const int LOOPS = 100;
+    uint64_t total  = 0;
+
+    this->policy   = policy;
+    started        = false;
+    latePackets    = 0;
+    skippedPackets = 0;
+    maxLateness    = 0;
+
+    // the default timer slack of 50us would delay every wakeup
+    if (oldSlack < 0)
+    {
+        oldSlack = prctl (PR_GET_TIMERSLACK, 0, 0, 0, 0);
+        prctl (PR_SET_TIMERSLACK, 1, 0, 0, 0);
+    }
+
+    // measure wakeup latency of clock_nanosleep
+    for (int n = 0; n < LOOPS; n++)
+    {
+        uint64_t t = now () + 10000;
+        struct timespec ts;
+        ts.tv_sec  = (time_t)(t / NS_PER_SEC);
+        ts.tv_nsec = (long)(t % NS_PER_SEC);
+        clock_nanosleep (CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+
+        uint64_t latency = now () - t;
+        total += latency;
+    }
+    latencyAvg = total / LOOPS;
+    adapt (latencyAvg);
+
+    return latencyAvg;
+}
+
+void cPacer::restoreTimerSlack (void)
+{
+    if (oldSlack >= 0)
+        prctl (PR_SET_TIMERSLACK, (unsigned long)oldSlack, 0, 0, 0);
+    oldSlack = -1;
+}
+
+// spin window is twice the average wakeup latency, but spikes are considered immediately
+void cPacer::adapt (uint64_t latency)
+{
+    latencyAvg = (7 * latencyAvg + latency) / 8;
+    spinNs     = 2 * (latency > spinNs ? latency : latencyAvg);
+
+    if (spinNs < MIN_SPIN_NS)
+        spinNs = MIN_SPIN_NS;
+    else if (spinNs > MAX_SPIN_NS)
+        spinNs = MAX_SPIN_NS;
+}
+
+bool cPacer::wait (uint64_t offsetNs)
+{
+    uint64_t t = now ();
+
+    if (!started)
+    {
+        started = true;
+        base    = t;
+    }
+
+    uint64_t deadline = base + offsetNs;
+
+    // we are behind schedule
+    if (t > deadline)
+    {
+        uint64_t lateness = t - deadline;
+
+        latePackets++;
+        if (lateness > maxLateness)
+            maxLateness = lateness;
+
+        if (lateness > CATCH_UP_THRESHOLD_NS)
+        {
+            switch (policy)
+            {
+            case cNetInterface::txOptions::CATCHUP_SKIP:
+                // drop packets until we are on schedule again
+                skippedPackets++;
+                return false;
+            case cNetInterface::txOptions::CATCHUP_REBASE:
+                // shift the schedule of all following packets
+                base += lateness;
+                break;
+            case cNetInterface::txOptions::CATCHUP_BURST:
+                // send all delayed packets as fast as possible
+                break;
+            }
+        }
+        return true;
+    }
+
+    if (deadline - t > spinNs)
+    {
+        uint64_t wakeup = deadline - spinNs;
+        struct timespec ts;
+        ts.tv_sec  = (time_t)(wakeup / NS_PER_SEC);
+        ts.tv_nsec = (long)(wakeup % NS_PER_SEC);
+
+        while (clock_nanosleep (CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+        {
+            if (cSignal::sigintSignalled ())
+                return false;
+        }
+        t = now ();
+        adapt (t > wakeup ? t - wakeup : 0);
+    }
+
+    while (t < deadline)
+        t = now ();
+
+    return true;
+}
+
+
+#ifdef WITH_UNITTESTS
+
+void cPacer::unitTest (void)
+{
+    cPacer pacer;
+    uint64_t latency = pacer.init (cNetInterface::txOptions::CATCHUP_BURST);
+    ::Console::PrintDebug ("pacer wakeup latency %" PRIu64 " ns\n", latency);
+
+    // deadlines are never missed on the early side and don't drift
+    uint64_t late = 0;
+    for (uint64_t n = 0; n < 200; n++)
+    {
+        uint64_t offset = n * 100000;
+        BUG_IF_NOT (pacer.wait (offset));
+        uint64_t t = now ();
+        BUG_IF_NOT (t >= pacer.base + offset);
+        late += t - (pacer.base + offset);
+    }
+    ::Console::PrintDebug ("pacer average deviation %" PRIu64 " ns\n", late / 200);
+
+    // skip packets, if we are too late
+    struct timespec delay;
+    delay.tv_sec  = 0;
+    delay.tv_nsec = 5000000;
+    cPacer skip;
+    skip.init (cNetInterface::txOptions::CATCHUP_SKIP);
+    BUG_IF_NOT (skip.wait (0));
+    nanosleep (&delay, NULL);
+    BUG_IF_NOT (!skip.wait (1000));
+    BUG_IF_NOT (skip.getSkippedPackets () == 1);
+    BUG_IF_NOT (skip.getLatePackets () == 1);
+
+    // shift schedule, if we are too late
+    cPacer rebase;
+    rebase.init (cNetInterface::txOptions::CATCHUP_REBASE);
+    BUG_IF_NOT (rebase.wait (0));
+    uint64_t start = rebase.base;
+    nanosleep (&delay, NULL);
+    BUG_IF_NOT (rebase.wait (1000));
+    BUG_IF_NOT (rebase.base >= start + 5000000 - 1000);
+    BUG_IF_NOT (rebase.wait (2000000));
+    BUG_IF_NOT (now () >= rebase.base + 2000000);
+    BUG_IF_NOT (rebase.getSkippedPackets () == 0);
+}
+
+#endif
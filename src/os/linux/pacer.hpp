@@ -0,0 +1,73 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ * TCPPUMP <https://github.com/amartin755/tcppump>
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PACER_HPP_
+#define PACER_HPP_
+
+#include <cstdint>
+#include <ctime>
+
+#include "netinterface.hpp"
+
+/*
+ * Schedules each packet against an absolute deadline on CLOCK_MONOTONIC, thus time
+ * spent for sending and oversleeping is not accumulated over the sequence.
+ * The thread sleeps via clock_nanosleep(TIMER_ABSTIME) until the deadline minus a spin
+ * window and busy waits for the rest. The spin window adapts to the observed wakeup latency.
+ */
+class cPacer
+{
+public:
+    typedef cNetInterface::txOptions::catchUpPolicy catchUpPolicy;
+
+    cPacer ();
+    ~cPacer ();
+
+    // returns the measured wakeup latency in ns
+    uint64_t init (catchUpPolicy policy);
+    void restoreTimerSlack (void);
+
+    // wait until deadline; offset is relative to the first call
+    // returns false, if the packet shall be skipped, because we are too late
+    bool wait (uint64_t offsetNs);
+
+    uint64_t getLatePackets (void) const {return latePackets;}
+    uint64_t getSkippedPackets (void) const {return skippedPackets;}
+    uint64_t getMaxLateness (void) const {return maxLateness;}
+
+#ifdef WITH_UNITTESTS
+    static void unitTest (void);
+#endif
+
+private:
+    static uint64_t now (void);
+    void adapt (uint64_t latency);
+
+    catchUpPolicy policy;
+    bool started;
+    uint64_t base;          // absolute time of offset 0
+    uint64_t spinNs;        // busy waiting time before deadline
+    uint64_t latencyAvg;    // moving average of wakeup latency
+    long oldSlack;          // timer slack before init
+    uint64_t latePackets;
+    uint64_t skippedPackets;
+    uint64_t maxLateness;
+};
+
+#endif /* PACER_HPP_ */
@@ -0,0 +1,127 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ * TCPPUMP <https://github.com/amartin755/tcppump>
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cerrno>
+#include <sched.h>
+#include <pthread.h>
+#include <malloc.h>
+#include <sys/mman.h>
+
+#include "realtime.hpp"
+#include "console.hpp"
+
+namespace tcppump
+{
+
+static const size_t STACK_PREFAULT = 256 * 1024;
+
+
+int RealtimeDefaultCpu (void)
+{
+    // format of the list is like "2-3,6"
+    FILE* fp = std::fopen ("/sys/devices/system/cpu/isolated", "r");
+    if (fp)
+    {
+        char s[256] = {0};
+        size_t len = std::fread (s, 1, sizeof(s) - 1, fp);
+        std::fclose (fp);
+
+        char* end;
+        long cpu = std::strtol (s, &end, 10);
+        if (len && end != s && cpu >= 0 && cpu < CPU_SETSIZE)
+            return (int)cpu;
+    }
+
+    cpu_set_t set;
+    CPU_ZERO (&set);
+    if (sched_getaffinity (0, sizeof (set), &set) == 0)
+    {
+        for (int cpu = CPU_SETSIZE - 1; cpu >= 0; cpu--)
+        {
+            if (CPU_ISSET (cpu, &set))
+                return cpu;
+        }
+    }
+    return 0;
+}
+
+bool RealtimeLockMemory (void)
+{
+    // freed memory must not be returned to the system, otherwise it would page fault on reuse
+    mallopt (M_TRIM_THRESHOLD, -1);
+    mallopt (M_MMAP_MAX, 0);
+
+    errno = 0;
+    if (mlockall (MCL_CURRENT | MCL_FUTURE) < 0)
+    {
+        if (errno == EPERM || errno == ENOMEM)
+            Console::PrintError ("Could not lock memory. %s. "
+                    "Capability CAP_IPC_LOCK or a higher memlock limit (ulimit -l) is required.\n", strerror(errno));
+        else
+            Console::PrintError ("Could not lock memory. %s.\n", strerror(errno));
+        return false;
+    }
+
+    return true;
+}
+
+bool RealtimeEnter (int cpu, int priority)
+{
+    bool success = true;
+    cpu_set_t set;
+
+    CPU_ZERO (&set);
+    CPU_SET (cpu, &set);
+    int err = pthread_setaffinity_np (pthread_self (), sizeof (set), &set);
+    if (err)
+    {
+        Console::PrintError ("Could not pin sender thread to cpu %d. %s.\n", cpu, strerror(err));
+        success = false;
+    }
+
+    struct sched_param param;
+    memset (&param, 0, sizeof (param));
+    param.sched_priority = priority;
+    err = pthread_setschedparam (pthread_self (), SCHED_FIFO, &param);
+    if (err)
+    {
+        if (err == EPERM)
+            Console::PrintError ("Could not set SCHED_FIFO priority %d. %s. "
+                    "Capability CAP_SYS_NICE or a realtime priority limit (ulimit -r) is required.\n", priority, strerror(err));
+        else
+            Console::PrintError ("Could not set SCHED_FIFO priority %d. %s.\n", priority, strerror(err));
+        success = false;
+    }
+
+    return success;
+}
+
+void RealtimePrefaultStack (void)
+{
+    volatile uint8_t stack[STACK_PREFAULT];
+
+    for (size_t n = 0; n < sizeof (stack); n += 4096)
+        stack[n] = 0;
+}
+
+}
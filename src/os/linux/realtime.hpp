@@ -0,0 +1,38 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ * TCPPUMP <https://github.com/amartin755/tcppump>
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef REALTIME_HPP_
+#define REALTIME_HPP_
+
+namespace tcppump
+{
+    // priority of the realtime sender thread (SCHED_FIFO)
+    const int REALTIME_PRIORITY = 80;
+
+    // first isolated cpu, otherwise the last cpu we may run on
+    extern int RealtimeDefaultCpu (void);
+    // lock all current and future memory of the process
+    extern bool RealtimeLockMemory (void);
+    // pin the calling thread to cpu and set its scheduling policy to SCHED_FIFO
+    extern bool RealtimeEnter (int cpu, int priority);
+    // touch the stack of the calling thread, so that it won't page fault later
+    extern void RealtimePrefaultStack (void);
+}
+
+#endif /* REALTIME_HPP_ */
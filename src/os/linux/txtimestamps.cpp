@@ -0,0 +1,393 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ * TCPPUMP <https://github.com/amartin755/tcppump>
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <chrono>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <linux/if_packet.h>
+#include <linux/errqueue.h>
+#include <linux/net_tstamp.h>
+
+#include "txtimestamps.hpp"
+#include "console.hpp"
+#include "bug.hpp"
+
+
+cTxTimestamps::cTxTimestamps ()
+{
+    handle        = -1;
+    csv           = nullptr;
+    next          = 0;
+    pending       = 0;
+    lost          = 0;
+    launchMissed  = 0;
+    launchInvalid = 0;
+    terminate     = false;
+}
+
+cTxTimestamps::~cTxTimestamps ()
+{
+    finish ();
+}
+
+bool cTxTimestamps::start (int handle, const char* csvFile)
+{
+    int flags = SOF_TIMESTAMPING_TX_SOFTWARE | SOF_TIMESTAMPING_TX_SCHED | SOF_TIMESTAMPING_SOFTWARE |
+                SOF_TIMESTAMPING_OPT_ID | SOF_TIMESTAMPING_OPT_TSONLY;
+
+    errno = 0;
+    if (setsockopt (handle, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof (flags)) < 0)
+    {
+        Console::PrintError ("Could not enable tx timestamps (SO_TIMESTAMPING). %s.\n", strerror(errno));
+        return false;
+    }
+
+    // timestamps are queued to the error queue, which is limited by the receive buffer
+    int rcvbuf = 4 * 1024 * 1024;
+    setsockopt (handle, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof (rcvbuf));
+
+    if (csvFile)
+    {
+        errno = 0;
+        if ((csv = std::fopen (csvFile, "w")) == nullptr)
+        {
+            Console::PrintError ("Could not open %s. %s.\n", csvFile, strerror(errno));
+            return false;
+        }
+        std::fprintf (csv, "packet,scheduled,qdisc,driver,deviation\n");
+    }
+
+    // allocated once, add() is called in the realtime path
+    ring.assign (RING_SIZE, cRecord ());
+    this->handle = handle;
+    next      = 0;
+    pending   = 0;
+    lost      = 0;
+    qdisc     = cDeviation ();
+    driver    = cDeviation ();
+    terminate = false;
+    thread    = std::thread (&cTxTimestamps::run, this);
+
+    return true;
+}
+
+void cTxTimestamps::add (uint64_t scheduledNs)
+{
+    std::lock_guard<std::mutex> lock (mutex);
+
+    cRecord& r = ring[next & (RING_SIZE - 1)];
+    if (r.used)
+    {
+        // timestamps of this packet are overdue, give up
+        lost++;
+        pending--;
+    }
+    r.packet    = next++;
+    r.scheduled = scheduledNs;
+    r.sched     = 0;
+    r.sent      = 0;
+    r.used      = true;
+    pending++;
+}
+
+void cTxTimestamps::finish (void)
+{
+    if (!thread.joinable ())
+        return;
+
+    {
+        // give the kernel some time for the outstanding timestamps
+        std::unique_lock<std::mutex> lock (mutex);
+        while (pending)
+        {
+            size_t last = pending;
+            if (!cond.wait_for (lock, std::chrono::seconds (1), [this, last]{return pending != last;}))
+                break;
+        }
+        terminate = true;
+    }
+    thread.join ();
+
+    // packets with incomplete timestamps, in the order they were sent
+    for (uint64_t n = next > RING_SIZE ? next - RING_SIZE : 0; n < next; n++)
+    {
+        const cRecord& r = ring[n & (RING_SIZE - 1)];
+        if (r.used && r.packet == n)
+            complete (r);
+    }
+
+    if (pending + lost)
+        Console::PrintVerbose ("Warning: No tx timestamps received for %zu packets\n", pending + lost);
+    qdisc.report ("qdisc");
+    driver.report ("driver");
+
+    if (csv)
+    {
+        std::fclose (csv);
+        csv = nullptr;
+    }
+    ring.clear ();
+}
+
+void cTxTimestamps::run (void)
+{
+    struct pollfd pfd;
+
+    pfd.fd     = handle;
+    pfd.events = 0;     // POLLERR is always reported
+
+    while (1)
+    {
+        {
+            std::lock_guard<std::mutex> lock (mutex);
+            if (terminate)
+                break;
+        }
+        pfd.revents = 0;
+        if (poll (&pfd, 1, 100) > 0)
+        {
+            while (receive ())
+                ;
+        }
+    }
+    while (receive ())
+        ;
+}
+
+// read one message from error queue; returns false if queue is empty
+bool cTxTimestamps::receive (void)
+{
+    char control[512];
+    struct iovec iov;
+    struct msghdr msg;
+    char data[64];
+
+    iov.iov_base = data;
+    iov.iov_len  = sizeof (data);
+    memset (&msg, 0, sizeof (msg));
+    msg.msg_iov        = &iov;
+    msg.msg_iovlen     = 1;
+    msg.msg_control    = control;
+    msg.msg_controllen = sizeof (control);
+
+    if (recvmsg (handle, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0)
+        return false;
+
+    uint64_t ts = 0;
+    struct sock_extended_err serr;
+    bool haveErr = false;
+
+    for (struct cmsghdr* cmsg = CMSG_FIRSTHDR (&msg); cmsg; cmsg = CMSG_NXTHDR (&msg, cmsg))
+    {
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_TIMESTAMPING)
+        {
+            struct scm_timestamping tss;
+            memcpy (&tss, CMSG_DATA (cmsg), sizeof (tss));
+            ts = (uint64_t)tss.ts[0].tv_sec * 1000000000ULL + (uint64_t)tss.ts[0].tv_nsec;
+        }
+        else if (cmsg->cmsg_level == SOL_PACKET && cmsg->cmsg_type == PACKET_TX_TIMESTAMP)
+        {
+            memcpy (&serr, CMSG_DATA (cmsg), sizeof (serr));
+            haveErr = true;
+        }
+    }
+    if (!haveErr)
+        return true;
+
+    std::unique_lock<std::mutex> lock (mutex);
+
+#ifdef SO_EE_ORIGIN_TXTIME
+    if (serr.ee_origin == SO_EE_ORIGIN_TXTIME)
+    {
+        if (serr.ee_code == SO_EE_CODE_TXTIME_MISSED)
+            launchMissed++;
+        else
+            launchInvalid++;
+        return true;
+    }
+#endif
+
+    if (serr.ee_origin != SO_EE_ORIGIN_TIMESTAMPING || !ts)
+        return true;
+
+    // ee_data is the 32 bit packet counter of the socket; the slot may already be reused by a newer packet
+    cRecord& r = ring[serr.ee_data & (RING_SIZE - 1)];
+    if (!r.used || (uint32_t)r.packet != serr.ee_data)
+        return true;
+
+    if (serr.ee_info == SCM_TSTAMP_SCHED)
+    {
+        r.sched = ts;
+    }
+    else if (serr.ee_info == SCM_TSTAMP_SND)
+    {
+        cRecord done = r;
+        r.used = false;
+        pending--;
+        cond.notify_all ();
+        lock.unlock ();
+
+        done.sent = ts;
+        complete (done);
+    }
+
+    return true;
+}
+
+// fold the timestamps of a packet into the statistic; called by the receive thread or after it was joined
+void cTxTimestamps::complete (const cRecord& r)
+{
+    if (r.sched)
+        qdisc.add ((int64_t)(r.sched - r.scheduled));
+    if (r.sent)
+        driver.add ((int64_t)(r.sent - r.scheduled));
+
+    if (csv)
+    {
+        std::fprintf (csv, "%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",", r.packet, r.scheduled, r.sched, r.sent);
+        if (r.sent)
+            std::fprintf (csv, "%" PRId64 "\n", (int64_t)(r.sent - r.scheduled));
+        else
+            std::fprintf (csv, "\n");
+    }
+}
+
+
+cTxTimestamps::cDeviation::cDeviation ()
+: negative (BUCKETS), positive (BUCKETS)
+{
+    count = 0;
+    sum   = 0.0;
+    min   = INT64_MAX;
+    max   = INT64_MIN;
+}
+
+// values below SUB_BUCKETS are exact, above each power of 2 is divided into SUB_BUCKETS buckets
+size_t cTxTimestamps::cDeviation::bucket (uint64_t v)
+{
+    if (v < SUB_BUCKETS)
+        return (size_t)v;
+
+    unsigned exp = 63 - (unsigned)__builtin_clzll (v);
+    return SUB_BUCKETS * (exp - SUB_BITS + 1) + (size_t)((v >> (exp - SUB_BITS)) & (SUB_BUCKETS - 1));
+}
+
+// center of bucket b
+uint64_t cTxTimestamps::cDeviation::value (size_t b)
+{
+    if (b < SUB_BUCKETS)
+        return b;
+
+    unsigned shift = (unsigned)(b / SUB_BUCKETS - 1);
+    uint64_t low   = (uint64_t)(SUB_BUCKETS + b % SUB_BUCKETS) << shift;
+    return low + (((uint64_t)1 << shift) >> 1);
+}
+
+void cTxTimestamps::cDeviation::add (int64_t ns)
+{
+    if (ns < 0)
+        negative[bucket ((uint64_t)-(ns + 1) + 1)]++;
+    else
+        positive[bucket ((uint64_t)ns)]++;
+
+    count++;
+    sum += (double)ns;
+    min = std::min (min, ns);
+    max = std::max (max, ns);
+}
+
+int64_t cTxTimestamps::cDeviation::percentile (unsigned permille) const
+{
+    uint64_t k = (count * permille) / 1000;
+
+    // the center of a bucket may be beyond the extreme values
+    auto clamp = [this](int64_t v){return std::max (min, std::min (max, v));};
+
+    for (size_t b = BUCKETS; b-- > 0; )
+    {
+        if (k < negative[b])
+            return clamp (-(int64_t)value (b));
+        k -= negative[b];
+    }
+    for (size_t b = 0; b < BUCKETS; b++)
+    {
+        if (k < positive[b])
+            return clamp ((int64_t)value (b));
+        k -= positive[b];
+    }
+    return max;
+}
+
+void cTxTimestamps::cDeviation::report (const char* what) const
+{
+    if (!count)
+        return;
+
+    Console::PrintVerbose ("Deviation from schedule at %s (%" PRIu64 " packets): "
+            "mean %.3f, min %.3f, 50%% %.3f, 99%% %.3f, 99.9%% %.3f, max %.3f usec\n",
+            what, count, sum / (double)count / 1000.0,
+            (double)min / 1000.0,
+            (double)percentile (500) / 1000.0,
+            (double)percentile (990) / 1000.0,
+            (double)percentile (999) / 1000.0,
+            (double)max / 1000.0);
+}
+
+
+#ifdef WITH_UNITTESTS
+
+void cTxTimestamps::unitTest (void)
+{
+    // bucket bounds are monotonic and the error is below 1/16
+    for (uint64_t v = 1; v < 100000000; v = v * 3 + 1)
+    {
+        size_t b = cDeviation::bucket (v);
+        BUG_IF_NOT (b < cDeviation::BUCKETS);
+        BUG_IF_NOT (cDeviation::bucket (v + 1) >= b);
+        uint64_t c = cDeviation::value (b);
+        BUG_IF_NOT ((c > v ? c - v : v - c) * 16 <= v);
+    }
+    BUG_IF_NOT (cDeviation::bucket (UINT64_MAX) == cDeviation::BUCKETS - 1);
+
+    // -1000 ... 98999 ns
+    cDeviation d;
+    for (int64_t n = 0; n < 100000; n++)
+        d.add (n - 1000);
+    BUG_IF_NOT (d.count == 100000);
+    BUG_IF_NOT (d.min == -1000 && d.max == 98999);
+    BUG_IF_NOT (d.percentile (0) == -1000);
+    BUG_IF_NOT (d.percentile (1000) == 98999);
+    int64_t p50 = d.percentile (500);
+    BUG_IF_NOT (p50 >= 49000 - 49000 / 16 && p50 <= 49000 + 49000 / 16);
+    int64_t p5 = d.percentile (5);
+    BUG_IF_NOT (p5 >= -500 - 500 / 16 && p5 <= -500 + 500 / 16);
+    int64_t p999 = d.percentile (999);
+    BUG_IF_NOT (p999 >= 98899 - 98899 / 16 && p999 <= 98999);
+
+    cDeviation empty;
+    BUG_IF_NOT (empty.count == 0);
+}
+
+#endif
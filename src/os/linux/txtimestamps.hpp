@@ -0,0 +1,118 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ * TCPPUMP <https://github.com/amartin755/tcppump>
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TXTIMESTAMPS_HPP_
+#define TXTIMESTAMPS_HPP_
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+/*
+ * Collects the transmit timestamps of the kernel (SO_TIMESTAMPING) and compares them
+ * with the scheduled send time of each packet. The error queue of the socket is read by a
+ * separate thread. Timestamps are matched to their packets via the per socket packet
+ * counter (SOF_TIMESTAMPING_OPT_ID). Only the packets in flight are kept; completed packets
+ * are folded into the statistic and written to the CSV file immediately.
+ */
+class cTxTimestamps
+{
+public:
+    cTxTimestamps ();
+    ~cTxTimestamps ();
+
+    bool start (int handle, const char* csvFile);
+    // announce the scheduled time (CLOCK_REALTIME) of the next packet sent via handle
+    void add (uint64_t scheduledNs);
+    // wait for outstanding timestamps, stop the thread and print the report
+    void finish (void);
+
+    // errors reported by SO_TXTIME, which share the error queue
+    uint64_t getLaunchMissed (void) const {return launchMissed;}
+    uint64_t getLaunchInvalid (void) const {return launchInvalid;}
+
+#ifdef WITH_UNITTESTS
+    static void unitTest (void);
+#endif
+
+private:
+    // packets in flight; the size is a power of 2, so the index wraps together with the 32 bit packet counter
+    static const size_t RING_SIZE = 65536;
+
+    struct cRecord
+    {
+        uint64_t packet;    // sequence number
+        uint64_t scheduled;
+        uint64_t sched;     // packet entered the qdisc
+        uint64_t sent;      // packet was passed to the driver
+        bool used;
+    };
+
+    // deviation from schedule; percentiles are taken from a log-linear histogram (max. error 1/16)
+    class cDeviation
+    {
+    public:
+        cDeviation ();
+        void add (int64_t ns);
+        int64_t percentile (unsigned permille) const;
+        void report (const char* what) const;
+
+    private:
+        static const unsigned SUB_BITS = 4;
+        static const size_t SUB_BUCKETS = 1 << SUB_BITS;
+        static const size_t BUCKETS = SUB_BUCKETS * (64 - SUB_BITS + 1);
+
+        static size_t bucket (uint64_t v);
+        static uint64_t value (size_t b);
+
+        friend class cTxTimestamps;
+
+        std::vector<uint64_t> negative;
+        std::vector<uint64_t> positive;
+        uint64_t count;
+        double sum;
+        int64_t min;
+        int64_t max;
+    };
+
+    void run (void);
+    bool receive (void);
+    void complete (const cRecord& r);
+
+    int handle;
+    FILE* csv;
+    std::vector<cRecord> ring;
+    uint64_t next;          // sequence number of the next packet
+    size_t pending;         // number of packets without complete timestamps
+    size_t lost;            // packets, which were overwritten in the ring before their timestamps arrived
+    cDeviation qdisc;       // only accessed by the receive thread, until it is joined
+    cDeviation driver;
+    uint64_t launchMissed;
+    uint64_t launchInvalid;
+    bool terminate;
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::thread thread;
+};
+
+#endif /* TXTIMESTAMPS_HPP_ */
@@ -0,0 +1,422 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ * TCPPUMP <https://github.com/amartin755/tcppump>
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <cstring>
+#include <errno.h>
+
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/mman.h>
+#include <net/ethernet.h>
+
+#include "xdpinterface.hpp"
+
+#include "bug.hpp"
+#include "console.hpp"
+
+#ifndef AF_XDP
+#define AF_XDP 44
+#endif
+#ifndef SOL_XDP
+#define SOL_XDP 283
+#endif
+
+// number of entries of tx and completion ring, must be a power of 2
+static const uint32_t XSK_RING_SIZE = 2048;
+// max. number of packets of a repeated sequence, which are kept in umem
+static const size_t XSK_MAX_CACHED_FRAMES = 65536;
+// max. time in ms we wait for the kernel to complete pending frames
+static const int XSK_TIMEOUT = 1000;
+
+
+cXdpInterface::cXdpInterface (const char* ifname, bool needPriviledges, const txOptions& opt)
+: cInterface (ifname, needPriviledges, opt)
+{
+    mode         = opt.xsk;
+    xskHandle    = -1;
+    umem         = nullptr;
+    umemSize     = 0;
+    frameSize    = 0;
+    seqCnt       = 0;
+    seqIdx       = 0;
+    seqCached    = false;
+    rotateIdx    = 0;
+    unsubmitted  = 0;
+    produced     = 0;
+    completed    = 0;
+    memset (&tx, 0, sizeof (tx));
+    memset (&cq, 0, sizeof (cq));
+}
+
+cXdpInterface::~cXdpInterface ()
+{
+    teardown ();
+}
+
+bool cXdpInterface::open ()
+{
+    if (!cInterface::open ())
+        return false;
+
+    // check early if AF_XDP is supported at all
+    errno = 0;
+    if ((xskHandle = socket (AF_XDP, SOCK_RAW, 0)) < 0)
+    {
+        Console::PrintError ("Unable to open AF_XDP socket. %s.\n", strerror(errno));
+        close ();
+        return false;
+    }
+
+    return true;
+}
+
+bool cXdpInterface::close ()
+{
+    teardown ();
+    return cInterface::close ();
+}
+
+// packetCnt = 0 means endless loop
+bool cXdpInterface::prepareSendQueue (__attribute__((unused)) size_t packetCnt,
+        __attribute__((unused)) size_t totalBytes, bool synchronized)
+{
+    paceInit (synchronized);
+
+    seqCnt    = 0;
+    seqCached = false;
+    seqFilled.clear ();
+
+    return true;
+}
+
+void cXdpInterface::prepareRepetition (size_t packetCnt)
+{
+    // the umem layout is fixed as soon as the first packet was sent
+    if (umem)
+        return;
+
+    seqCnt    = packetCnt;
+    seqIdx    = 0;
+    seqCached = packetCnt && packetCnt <= XSK_MAX_CACHED_FRAMES;
+    seqFilled.assign (seqCached ? packetCnt : 0, false);
+}
+
+bool cXdpInterface::sendPacket (const uint8_t* payload, size_t length, const cTimeval& t, const txOffload& offload)
+{
+    // there is no offload in AF_XDP copy mode; checksums are always complete
+    BUG_ON (offload.needsChecksum ());
+
+    // the position within a cached sequence advances for skipped packets as well
+    size_t slot = seqIdx;
+    if (seqCached && ++seqIdx >= seqCnt)
+        seqIdx = 0;
+
+    if (!pace (t))
+        return true;
+
+    if (!umem && !setup ())
+        return false;
+
+    if (length > frameSize)
+    {
+        Console::PrintError ("error: Packet size %zu exceeds AF_XDP frame size %zu\n", length, frameSize);
+        return false;
+    }
+
+    // all frames of the umem are in use; wait until the oldest one is sent
+    if (produced - completed >= XSK_RING_SIZE && !waitForCompletion (produced - XSK_RING_SIZE + 1))
+        return false;
+
+    uint64_t addr;
+    if (seqCached)
+    {
+        // the frames of the sequence are located at the beginning of the umem and are only copied,
+        // when they are sent the first time (packets may be skipped by the pacer)
+        addr = slot * frameSize;
+        if (!seqFilled[slot])
+        {
+            memcpy (umem + addr, payload, length);
+            seqFilled[slot] = true;
+        }
+    }
+    else
+    {
+        // completions are in order, so the umem frames are used as ring
+        addr = rotateIdx * frameSize;
+        memcpy (umem + addr, payload, length);
+        rotateIdx = (rotateIdx + 1) & (XSK_RING_SIZE - 1);
+    }
+
+    struct xdp_desc* desc = (struct xdp_desc*)tx.descs + (tx.cachedProd & tx.mask);
+    desc->addr    = addr;
+    desc->len     = (uint32_t)length;
+    desc->options = 0;
+    tx.cachedProd++;
+    produced++;
+    unsubmitted++;
+
+    if (synchronized || unsubmitted >= txBatch)
+    {
+        submit ();
+        if (!kick ())
+            return false;
+        complete ();
+    }
+
+    // update statistics
+    sentPackets++;
+    sentBytes += (uint64_t)length;
+
+    Console::PrintDebug ("sent %zu bytes\n", length);
+
+    return true;
+}
+
+bool cXdpInterface::flushSendQueue (void)
+{
+    paceFinish ();
+
+    if (!umem)
+        return true;
+
+    bool success = waitForCompletion (produced);
+
+    struct xdp_statistics stats;
+    socklen_t optlen = sizeof (stats);
+    if (!getsockopt (xskHandle, SOL_XDP, XDP_STATISTICS, &stats, &optlen) && stats.tx_invalid_descs)
+        Console::PrintError ("Warning: %llu packets were rejected by the kernel\n", (unsigned long long)stats.tx_invalid_descs);
+
+    // the umem belongs to the socket, thus a new queue needs a new socket
+    teardown ();
+    errno = 0;
+    if ((xskHandle = socket (AF_XDP, SOCK_RAW, 0)) < 0)
+        Console::PrintDebug ("xsk: %s\n", strerror (errno));
+
+    return success;
+}
+
+bool cXdpInterface::setup (void)
+{
+    BUG_ON (umem);
+
+    if (xskHandle < 0)
+        return false;
+
+    // the chunk size of the umem must be a power of 2 between 2048 and the page size
+    size_t frameLen = (mtu ? mtu : ETHERMTU) + sizeof (struct ether_header) + 8;
+    frameSize = frameLen <= 2048 ? 2048 : 4096;
+
+    // umem holds either all frames of a repeated sequence or one frame per tx ring entry
+    umemSize = (seqCached ? seqCnt : XSK_RING_SIZE) * frameSize;
+    void* p = mmap (NULL, umemSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED)
+    {
+        Console::PrintError ("Unable to allocate AF_XDP umem. %s.\n", strerror(errno));
+        umemSize = 0;
+        return false;
+    }
+    umem = (uint8_t*)p;
+
+    struct xdp_umem_reg reg;
+    memset (&reg, 0, sizeof (reg));
+    reg.addr       = (uint64_t)(uintptr_t)umem;
+    reg.len        = umemSize;
+    reg.chunk_size = (uint32_t)frameSize;
+    reg.headroom   = 0;
+
+    // the fill ring is never used, but the kernel insists on it
+    int ringSize = (int)XSK_RING_SIZE;
+    struct xdp_mmap_offsets off;
+    socklen_t optlen = sizeof (off);
+
+    errno = 0;
+    if (setsockopt (xskHandle, SOL_XDP, XDP_UMEM_REG, &reg, sizeof (reg)) < 0 ||
+        setsockopt (xskHandle, SOL_XDP, XDP_UMEM_FILL_RING, &ringSize, sizeof (ringSize)) < 0 ||
+        setsockopt (xskHandle, SOL_XDP, XDP_UMEM_COMPLETION_RING, &ringSize, sizeof (ringSize)) < 0 ||
+        setsockopt (xskHandle, SOL_XDP, XDP_TX_RING, &ringSize, sizeof (ringSize)) < 0 ||
+        getsockopt (xskHandle, SOL_XDP, XDP_MMAP_OFFSETS, &off, &optlen) < 0)
+    {
+        Console::PrintError ("Unable to set up AF_XDP socket. %s.\n", strerror(errno));
+        teardown ();
+        return false;
+    }
+
+    if (!mapRing (tx, off.tx, sizeof (struct xdp_desc), XDP_PGOFF_TX_RING) ||
+        !mapRing (cq, off.cr, sizeof (uint64_t), XDP_UMEM_PGOFF_COMPLETION_RING))
+    {
+        Console::PrintError ("Unable to map AF_XDP rings. %s.\n", strerror(errno));
+        teardown ();
+        return false;
+    }
+
+    struct sockaddr_xdp addr;
+    memset (&addr, 0, sizeof (addr));
+    addr.sxdp_family   = AF_XDP;
+    addr.sxdp_ifindex  = (uint32_t)ifIndex;
+    addr.sxdp_queue_id = 0;
+    addr.sxdp_flags    = XDP_USE_NEED_WAKEUP;
+    if (mode == txOptions::XSK_COPY)
+        addr.sxdp_flags |= XDP_COPY;
+    else if (mode == txOptions::XSK_ZEROCOPY)
+        addr.sxdp_flags |= XDP_ZEROCOPY;
+
+    errno = 0;
+    if (bind (xskHandle, (struct sockaddr *) &addr, sizeof (addr)) < 0)
+    {
+        if (mode == txOptions::XSK_ZEROCOPY)
+            Console::PrintError ("Unable to bind AF_XDP socket in zero-copy mode to %s. %s.\n", name.c_str(), strerror(errno));
+        else
+            Console::PrintError ("Unable to bind AF_XDP socket to %s. %s.\n", name.c_str(), strerror(errno));
+        teardown ();
+        return false;
+    }
+
+    struct xdp_options opts;
+    optlen = sizeof (opts);
+    memset (&opts, 0, sizeof (opts));
+    getsockopt (xskHandle, SOL_XDP, XDP_OPTIONS, &opts, &optlen);
+    Console::PrintMostVerbose ("Using AF_XDP socket in %s mode with %zu cached packets\n",
+            opts.flags & XDP_OPTIONS_ZEROCOPY ? "zero-copy" : "copy", seqCached ? seqCnt : 0);
+
+    seqIdx      = 0;
+    rotateIdx   = 0;
+    unsubmitted = 0;
+    produced    = 0;
+    completed   = 0;
+
+    return true;
+}
+
+void cXdpInterface::teardown (void)
+{
+    unmapRing (tx);
+    unmapRing (cq);
+    if (xskHandle >= 0)
+        ::close (xskHandle);
+    if (umem)
+        munmap (umem, umemSize);
+
+    xskHandle = -1;
+    umem      = nullptr;
+    umemSize  = 0;
+}
+
+bool cXdpInterface::mapRing (xskRing& ring, const struct xdp_ring_offset& off, size_t descSize, off_t pgoff)
+{
+    size_t size = off.desc + XSK_RING_SIZE * descSize;
+    void* p = mmap (NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, xskHandle, pgoff);
+    if (p == MAP_FAILED)
+        return false;
+
+    uint8_t* base   = (uint8_t*)p;
+    ring.map        = p;
+    ring.mapSize    = size;
+    ring.producer   = (uint32_t*)(base + off.producer);
+    ring.consumer   = (uint32_t*)(base + off.consumer);
+    ring.flags      = (uint32_t*)(base + off.flags);
+    ring.descs      = base + off.desc;
+    ring.mask       = XSK_RING_SIZE - 1;
+    ring.cachedProd = *ring.producer;
+    ring.cachedCons = *ring.consumer;
+
+    return true;
+}
+
+void cXdpInterface::unmapRing (xskRing& ring)
+{
+    if (ring.map)
+        munmap (ring.map, ring.mapSize);
+    memset (&ring, 0, sizeof (ring));
+}
+
+// make all written descriptors visible to the kernel
+void cXdpInterface::submit (void)
+{
+    if (unsubmitted)
+    {
+        __atomic_store_n (tx.producer, tx.cachedProd, __ATOMIC_RELEASE);
+        unsubmitted = 0;
+    }
+}
+
+// in copy mode the kernel only sends packets within a syscall
+bool cXdpInterface::kick (void)
+{
+    if (!(__atomic_load_n (tx.flags, __ATOMIC_ACQUIRE) & XDP_RING_NEED_WAKEUP))
+        return true;
+
+    errno = 0;
+    if (sendto (xskHandle, NULL, 0, MSG_DONTWAIT, NULL, 0) < 0)
+    {
+        if (errno != EAGAIN && errno != EBUSY && errno != ENOBUFS && errno != ENETDOWN && errno != EINTR)
+        {
+            Console::PrintError ("error: %s\n", strerror (errno));
+            return false;
+        }
+    }
+    return true;
+}
+
+// consume the completion ring; we don't need the addresses, only the number of sent frames
+void cXdpInterface::complete (void)
+{
+    uint32_t prod = __atomic_load_n (cq.producer, __ATOMIC_ACQUIRE);
+    uint32_t n    = prod - cq.cachedCons;
+
+    if (n)
+    {
+        cq.cachedCons += n;
+        __atomic_store_n (cq.consumer, cq.cachedCons, __ATOMIC_RELEASE);
+        completed += n;
+    }
+}
+
+// wait until at least target frames are sent by the kernel
+bool cXdpInterface::waitForCompletion (uint64_t target)
+{
+    int idle = 0;
+
+    submit ();
+    while (completed < target)
+    {
+        if (!kick ())
+            return false;
+
+        uint64_t last = completed;
+        complete ();
+        if (completed != last)
+        {
+            idle = 0;
+            continue;
+        }
+
+        if (++idle > XSK_TIMEOUT)
+        {
+            Console::PrintError ("error: Timeout while waiting for AF_XDP transmission\n");
+            return false;
+        }
+        struct pollfd pfd;
+        pfd.fd      = xskHandle;
+        pfd.events  = POLLOUT;
+        pfd.revents = 0;
+        poll (&pfd, 1, 1);
+    }
+    return true;
+}
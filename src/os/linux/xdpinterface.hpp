@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ * TCPPUMP <https://github.com/amartin755/tcppump>
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef XDPINTERFACE_H_
+#define XDPINTERFACE_H_
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <linux/if_xdp.h>
+
+#include "interface.hpp"
+
+
+/*
+ * Transmission via AF_XDP socket (XSK). No XDP program is needed, as we only send.
+ * All frames are copied into the UMEM, which is shared with the kernel. If the packets
+ * are sent repeatedly without modification (see prepareRepetition), the frames of the
+ * first loop stay in the UMEM and further loops only post their descriptors again.
+ * Address and MTU queries are inherited from the packet socket implementation.
+ */
+class cXdpInterface : public cInterface
+{
+public:
+    cXdpInterface (const char* ifname, bool needPriviledges, const txOptions& opt);
+    virtual ~cXdpInterface ();
+    bool open ();
+    bool close ();
+    bool sendPacket (const uint8_t* payload, size_t length, const cTimeval& t, const txOffload& offload);
+    bool prepareSendQueue (size_t packetCnt, size_t totalBytes, bool synchronized);
+    bool flushSendQueue (void);
+    void prepareRepetition (size_t packetCnt);
+
+private:
+    struct xskRing
+    {
+        uint32_t* producer;
+        uint32_t* consumer;
+        uint32_t* flags;
+        void* descs;
+        void* map;
+        size_t mapSize;
+        uint32_t mask;
+        uint32_t cachedProd;
+        uint32_t cachedCons;
+    };
+
+    bool setup (void);
+    void teardown (void);
+    bool mapRing (xskRing& ring, const struct xdp_ring_offset& off, size_t descSize, off_t pgoff);
+    void unmapRing (xskRing& ring);
+    bool waitForCompletion (uint64_t target);
+    bool kick (void);
+    void complete (void);
+    void submit (void);
+
+    txOptions::xskMode mode;
+    int xskHandle;
+
+    uint8_t* umem;
+    size_t umemSize;
+    size_t frameSize;
+    xskRing tx;
+    xskRing cq;
+
+    size_t seqCnt;      // number of packets of a repeated sequence, 0 if packets are not repeated
+    size_t seqIdx;      // index of current packet within sequence
+    bool seqCached;     // true, if all packets of the sequence are stored in umem
+    std::vector<bool> seqFilled;    // umem frame of the sequence packet is already copied
+    size_t rotateIdx;   // next free frame of the umem area for not cached packets
+
+    size_t unsubmitted; // number of descriptors not yet visible to the kernel
+    uint64_t produced;
+    uint64_t completed;
+};
+
+#endif /* XDPINTERFACE_H_ */
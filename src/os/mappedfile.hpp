@@ -0,0 +1,57 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ * TCPPUMP <https://github.com/amartin755/tcppump>
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MAPPEDFILE_HPP_
+#define MAPPEDFILE_HPP_
+
+#include <cstdint>
+#include <cstddef>
+
+/*
+ * Read-only memory mapping of a whole file. With copyOnWrite the content can be modified
+ * in memory, the file itself is never changed.
+ */
+class cMappedFile
+{
+public:
+    cMappedFile ();
+    ~cMappedFile ();
+    cMappedFile (const cMappedFile&) = delete;
+    cMappedFile& operator= (const cMappedFile&) = delete;
+
+    bool open (const char* file, bool copyOnWrite = false);
+    void close (void);
+    uint8_t* data (void) const {return m_data;}
+    size_t size (void) const {return m_size;}
+    bool isOpen (void) const {return m_open;}
+
+    // access pattern hints for the operating system
+    void sequential (void);
+    void willNeed (size_t offset, size_t length);
+
+private:
+    uint8_t* m_data;
+    size_t   m_size;
+    bool     m_open;
+#if HAVE_WINDOWS
+    void*    m_file;
+    void*    m_mapping;
+#endif
+};
+
+#endif /* MAPPEDFILE_HPP_ */
@@ -1,7 +1,7 @@
 // SPDX-License-Identifier: GPL-3.0-only
 /*
  * TCPPUMP <https://github.com/amartin755/tcppump>
- * Copyright (C) 2012-2025 Andreas Martin (netnag@mailbox.org)
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -19,8 +19,20 @@
 
 #include "netinterface.hpp"
 #include "interface.hpp"
+#if HAVE_IF_XDP
+#include "xdpinterface.hpp"
+#endif
 
-cNetInterface* cNetInterface::create(const char* ifname, bool needPriviledges)
+cNetInterface* cNetInterface::create(const char* ifname, bool needPriviledges, const txOptions& opt)
 {
+#if HAVE_WINDOWS
+    (void)opt;
     return new cInterface (ifname, needPriviledges);
+#else
+#if HAVE_IF_XDP
+    if (opt.xsk != txOptions::XSK_NONE)
+        return new cXdpInterface (ifname, needPriviledges, opt);
+#endif
+    return new cInterface (ifname, needPriviledges, opt);
+#endif
 }
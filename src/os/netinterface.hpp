@@ -1,7 +1,7 @@
 // SPDX-License-Identifier: GPL-3.0-only
 /*
  * TCPPUMP <https://github.com/amartin755/tcppump>
- * Copyright (C) 2012-2021 Andreas Martin (netnag@mailbox.org)
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -28,6 +28,7 @@
 #include "ipaddress.hpp"
 #include "macaddress.hpp"
 #include "timeval.hpp"
+#include "txoffload.hpp"
 
 // forward declarations
 typedef struct pcap pcap_t;
@@ -36,18 +37,46 @@ class cNetInterface
 {
 
 public:
-    static cNetInterface* create(const char* ifname, bool needPriviledges);
+    // tuning of the transmit path; backends silently ignore options they don't support
+    struct txOptions
+    {
+        enum xskMode {XSK_NONE, XSK_AUTO, XSK_COPY, XSK_ZEROCOPY};
+        enum catchUpPolicy {CATCHUP_BURST, CATCHUP_SKIP, CATCHUP_REBASE};
+
+        txOptions () : noTxRing (false), txBatch (64), xsk (XSK_NONE), txThreads (1), qdiscBypass (false),
+                       catchUp (CATCHUP_BURST), launchTime (false), launchLead (1000),
+                       txTimestamps (false), tsCsvFile (nullptr), csumOffload (false) {}
+
+        bool noTxRing;          // don't use a memory mapped tx ring
+        size_t txBatch;         // max. number of packets handed over to the kernel at once
+        xskMode xsk;            // send via AF_XDP socket instead of packet socket (linux)
+        unsigned txThreads;     // number of transmit threads
+        bool qdiscBypass;       // bypass the qdisc layer of the kernel (linux)
+        catchUpPolicy catchUp;  // what to do, if we are behind schedule in realtime mode (linux)
+        bool launchTime;        // pass send time as launch time to the kernel (SO_TXTIME, linux)
+        uint64_t launchLead;    // packets are handed over this number of usecs before their launch time
+        bool txTimestamps;      // compare tx timestamps of the kernel with the schedule (linux)
+        const char* tsCsvFile;  // optional per packet dump of tx timestamps
+        bool csumOffload;       // frames may leave their checksum and segmentation to the kernel (PACKET_VNET_HDR, linux)
+    };
+
+    static cNetInterface* create(const char* ifname, bool needPriviledges, const txOptions& opt = txOptions());
     virtual ~cNetInterface () {};
     virtual bool open () = 0;
     virtual bool close () = 0;
-    virtual bool sendPacket (const uint8_t* payload, size_t length, const cTimeval& t) = 0;
+    virtual bool sendPacket (const uint8_t* payload, size_t length, const cTimeval& t, const txOffload& offload) = 0;
     virtual bool prepareSendQueue (size_t packetCnt, size_t totalBytes, bool synchronized) = 0;
     virtual bool flushSendQueue (void) = 0;
+    // Announce that the following packets are a sequence of packetCnt packets, which is repeated without modification.
+    // Backends may keep the frames of the first pass and resend them without copying.
+    virtual void prepareRepetition (size_t packetCnt) {(void)packetCnt;}
     virtual void getSendStatistic (uint64_t& sentPackets, uint64_t& sentBytes, double& duration) const = 0;
     virtual bool getMAC (cMacAddress&) = 0;
     virtual bool getIPv4 (cIPv4&) = 0;
     virtual bool getIPv6 (cIPv6&) = 0;
     virtual uint32_t getMTU (void) = 0;
+    // link speed in bit/s, 0 if unknown
+    virtual uint64_t getLinkSpeed (void) = 0;
     virtual bool isOpen () const = 0;
     virtual const char* getName (void) const = 0;
     virtual bool isReady (void) const = 0;
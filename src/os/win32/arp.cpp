@@ -1,7 +1,7 @@
 // SPDX-License-Identifier: GPL-3.0-only
 /*
  * TCPPUMP <https://github.com/amartin755/tcppump>
- * Copyright (C) 2012-2021 Andreas Martin (netnag@mailbox.org)
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -55,3 +55,21 @@ bool cArp::resolve (const cIPv4& ip, cMacAddress& mac)
 
     return false;
 }
+
+bool cArp::resolve (const std::vector<cIPv4>& hosts, std::map<cIPv4, cMacAddress>& macs)
+{
+    // SendARP consults the neighbour cache first, but it can only resolve one host per call
+    bool resolved = true;
+
+    for (const auto& ip : hosts)
+    {
+        cMacAddress mac;
+
+        if (resolve (ip, mac))
+            macs[ip] = mac;
+        else
+            resolved = false;
+    }
+
+    return resolved;
+}
@@ -1,7 +1,7 @@
 // SPDX-License-Identifier: GPL-3.0-only
 /*
  * TCPPUMP <https://github.com/amartin755/tcppump>
- * Copyright (C) 2012-2025 Andreas Martin (netnag@mailbox.org)
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -360,8 +360,10 @@ bool cInterface::close ()
     return true;
 }
 
-bool cInterface::sendPacket (const uint8_t* payload, size_t length, const cTimeval& t)
+bool cInterface::sendPacket (const uint8_t* payload, size_t length, const cTimeval& t, const txOffload& offload)
 {
+    BUG_ON (offload.needsChecksum ());  // not supported by pcap
+
     if (job) // queued send?
     {
         return job->addPacket (payload, length, t);
@@ -471,6 +473,14 @@ uint32_t cInterface::getMTU (void)
     return (uint32_t)adapterInfo->Mtu;
 }
 
+uint64_t cInterface::getLinkSpeed (void)
+{
+    if (!adapterInfo)
+        return 0;
+
+    return (uint64_t)adapterInfo->TransmitLinkSpeed;
+}
+
 bool cInterface::isOpen () const
 {
     return ifcHandle != NULL;
@@ -1,7 +1,7 @@
 // SPDX-License-Identifier: GPL-3.0-only
 /*
  * TCPPUMP <https://github.com/amartin755/tcppump>
- * Copyright (C) 2012-2021 Andreas Martin (netnag@mailbox.org)
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -42,7 +42,7 @@ public:
     virtual ~cInterface();
     bool open ();
     bool close ();
-    bool sendPacket (const uint8_t* payload, size_t length, const cTimeval& t);
+    bool sendPacket (const uint8_t* payload, size_t length, const cTimeval& t, const txOffload& offload);
     bool prepareSendQueue (size_t packetCnt, size_t totalBytes, bool synchronized);
     bool flushSendQueue (void);
     void getSendStatistic (uint64_t& sentPackets, uint64_t& sentBytes, double& duration) const;
@@ -50,6 +50,7 @@ public:
     bool getIPv4 (cIPv4&);
     bool getIPv6 (cIPv6&);
     uint32_t getMTU (void);
+    uint64_t getLinkSpeed (void);
     bool isOpen () const;
     const char* getName (void) const;
     bool isReady (void) const;
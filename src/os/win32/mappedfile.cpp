@@ -0,0 +1,100 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ * TCPPUMP <https://github.com/amartin755/tcppump>
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <windows.h>
+
+#include "mappedfile.hpp"
+
+
+cMappedFile::cMappedFile ()
+: m_data (nullptr), m_size (0), m_open (false), m_file (INVALID_HANDLE_VALUE), m_mapping (nullptr)
+{
+}
+
+
+cMappedFile::~cMappedFile ()
+{
+    close ();
+}
+
+
+bool cMappedFile::open (const char* file, bool copyOnWrite)
+{
+    close ();
+
+    m_file = ::CreateFileA (file, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    if (!::GetFileSizeEx (m_file, &size))
+    {
+        close ();
+        return false;
+    }
+
+    // mapping an empty file is not possible, but it is still a valid file
+    if (size.QuadPart > 0)
+    {
+        m_mapping = ::CreateFileMappingA (m_file, nullptr, copyOnWrite ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, nullptr);
+        if (!m_mapping)
+        {
+            close ();
+            return false;
+        }
+        m_data = (uint8_t*)::MapViewOfFile (m_mapping, copyOnWrite ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0);
+        if (!m_data)
+        {
+            close ();
+            return false;
+        }
+        m_size = (size_t)size.QuadPart;
+    }
+
+    m_open = true;
+    return true;
+}
+
+
+void cMappedFile::close (void)
+{
+    if (m_data)
+        ::UnmapViewOfFile (m_data);
+    if (m_mapping)
+        ::CloseHandle (m_mapping);
+    if (m_file != INVALID_HANDLE_VALUE)
+        ::CloseHandle (m_file);
+
+    m_data    = nullptr;
+    m_size    = 0;
+    m_open    = false;
+    m_file    = INVALID_HANDLE_VALUE;
+    m_mapping = nullptr;
+}
+
+
+// The cache manager of windows detects sequential access on its own. Explicit prefetching
+// (PrefetchVirtualMemory) is not available on all supported versions.
+void cMappedFile::sequential (void)
+{
+}
+
+
+void cMappedFile::willNeed (size_t, size_t)
+{
+}
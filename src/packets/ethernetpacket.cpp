@@ -1,7 +1,7 @@
 // SPDX-License-Identifier: GPL-3.0-only
 /*
  * TCPPUMP <https://github.com/amartin755/tcppump>
- * Copyright (C) 2012-2025 Andreas Martin (netnag@mailbox.org)
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -59,6 +59,7 @@ cEthernetPacket::cEthernetPacket (cEthernetPacket&& other)
     payloadLength    = other.payloadLength;
     llcHeaderLength  = other.llcHeaderLength;
     hasDMAC          = other.hasDMAC;
+    offload          = other.offload;
 
     other.data             = nullptr;
     other.packet           = nullptr;
@@ -77,6 +78,7 @@ cEthernetPacket::cEthernetPacket (const cEthernetPacket& obj) : cEthernetPacket
     payloadLength    = obj.payloadLength;
     llcHeaderLength  = obj.llcHeaderLength;
     hasDMAC          = obj.hasDMAC;
+    offload          = obj.offload;
 
     // copy packet data
     std::memcpy (packet, obj.packet, obj.getLength());
@@ -107,6 +109,7 @@ cEthernetPacket& cEthernetPacket::operator=(cEthernetPacket&& other)
         payloadLength    = other.payloadLength;
         llcHeaderLength  = other.llcHeaderLength;
         hasDMAC          = other.hasDMAC;
+        offload          = other.offload;
 
         other.data             = nullptr;
         other.packet           = nullptr;
@@ -129,6 +132,7 @@ void cEthernetPacket::reset ()
     payloadLength     = 0;
     llcHeaderLength   = 0;
     hasDMAC           = false;
+    offload           = txOffload ();
     *pEthertypeLength = 0;
 }
 
@@ -305,6 +309,46 @@ void cEthernetPacket::updatePayloadAt (unsigned offset, const void* payload, siz
 }
 
 
+/*
+ * Moves the packet into the arena. The new buffer has exactly the length of the packet,
+ * thus no data can be added afterwards. Modifications in place (e.g. mac addresses) are still possible.
+ */
+void cEthernetPacket::shrinkToFit (cFrameArena& arena)
+{
+    size_t len = getLength ();
+    uint8_t* p = arena.alloc (len);
+    std::memcpy (p, packet, len);
+
+    pPayload         = p + (pPayload - packet);
+    pEthertypeLength = (uint16_t*)(p + ((uint8_t*)pEthertypeLength - packet));
+    packet           = p;
+    packetMaxLength  = len;
+
+    delete[] data;
+    data = nullptr;
+}
+
+
+// enlarge the buffer of the packet (e.g. for super-frames), the content is kept
+void cEthernetPacket::reserve (size_t maxLength)
+{
+    if (maxLength <= packetMaxLength)
+        return;
+
+    uint32_t* d = new uint32_t[(maxLength + sizeof (uint32_t) - 1) / sizeof (uint32_t)];
+    uint8_t*  p = (uint8_t*)d;
+    std::memcpy (p, packet, getLength ());
+
+    pPayload         = p + (pPayload - packet);
+    pEthertypeLength = (uint16_t*)(p + ((uint8_t*)pEthertypeLength - packet));
+    packet           = p;
+    packetMaxLength  = maxLength;
+
+    delete[] data;
+    data = d;
+}
+
+
 #ifdef WITH_UNITTESTS
 #include "console.hpp"
 
@@ -585,5 +629,50 @@ void cEthernetPacket::unitTest ()
         catched = true;
     }
     BUG_IF_NOT (catched);
+
+    // move into arena
+    {
+        cFrameArena arena;
+        cEthernetPacket obj(MAX_DOUBLE_TAGGED_PACKET);
+        obj.setMacHeader(src, dst);
+        obj.addVlanTag(true, 12, 7, 0);
+        obj.setPayload ((uint8_t*)"\xaa\xbb\xcc", 3);
+        obj.setLength ();
+        obj.shrinkToFit (arena);
+        BUG_IF_NOT (obj.data == nullptr);
+        BUG_IF_NOT (((uintptr_t)obj.packet % cFrameArena::FRAME_ALIGNMENT) == 0);
+        BUG_IF_NOT (obj.getLength() == 21);
+        BUG_IF_NOT (obj.packetMaxLength == 21);
+        BUG_IF_NOT (obj.getTypeLength() == 3);
+        BUG_IF_NOT (!memcmp (obj.packet, "\x11\x22\x33\x44\x55\x66\x12\x34\x56\x78\x9a\xbc\x81\x00\xe0\x0c\x00\x03\xaa\xbb\xcc", 21));
+        obj.setDestMac (src);
+        BUG_IF_NOT (!memcmp (obj.packet, "\x12\x34\x56\x78\x9a\xbc\x12\x34\x56\x78\x9a\xbc\x81\x00", 14));
+
+        // the packet is full now
+        catched = false;
+        try
+        {
+            obj.appendPayload ((uint8_t*)"\x00", 1);
+        }
+        catch (FormatException& )
+        {
+            catched = true;
+        }
+        BUG_IF_NOT (catched);
+
+        // copies are heap allocated again
+        cEthernetPacket cpy(obj);
+        BUG_IF_NOT (cpy.data != nullptr);
+        BUG_IF_NOT (!memcmp (obj.packet, cpy.packet, 21));
+
+        // enlarged packets are heap allocated again
+        obj.reserve (100);
+        BUG_IF_NOT (obj.data != nullptr);
+        BUG_IF_NOT (obj.packetMaxLength == 100);
+        BUG_IF_NOT (obj.getTypeLength() == 3);
+        BUG_IF_NOT (!memcmp (obj.packet, cpy.packet, 21));
+        obj.appendPayload ((uint8_t*)"\xdd", 1);
+        BUG_IF_NOT (obj.getLength() == 22 && obj.getPayload ()[3] == 0xdd);
+    }
 }
 #endif
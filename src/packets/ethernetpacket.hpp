@@ -1,7 +1,7 @@
 // SPDX-License-Identifier: GPL-3.0-only
 /*
  * TCPPUMP <https://github.com/amartin755/tcppump>
- * Copyright (C) 2012-2025 Andreas Martin (netnag@mailbox.org)
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -28,6 +28,8 @@
 #include "inet.h"
 #include "macaddress.hpp"
 #include "linkable.hpp"
+#include "framearena.hpp"
+#include "txoffload.hpp"
 
 
 class cEthernetPacket : public cLinkable
@@ -63,6 +65,7 @@ public:
     void appendPayload (const uint8_t* payload, size_t len);
     void setRaw (const uint8_t* payload, size_t len);
     const uint8_t* get () const;
+    uint8_t* get () {return packet;}
     inline size_t getLength () const {return pPayload - packet + payloadLength;}
     inline void clear () {reset ();};
     inline bool hasLlcHeader () const {return llcHeaderLength != 0;}
@@ -86,6 +89,10 @@ public:
     inline size_t getPayloadLength () const {return payloadLength;}
     inline uint16_t getTypeLength () const {return ntohs(*pEthertypeLength);}
     void updatePayloadAt (unsigned offset, const void* payload, size_t len);
+    void shrinkToFit (cFrameArena& arena);
+    void reserve (size_t maxLength);
+    inline void setOffload (const txOffload& o) {offload = o;}
+    inline const txOffload& getOffload () const {return offload;}
 
     static const size_t   MAX_ETHERNET_PAYLOAD     = 1500;
     static const size_t   MAX_PACKET               = 6+6+2+MAX_ETHERNET_PAYLOAD;
@@ -108,7 +115,7 @@ private:
             throw FormatException (exParRange, NULL);
     }
 
-    const uint32_t* data;       // holds the packet data; do never access directly; use packet instead!
+    const uint32_t* data;       // holds the packet data; do never access directly; use packet instead! (nullptr if stored in arena)
     uint8_t*  packet;            // always points to packet begin
     size_t    packetMaxLength;
     uint8_t*  pPayload;         // points at begin of payload (will be moved in case of tagging)
@@ -116,6 +123,7 @@ private:
     size_t    payloadLength;
     size_t    llcHeaderLength;
     bool      hasDMAC;
+    txOffload offload;
 };
 
 enum ethertypes_t : uint16_t
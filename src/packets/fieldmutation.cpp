@@ -0,0 +1,224 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ * TCPPUMP <https://github.com/amartin755/tcppump>
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+#include <algorithm>
+
+#include "fieldmutation.hpp"
+#include "inetchecksum.hpp"
+#include "random.hpp"
+#include "bug.hpp"
+
+
+// returns the value of the first transmission
+uint32_t cFieldMutation::initial (void)
+{
+    switch (gen)
+    {
+    case RANDOM:
+        return cRandom::rand32 (min, max);
+    case INCREMENT:
+        return min;
+    default:
+        // the list starts with the value of the second transmission
+        BUG_ON (values.empty ());
+        std::rotate (values.begin (), values.begin () + 1, values.end ());
+        next = 0;
+        return values.back ();
+    }
+}
+
+
+// sets the value of the next transmission
+void cFieldMutation::apply (uint8_t* frame) const
+{
+    uint32_t v;
+
+    switch (gen)
+    {
+    case RANDOM:
+        v = cRandom::rand32 (min, max);
+        break;
+    case INCREMENT:
+        v = read (frame);
+        v = (v < min || v >= max) ? min : v + 1;
+        break;
+    default:
+        v = values[next];
+        if (++next == values.size ())
+            next = 0;
+        break;
+    }
+    write (frame, v);
+}
+
+
+uint32_t cFieldMutation::read (const uint8_t* frame) const
+{
+    uint32_t v = 0;
+    for (unsigned n = 0; n < width; n++)
+        v = v << 8 | frame[offset + n];
+    return v;
+}
+
+
+void cFieldMutation::write (uint8_t* frame, uint32_t value) const
+{
+    BUG_ON (!width || width > 4);
+
+    // checksums are sums of 16bit words; all headers start at even offsets within the frame
+    const size_t first = offset & ~(size_t)1;
+    const size_t words = (offset + width - first + 1) / 2;
+    uint16_t oldWords[3];
+    std::memcpy (oldWords, frame + first, words * 2);
+
+    for (unsigned n = 0; n < width; n++)
+        frame[offset + n] = (uint8_t)(value >> (8 * (width - 1 - n)));
+
+    uint16_t ipSum = 0, l4Sum = 0;
+    const bool updateL4 = l4Checksum && (l4Partial || !(isUdp && !(frame[l4Checksum] | frame[l4Checksum + 1])));
+    if (ipChecksum)
+        std::memcpy (&ipSum, frame + ipChecksum, sizeof (ipSum));
+    if (updateL4)
+        std::memcpy (&l4Sum, frame + l4Checksum, sizeof (l4Sum));
+
+    for (size_t n = 0; n < words; n++)
+    {
+        uint16_t newWord;
+        std::memcpy (&newWord, frame + first + 2 * n, sizeof (newWord));
+        if (ipChecksum)
+            ipSum = cInetChecksum::rfc1624 (ipSum, oldWords[n], newWord);
+        // the sum of the pseudo header is the complement of a checksum
+        if (updateL4)
+            l4Sum = l4Partial ? (uint16_t)~cInetChecksum::rfc1624 ((uint16_t)~l4Sum, oldWords[n], newWord)
+                              : cInetChecksum::rfc1624 (l4Sum, oldWords[n], newWord);
+    }
+
+    if (ipChecksum)
+        std::memcpy (frame + ipChecksum, &ipSum, sizeof (ipSum));
+    if (updateL4)
+    {
+        // a calculated UDP checksum of zero is transmitted as all ones
+        if (isUdp && !l4Sum && !l4Partial)
+            l4Sum = 0xffff;
+        std::memcpy (frame + l4Checksum, &l4Sum, sizeof (l4Sum));
+    }
+}
+
+
+#ifdef WITH_UNITTESTS
+#include "console.hpp"
+
+void cFieldMutation::unitTest ()
+{
+    Console::PrintDebug("-- " __FILE__ " --\n");
+
+    // ethernet, IPv4 and UDP header with 4 bytes payload
+    uint8_t frame[] = {
+        0x11,0x22,0x33,0x44,0x55,0x66, 0x80,0x23,0x45,0x67,0x89,0xab, 0x08,0x00,
+        0x45,0x00,0x00,0x20, 0x12,0x34,0x00,0x00, 0x40,0x11,0x00,0x00, 10,0,0,1, 10,0,0,2,
+        0x00,0x01,0x00,0x02, 0x00,0x0c,0x00,0x00, 0xde,0xad,0xbe,0xef};
+    const size_t l3 = 14, l4 = 34;
+
+    // the checksums of the modified frame must match the full calculation
+    auto ipChecksumOk = [&] () -> bool
+    {
+        return !cInetChecksum::rfc1071 (frame + l3, 20);
+    };
+    auto udpChecksumOk = [&] () -> bool
+    {
+        const uint8_t pseudo[] = {0, 17, 0, 12};
+        return !cInetChecksum::rfc1071 (frame + l3 + 12, 8, pseudo, sizeof (pseudo), frame + l4, 12);
+    };
+    uint16_t sum = cInetChecksum::rfc1071 (frame + l3, 20);
+    std::memcpy (frame + l3 + 10, &sum, sizeof (sum));
+    const uint8_t pseudo[] = {0, 17, 0, 12};
+    sum = cInetChecksum::rfc1071 (frame + l3 + 12, 8, pseudo, sizeof (pseudo), frame + l4, 12);
+    std::memcpy (frame + l4 + 6, &sum, sizeof (sum));
+    BUG_IF_NOT (ipChecksumOk () && udpChecksumOk ());
+
+    // destination IP
+    cFieldMutation dip;
+    dip.offset     = l3 + 16;
+    dip.width      = 4;
+    dip.ipChecksum = l3 + 10;
+    dip.l4Checksum = l4 + 6;
+    dip.isUdp      = true;
+    dip.min        = 0x0a0000fe;
+    dip.max        = 0x0a000101;
+    BUG_IF_NOT (dip.initial () == 0x0a0000fe);
+    // values outside the range restart at its begin
+    for (uint32_t expected : {0x0a0000feu, 0x0a0000ffu, 0x0a000100u, 0x0a000101u, 0x0a0000feu})
+    {
+        dip.apply (frame);
+        BUG_IF_NOT (dip.read (frame) == expected);
+        BUG_IF_NOT (ipChecksumOk () && udpChecksumOk ());
+    }
+
+    // TTL, which shares its 16bit word with the protocol
+    cFieldMutation ttl;
+    ttl.offset     = l3 + 8;
+    ttl.width      = 1;
+    ttl.gen        = LIST;
+    ttl.ipChecksum = l3 + 10;
+    ttl.values     = {1, 128, 255};
+    BUG_IF_NOT (ttl.initial () == 1);
+    for (uint32_t expected : {128u, 255u, 1u, 128u})
+    {
+        ttl.apply (frame);
+        BUG_IF_NOT (frame[l3 + 8] == expected && frame[l3 + 9] == 17);
+        BUG_IF_NOT (ipChecksumOk () && udpChecksumOk ());
+    }
+
+    // source port with random values
+    cFieldMutation sport;
+    sport.offset     = l4;
+    sport.width      = 2;
+    sport.gen        = RANDOM;
+    sport.l4Checksum = l4 + 6;
+    sport.isUdp      = true;
+    sport.min        = 1000;
+    sport.max        = 1003;
+    for (int n = 0; n < 100; n++)
+    {
+        sport.apply (frame);
+        BUG_IF_NOT (sport.read (frame) >= 1000 && sport.read (frame) <= 1003);
+        BUG_IF_NOT (ipChecksumOk () && udpChecksumOk ());
+    }
+
+    // disabled UDP checksums stay disabled
+    frame[l4 + 6] = frame[l4 + 7] = 0;
+    sport.apply (frame);
+    BUG_IF_NOT (!frame[l4 + 6] && !frame[l4 + 7]);
+
+    // offloaded checksum: the field holds the sum of the pseudo header
+    auto pseudoSum = [&] () -> uint16_t
+    {
+        return (uint16_t)cInetChecksum::rfc1071_calc (pseudo, sizeof (pseudo), cInetChecksum::rfc1071_calc (frame + l3 + 12, 8));
+    };
+    sum = pseudoSum ();
+    std::memcpy (frame + l4 + 6, &sum, sizeof (sum));
+    dip.l4Partial = true;
+    for (int n = 0; n < 5; n++)
+    {
+        dip.apply (frame);
+        std::memcpy (&sum, frame + l4 + 6, sizeof (sum));
+        BUG_IF_NOT (ipChecksumOk () && sum == pseudoSum ());
+    }
+}
+#endif
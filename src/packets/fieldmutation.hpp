@@ -0,0 +1,74 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ * TCPPUMP <https://github.com/amartin755/tcppump>
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef FIELDMUTATION_HPP_
+#define FIELDMUTATION_HPP_
+
+#include <cstdint>
+#include <cstddef>    // size_t
+#include <vector>
+
+
+/*
+ * A header field of a compiled frame, which gets a new value with each transmission. The frame always
+ * contains the value of its next transmission; apply() is called after the frame was sent.
+ * The value is written in network byte order and the IPv4 header and UDP/TCP checksums, which cover
+ * the field, are updated incrementally (RFC 1624). So the frame doesn't need to be compiled again.
+ */
+class cFieldMutation
+{
+public:
+    enum generator : uint8_t
+    {
+        INCREMENT,  // min, min+1, ..., max, min, ...
+        RANDOM,     // random value within [min, max]
+        LIST,       // values[0], values[1], ..., values[0], ...
+    };
+
+    cFieldMutation ()
+    : offset (0), width (0), gen (INCREMENT), ipChecksum (0), l4Checksum (0), isUdp (false), l4Partial (false), min (0), max (0), next (0)
+    {
+    }
+
+    uint32_t initial (void);
+    void apply (uint8_t* frame) const;
+
+    size_t   offset;        // of the field within the frame
+    unsigned width;         // in bytes, 1 - 4
+    generator gen;
+    size_t   ipChecksum;    // offset of the IPv4 header checksum, 0 if not affected
+    size_t   l4Checksum;    // offset of the UDP/TCP checksum, 0 if not affected
+    bool     isUdp;         // a zero UDP checksum means no checksum
+    bool     l4Partial;     // the UDP/TCP checksum field holds the sum of the pseudo header (see txOffload)
+    uint32_t min;
+    uint32_t max;
+    std::vector<uint32_t> values;  // values of the following transmissions, repeated
+
+#ifdef WITH_UNITTESTS
+    static void unitTest ();
+#endif
+
+private:
+    uint32_t read (const uint8_t* frame) const;
+    void     write (uint8_t* frame, uint32_t value) const;
+
+    mutable size_t next;    // next element of values
+};
+
+#endif /* FIELDMUTATION_HPP_ */
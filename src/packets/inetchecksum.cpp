@@ -1,7 +1,7 @@
 // SPDX-License-Identifier: GPL-3.0-only
 /*
  * TCPPUMP <https://github.com/amartin755/tcppump>
- * Copyright (C) 2012-2024 Andreas Martin (netnag@mailbox.org)
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -17,13 +17,279 @@
  */
 
 #include <cstring>
+#include <atomic>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define HAVE_CHECKSUM_AVX2
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#elif defined(HAVE_MSVC) && (defined(_M_X64) || defined(_M_IX86))
+#include <immintrin.h>
+#include <intrin.h>
+#define HAVE_CHECKSUM_AVX2
+#define TARGET_AVX2
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define HAVE_CHECKSUM_SSE2
+#endif
 
 #include "bug.hpp"
 #include "inetchecksum.hpp"
 
-// TODO
-// maybe it's woth to have a closer look at the kernels implementation
-// https://git.kernel.org/pub/scm/linux/kernel/git/torvalds/linux.git/tree/lib/checksum.c
+/*
+ * All kernels sum up the data as a sequence of native 64bit words with end-around carry.
+ * As 2^16 - 1 divides 2^64 - 1, folding this sum results in the same ones' complement sum as
+ * adding 16bit words. Thus there is no need for aligned accesses, and the vector kernels are
+ * free to add the 16bit words in any order.
+ */
+typedef uint64_t (*sumFunction)(const uint8_t* p, size_t len, uint64_t sum);
+
+static inline uint64_t addCarry (uint64_t sum, uint64_t val)
+{
+    sum += val;
+    return sum + (sum < val);
+}
+
+static uint64_t sumGeneric (const uint8_t* p, size_t len, uint64_t sum)
+{
+    uint64_t v[4];
+    while (len >= sizeof (v))
+    {
+        std::memcpy (v, p, sizeof (v));
+        sum = addCarry (sum, v[0]);
+        sum = addCarry (sum, v[1]);
+        sum = addCarry (sum, v[2]);
+        sum = addCarry (sum, v[3]);
+        p   += sizeof (v);
+        len -= sizeof (v);
+    }
+    while (len >= 8)
+    {
+        std::memcpy (v, p, 8);
+        sum = addCarry (sum, v[0]);
+        p   += 8;
+        len -= 8;
+    }
+    if (len >= 4)
+    {
+        uint32_t v32;
+        std::memcpy (&v32, p, 4);
+        sum = addCarry (sum, v32);
+        p   += 4;
+        len -= 4;
+    }
+    if (len >= 2)
+    {
+        uint16_t v16;
+        std::memcpy (&v16, p, 2);
+        sum = addCarry (sum, v16);
+        p   += 2;
+        len -= 2;
+    }
+    if (len)
+    {
+#ifndef HAVE_BIG_ENDIAN
+        sum = addCarry (sum, *p);
+#else
+        sum = addCarry (sum, (uint64_t)*p << 8);
+#endif
+    }
+    return sum;
+}
+
+// The vector kernels add at most two 16bit words per block to every 32bit lane, thus the lanes
+// must be flushed before 2^15 blocks have been added.
+static const size_t MAX_VECTOR_BLOCKS = 0x8000 - 1;
+// below this length, setup and reduction of the vector registers cost more than they save
+static const size_t MIN_VECTOR_LEN = 128;
+
+#ifdef HAVE_CHECKSUM_SSE2
+
+static uint64_t sumSSE2 (const uint8_t* p, size_t len, uint64_t sum)
+{
+    if (len < MIN_VECTOR_LEN)
+        return sumGeneric (p, len, sum);
+
+    const __m128i zero = _mm_setzero_si128 ();
+    while (len >= 32)
+    {
+        size_t blocks = len / 32;
+        if (blocks > MAX_VECTOR_BLOCKS)
+            blocks = MAX_VECTOR_BLOCKS;
+        len -= blocks * 32;
+
+        __m128i acc0 = _mm_setzero_si128 ();
+        __m128i acc1 = _mm_setzero_si128 ();
+        for (; blocks; blocks--, p += 32)
+        {
+            __m128i v0 = _mm_loadu_si128 ((const __m128i*)p);
+            __m128i v1 = _mm_loadu_si128 ((const __m128i*)(p + 16));
+            acc0 = _mm_add_epi32 (acc0, _mm_add_epi32 (_mm_unpacklo_epi16 (v0, zero), _mm_unpackhi_epi16 (v0, zero)));
+            acc1 = _mm_add_epi32 (acc1, _mm_add_epi32 (_mm_unpacklo_epi16 (v1, zero), _mm_unpackhi_epi16 (v1, zero)));
+        }
+        // 64bit lanes can't overflow
+        acc0 = _mm_add_epi64 (_mm_unpacklo_epi32 (acc0, zero), _mm_unpackhi_epi32 (acc0, zero));
+        acc1 = _mm_add_epi64 (_mm_unpacklo_epi32 (acc1, zero), _mm_unpackhi_epi32 (acc1, zero));
+        acc0 = _mm_add_epi64 (acc0, acc1);
+
+        uint64_t lanes[2];
+        _mm_storeu_si128 ((__m128i*)lanes, acc0);
+        sum = addCarry (sum, lanes[0]);
+        sum = addCarry (sum, lanes[1]);
+    }
+    return sumGeneric (p, len, sum);
+}
+#endif
+
+#ifdef HAVE_CHECKSUM_AVX2
+TARGET_AVX2 static uint64_t sumAVX2 (const uint8_t* p, size_t len, uint64_t sum)
+{
+    if (len < MIN_VECTOR_LEN)
+        return sumGeneric (p, len, sum);
+
+    const __m256i zero = _mm256_setzero_si256 ();
+    while (len >= 64)
+    {
+        size_t blocks = len / 64;
+        if (blocks > MAX_VECTOR_BLOCKS)
+            blocks = MAX_VECTOR_BLOCKS;
+        len -= blocks * 64;
+
+        __m256i acc0 = _mm256_setzero_si256 ();
+        __m256i acc1 = _mm256_setzero_si256 ();
+        for (; blocks; blocks--, p += 64)
+        {
+            __m256i v0 = _mm256_loadu_si256 ((const __m256i*)p);
+            __m256i v1 = _mm256_loadu_si256 ((const __m256i*)(p + 32));
+            acc0 = _mm256_add_epi32 (acc0, _mm256_add_epi32 (_mm256_unpacklo_epi16 (v0, zero), _mm256_unpackhi_epi16 (v0, zero)));
+            acc1 = _mm256_add_epi32 (acc1, _mm256_add_epi32 (_mm256_unpacklo_epi16 (v1, zero), _mm256_unpackhi_epi16 (v1, zero)));
+        }
+        acc0 = _mm256_add_epi64 (_mm256_unpacklo_epi32 (acc0, zero), _mm256_unpackhi_epi32 (acc0, zero));
+        acc1 = _mm256_add_epi64 (_mm256_unpacklo_epi32 (acc1, zero), _mm256_unpackhi_epi32 (acc1, zero));
+        acc0 = _mm256_add_epi64 (acc0, acc1);
+
+        uint64_t lanes[4];
+        _mm256_storeu_si256 ((__m256i*)lanes, acc0);
+        sum = addCarry (sum, lanes[0]);
+        sum = addCarry (sum, lanes[1]);
+        sum = addCarry (sum, lanes[2]);
+        sum = addCarry (sum, lanes[3]);
+    }
+    return sumGeneric (p, len, sum);
+}
+
+static bool cpuHasAVX2 (void)
+{
+#if defined(__GNUC__)
+    __builtin_cpu_init ();
+    return __builtin_cpu_supports ("avx2");
+#else
+    int regs[4];
+    __cpuid (regs, 0);
+    if (regs[0] < 7)
+        return false;
+    __cpuid (regs, 1);
+    // OS must save the ymm registers (OSXSAVE, XCR0 bits 1 and 2)
+    if (!(regs[2] & (1 << 27)) || (_xgetbv (0) & 6) != 6)
+        return false;
+    __cpuidex (regs, 7, 0);
+    return (regs[1] & (1 << 5)) != 0;
+#endif
+}
+#endif
+
+static sumFunction getSumFunction (cInetChecksum::implementation impl)
+{
+    switch (impl)
+    {
+#ifdef HAVE_CHECKSUM_SSE2
+    case cInetChecksum::SSE2:
+        return sumSSE2;
+#endif
+#ifdef HAVE_CHECKSUM_AVX2
+    case cInetChecksum::AVX2:
+        return sumAVX2;
+#endif
+    default:
+        return sumGeneric;
+    }
+}
+
+static uint64_t sumDispatch (const uint8_t* p, size_t len, uint64_t sum);
+static std::atomic<sumFunction> sumKernel (sumDispatch);
+
+// first call selects the kernel
+static uint64_t sumDispatch (const uint8_t* p, size_t len, uint64_t sum)
+{
+    sumFunction f = getSumFunction (cInetChecksum::getBest ());
+    sumKernel.store (f, std::memory_order_relaxed);
+    return f (p, len, sum);
+}
+
+
+bool cInetChecksum::isSupported (implementation impl)
+{
+    switch (impl)
+    {
+    case GENERIC:
+        return true;
+#ifdef HAVE_CHECKSUM_SSE2
+    case SSE2:
+        return true;
+#endif
+#ifdef HAVE_CHECKSUM_AVX2
+    case AVX2:
+        return cpuHasAVX2 ();
+#endif
+    default:
+        return false;
+    }
+}
+
+const char* cInetChecksum::getName (implementation impl)
+{
+    switch (impl)
+    {
+    case GENERIC:
+        return "generic";
+    case SSE2:
+        return "sse2";
+    case AVX2:
+        return "avx2";
+    }
+    return "?";
+}
+
+cInetChecksum::implementation cInetChecksum::getBest (void)
+{
+    if (isSupported (AVX2))
+        return AVX2;
+    if (isSupported (SSE2))
+        return SSE2;
+    return GENERIC;
+}
+
+void cInetChecksum::use (implementation impl)
+{
+    BUG_IF_NOT (isSupported (impl));
+    sumKernel.store (getSumFunction (impl), std::memory_order_relaxed);
+}
+
+uint32_t cInetChecksum::rfc1071_calc (const void* p, size_t len, uint32_t sum)
+{
+    if (len == 0)
+        return sum;
+
+    uint64_t sum64 = sumKernel.load (std::memory_order_relaxed) ((const uint8_t*)p, len, sum);
+
+    sum64 = (sum64 & 0xffffffff) + (sum64 >> 32);
+    sum64 = (sum64 & 0xffffffff) + (sum64 >> 32);
+    uint32_t sum32 = (uint32_t)sum64;
+    sum32 = (sum32 & 0xffff) + (sum32 >> 16);
+    sum32 = (sum32 & 0xffff) + (sum32 >> 16);
+    return sum32;
+}
 
 uint16_t cInetChecksum::rfc1071 (const void* p, size_t len, const void* p2, size_t len2, const void* p3, size_t len3)
 {
@@ -99,5 +365,80 @@ void cInetChecksum::unitTest ()
         const char* payload = " There's no place like 127.0.0.1";
         BUG_IF_NOT (cInetChecksum::rfc1071 (ipheader, sizeof (ipheader), udpheadr, sizeof (udpheadr), payload+1, std::strlen(payload+1)) == 0xe023);
     }
+    // incremental update must match the full calculation
+    {
+        uint8_t hd2[sizeof (hd)];
+        std::memcpy (hd2, hd1, sizeof (hd2));
+        const uint16_t chksum = (uint16_t)(hd2[10] | hd2[11] << 8);
+        const uint16_t oldTtl = (uint16_t)(hd2[8] | hd2[9] << 8);
+        hd2[8] = 0x40;
+        const uint16_t newTtl = (uint16_t)(hd2[8] | hd2[9] << 8);
+        const uint16_t updated = cInetChecksum::rfc1624 (chksum, oldTtl, newTtl);
+        hd2[10] = 0;
+        hd2[11] = 0;
+        BUG_IF_NOT (cInetChecksum::rfc1071 (hd2, sizeof (hd2)) == updated);
+        // a change back must restore the original checksum
+        BUG_IF_NOT (cInetChecksum::rfc1624 (updated, newTtl, oldTtl) == chksum);
+    }
+    // all implementations must match a plain 16bit word summation for any alignment and length
+    {
+        const size_t maxLen = 0x10000 + 7;
+        uint8_t* buf = new uint8_t[maxLen + 4];
+        uint32_t seed = 0x12345678;
+        for (size_t n = 0; n < maxLen + 4; n++)
+        {
+            seed = seed * 1103515245 + 12345;
+            buf[n] = (uint8_t)(seed >> 16);
+        }
+        // worst case for carries
+        std::memset (buf + 0x8000, 0xff, 0x4000);
+
+        auto reference = [](const uint8_t* p, size_t len) -> uint16_t
+        {
+            uint32_t sum = 0;
+            for (size_t n = 0; n + 1 < len; n += 2)
+            {
+#ifndef HAVE_BIG_ENDIAN
+                sum += (uint32_t)(p[n] | p[n + 1] << 8);
+#else
+                sum += (uint32_t)(p[n] << 8 | p[n + 1]);
+#endif
+                sum = (sum & 0xffff) + (sum >> 16);
+            }
+            if (len & 1)
+#ifndef HAVE_BIG_ENDIAN
+                sum += p[len - 1];
+#else
+                sum += (uint32_t)p[len - 1] << 8;
+#endif
+            return rfc1071_finalize (sum);
+        };
+        const size_t lengths[] = {0x10000, 0x10000 + 7, 0x8000 + 3, 9000, 1500, 1501};
+
+        for (int impl = GENERIC; impl <= AVX2; impl++)
+        {
+            if (!isSupported ((implementation)impl))
+                continue;
+            use ((implementation)impl);
+            Console::PrintDebug("   %s\n", getName ((implementation)impl));
+
+            for (size_t offset = 0; offset < 4; offset++)
+            {
+                const uint8_t* p = buf + offset;
+                for (size_t len = 0; len < 300; len++)
+                {
+                    BUG_IF_NOT (rfc1071 (p, len) == reference (p, len));
+                }
+                for (size_t len : lengths)
+                {
+                    const uint16_t ref = reference (p, len);
+                    BUG_IF_NOT (rfc1071 (p, len) == ref);
+                    BUG_IF_NOT (rfc1071 (p, 20, p + 20, 130, p + 150, len - 150) == ref);
+                }
+            }
+        }
+        use (getBest ());
+        delete[] buf;
+    }
 }
 #endif
@@ -1,7 +1,7 @@
 // SPDX-License-Identifier: GPL-3.0-only
 /*
  * TCPPUMP <https://github.com/amartin755/tcppump>
- * Copyright (C) 2012-2024 Andreas Martin (netnag@mailbox.org)
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -43,50 +43,31 @@ public:
     static uint16_t rfc1071 (const void* p, size_t len, const void* p2, size_t len2, const void* p3, size_t len3);
 
 
-    static uint32_t rfc1071_calc (const void* p, size_t len, uint32_t sum = 0)
+    // partial sum, which can be passed to the next calculation; the result is at most 0xffff
+    static uint32_t rfc1071_calc (const void* p, size_t len, uint32_t sum = 0);
+
+    // updates a checksum, if a 16bit word of the covered data changes from oldVal to newVal (RFC 1624, eqn. 3)
+    static uint16_t rfc1624 (uint16_t checksum, uint16_t oldVal, uint16_t newVal)
     {
-        if (len == 0)
-            return sum;
-
-        if ((intptr_t)p & 1)
-        {
-            const uint8_t *p8 = (uint8_t*)p;
-
-            while (len > 1)
-            {
-                uint16_t val;
-#ifndef HAVE_BIG_ENDIAN
-                val  = *p8++;
-                val |= *p8++ << 8;
-#else
-                val  = *p8++ << 8;
-                val |= *p8++;
-#endif
-                sum += val;
-                len -= 2;
-            }
-            if (len)
-                sum += *(uint8_t*)p8;
-        }
-        else
-        {
-            const uint16_t *p16 = (uint16_t*)p;
-
-            while (len > 1)
-            {
-                sum += *p16++;
-                len -= 2;
-            }
-            if (len)
-#ifndef HAVE_BIG_ENDIAN
-                sum += *(uint8_t*)p16;
-#else
-                sum += *(uint8_t*)p16 << 8;
-#endif
-        }
-        return sum;
+        return rfc1071_finalize ((uint32_t)(uint16_t)~checksum + (uint16_t)~oldVal + newVal);
     }
 
+    /*
+     * Implementations of the calculation. All of them return the same results for any alignment and length.
+     * By default, the fastest one supported by the CPU is used.
+     */
+    enum implementation
+    {
+        GENERIC,    // portable, 64bit words
+        SSE2,
+        AVX2,
+    };
+    static bool isSupported (implementation impl);
+    static const char* getName (implementation impl);
+    // not thread safe, for tests and benchmarks only
+    static void use (implementation impl);
+    static implementation getBest (void);
+
 private:
     static inline uint16_t rfc1071_finalize (uint32_t sum)
     {
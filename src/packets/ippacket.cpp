@@ -18,23 +18,24 @@
 
 
 #include <cstring>
+#include <algorithm>
 
 #include "inet.h"
 #include "ippacket.hpp"
 
 #include "bug.hpp"
 #include "settings.hpp"
+#include "orderdependency.hpp"
 
 
-uint16_t cIPPacket::v4::nextIdentification = 1;
-
-
-cIPPacket::cIPPacket (bool isIPv6) : m_isIPv6 (isIPv6), m_mtu (cSettings::get().getMyMTU())
+cIPPacket::cIPPacket (bool isIPv6) : m_isIPv6 (isIPv6), m_csumOffload (false), m_gso (false),
+    m_gsoType (txOffload::GSO_NONE), m_gsoSize (0), m_gsoHdrLen (0), m_mtu (cSettings::get().getMyMTU())
 {
     cEthernetPacket firstPacket;
     firstPacket.setTypeLength (isIPv6 ? ETHERTYPE_IPV6 : ETHERTYPE_IPV4);
     m_packets.push_back(std::move(firstPacket));
     m_packetsAsArray = nullptr;
+    m_l4Checksum = 0;
 
     m_dscp = 0;
     m_ecn  = 0;
@@ -164,6 +165,83 @@ void cIPPacket::setFlowLabel (unsigned fl)
     m_v6.flowlabel = fl;
 }
 
+// the field gets the values of m, its location is determined by locateMutations after the packet was compiled
+void cIPPacket::addMutation (mutableField field, const cFieldMutation& m)
+{
+    BUG_ON (m_isIPv6 && (field == FIELD_SOURCE || field == FIELD_DESTINATION || field == FIELD_IDENTIFICATION));
+    BUG_ON (!m_l4Checksum && (field == FIELD_SOURCE_PORT || field == FIELD_DESTINATION_PORT));
+    m_mutations.push_back (m);
+    m_mutableFields.push_back (field);
+}
+
+bool cIPPacket::hasMutation (mutableField field) const
+{
+    return std::find (m_mutableFields.begin (), m_mutableFields.end (), field) != m_mutableFields.end ();
+}
+
+// returns false, if the packet is fragmented, because fields of fragments can't be changed independently.
+// Super-frames are a single packet, thus their fields are changed before they are split.
+bool cIPPacket::locateMutations (void)
+{
+    if (m_mutations.empty ())
+        return true;
+    if (m_packets.size () != 1)
+        return false;
+
+    const cEthernetPacket& eth = m_packets.front ();
+    const size_t l3 = eth.getPayload () - eth.get ();
+    const size_t l4 = l3 + getHeaderLength ();
+    const bool isUdp = eth.getPayload ()[m_isIPv6 ? 6 : 9] == PROTO_UDP;
+    const bool l4Partial = eth.getOffload ().needsChecksum ();
+    BUG_ON (l3 & 1); // checksums are updated word by word
+
+    for (size_t n = 0; n < m_mutations.size (); n++)
+    {
+        cFieldMutation& m = m_mutations[n];
+        m.ipChecksum = m_isIPv6 ? 0 : l3 + 10;
+        m.l4Checksum = m_l4Checksum ? l4 + m_l4Checksum : 0;
+        m.isUdp      = isUdp;
+        m.l4Partial  = l4Partial;
+
+        switch (m_mutableFields[n])
+        {
+        case FIELD_SOURCE:
+            m.offset = l3 + 12;
+            m.width  = 4;
+            break;
+        case FIELD_DESTINATION:
+            m.offset = l3 + 16;
+            m.width  = 4;
+            break;
+        case FIELD_IDENTIFICATION:
+            m.offset = l3 + 4;
+            m.width  = 2;
+            m.l4Checksum = 0;
+            break;
+        case FIELD_TTL:
+            m.offset = l3 + (m_isIPv6 ? 7 : 8);
+            m.width  = 1;
+            m.l4Checksum = 0;
+            break;
+        case FIELD_SOURCE_PORT:
+            m.offset = l4;
+            m.width  = 2;
+            m.ipChecksum = 0;
+            if (l4Partial)
+                m.l4Checksum = 0;   // not part of the pseudo header
+            break;
+        case FIELD_DESTINATION_PORT:
+            m.offset = l4 + 2;
+            m.width  = 2;
+            m.ipChecksum = 0;
+            if (l4Partial)
+                m.l4Checksum = 0;
+            break;
+        }
+    }
+    return true;
+}
+
 void cIPPacket::v4compile (uint8_t protocol, const uint8_t* l4header, size_t l4headerLen, const uint8_t* payload, size_t payloadLen)
 {
     if (l4headerLen + payloadLen + getHeaderLength() > 65535)
@@ -173,6 +251,7 @@ void cIPPacket::v4compile (uint8_t protocol, const uint8_t* l4header, size_t l4h
 
     unsigned fragCnt = unsigned((l4headerLen + payloadLen - 1) / (m_mtu - ipHeaderLen)) + 1;
     size_t offset = 0;
+    bool superFrame = fragCnt > 1 && prepareSuperFrame (protocol, l4headerLen, payloadLen);
 
     // we rely on L4 header fitting into first ip fragment
     BUG_ON (l4headerLen > m_mtu - ipHeaderLen);
@@ -191,10 +270,14 @@ void cIPPacket::v4compile (uint8_t protocol, const uint8_t* l4header, size_t l4h
 
     uint16_t id = 0;
     if (fragCnt > 1 && !m_v4.hasId)
-        id = m_v4.nextIdentification++;
+        id = (uint16_t)(1 + cOrderDependency::next (cOrderDependency::IPV4_IDENTIFICATION));
     else
         id = m_v4.identification;
 
+    // a super-frame gets the id of the fragments (UDP) or of the first segment (TCP), but it is never fragmented here
+    if (superFrame)
+        fragCnt = 1;
+
     for (unsigned n = 1; n < fragCnt; n++)
         m_packets.push_back (cEthernetPacket(packet));
 
@@ -206,7 +289,9 @@ void cIPPacket::v4compile (uint8_t protocol, const uint8_t* l4header, size_t l4h
         m_packetsAsArray[n] = &p;
 
         size_t fragLen = 0;
-        if (n == 0)
+        if (superFrame)
+            fragLen = l4headerLen + payloadLen;
+        else if (n == 0)
             fragLen = l4headerLen + payloadLen + ipHeaderLen > m_mtu ? m_mtu - ipHeaderLen : l4headerLen + payloadLen;
         else
             fragLen = payloadLen + ipHeaderLen > m_mtu ? m_mtu - ipHeaderLen : payloadLen;
@@ -269,6 +354,9 @@ void cIPPacket::v6compile (uint8_t protocol, const uint8_t* l4header, size_t l4h
     size_t ipHeaderLen = getHeaderLength();
 
     unsigned fragCnt = unsigned((l4headerLen + payloadLen - 1) / (m_mtu - ipHeaderLen)) + 1;
+    bool superFrame = fragCnt > 1 && prepareSuperFrame (protocol, l4headerLen, payloadLen);
+    if (superFrame)
+        fragCnt = 1;
     //FIXME IPv6 fragmentation not yet implemented
     BUG_ON (fragCnt > 1);
 //    size_t offset = 0;
@@ -300,7 +388,9 @@ void cIPPacket::v6compile (uint8_t protocol, const uint8_t* l4header, size_t l4h
         m_packetsAsArray[n] = &p;
 
         size_t fragLen = 0;
-        if (n == 0)
+        if (superFrame)
+            fragLen = l4headerLen + payloadLen;
+        else if (n == 0)
             fragLen = l4headerLen + payloadLen + ipHeaderLen > m_mtu ? m_mtu - ipHeaderLen : l4headerLen + payloadLen;
         else
             fragLen = payloadLen + ipHeaderLen > m_mtu ? m_mtu - ipHeaderLen : payloadLen;
@@ -347,6 +437,39 @@ void cIPPacket::v6compile (uint8_t protocol, const uint8_t* l4header, size_t l4h
     }
 }
 
+/*
+ * Checks, whether a packet exceeding the MTU can be sent as super-frame and enlarges the ethernet packet
+ * accordingly. Super-frames need an offloaded L4 checksum. As the kernel calculates the IP header checksum
+ * of each segment or fragment, packets with a manual IP header checksum are fragmented here.
+ */
+bool cIPPacket::prepareSuperFrame (uint8_t protocol, size_t l4headerLen, size_t payloadLen)
+{
+    if (!m_gso || !m_csumOffload || !m_l4Checksum || (!m_isIPv6 && m_v4.hasChksum))
+        return false;
+
+    size_t ipHeaderLen = getHeaderLength ();
+    if (protocol == PROTO_TCP)
+    {
+        m_gsoType = m_isIPv6 ? txOffload::GSO_TCPV6 : txOffload::GSO_TCPV4;
+        m_gsoSize = (uint16_t)(m_mtu - ipHeaderLen - l4headerLen);
+        m_gsoHdrLen = (uint16_t)(ipHeaderLen + l4headerLen);
+    }
+    else if (protocol == PROTO_UDP)
+    {
+        // fragments of IPv6 get an additional fragment header
+        m_gsoType = txOffload::GSO_UDP;
+        m_gsoSize = (uint16_t)((m_mtu - ipHeaderLen - (m_isIPv6 ? 8 : 0)) & ~7u);
+        m_gsoHdrLen = (uint16_t)(ipHeaderLen + (m_isIPv6 ? 8 : 0));
+    }
+    else
+        return false;
+
+    cEthernetPacket &packet = m_packets.front();
+    packet.reserve (packet.getLength () + ipHeaderLen + l4headerLen + payloadLen);
+
+    return true;
+}
+
 size_t cIPPacket::getPayloadLength () const
 {
     size_t ipHeaderLen = getHeaderLength();
@@ -370,6 +493,58 @@ void cIPPacket::updateL4Header (const uint8_t* l4header, size_t l4headerLen)
     packet.updatePayloadAt((unsigned)getHeaderLength(), l4header, l4headerLen);
 }
 
+/*
+ * Marks the compiled packet for checksum offload, if it was enabled and the packet is not fragmented.
+ * pseudoSum is the sum of the pseudo header, which must be stored in the checksum field.
+ * Returns false, if the checksum must be calculated completely.
+ */
+bool cIPPacket::offloadChecksum (uint8_t protocol, uint16_t& pseudoSum)
+{
+    if (!m_csumOffload || !m_l4Checksum || m_packets.size () != 1)
+        return false;
+
+    if (!m_isIPv6)
+    {
+        const ipv4_pseudo_header_t ipPseudoHeader = {
+            m_v4.srcIP,
+            m_v4.dstIP,
+            0,
+            protocol,
+            htons((uint16_t)getPayloadLength())
+        };
+        pseudoSum = (uint16_t)cInetChecksum::rfc1071_calc (&ipPseudoHeader, sizeof (ipPseudoHeader));
+    }
+    else
+    {
+        const ipv6_pseudo_header_t ipPseudoHeader = {
+            m_v6.srcIP,
+            m_v6.dstIP,
+            htonl((uint32_t)getPayloadLength()),
+            {0, 0, 0},
+            protocol,
+        };
+        pseudoSum = (uint16_t)cInetChecksum::rfc1071_calc (&ipPseudoHeader, sizeof (ipPseudoHeader));
+    }
+
+    cEthernetPacket& eth = m_packets.front ();
+    txOffload offload;
+    offload.csumStart  = (uint16_t)(eth.getPayload () - eth.get () + getHeaderLength ());
+    offload.csumOffset = (uint16_t)m_l4Checksum;
+    offload.gsoType    = m_gsoType;
+    offload.gsoSize    = m_gsoSize;
+    if (offload.isSuperFrame ())
+        offload.gsoHdrLen = (uint16_t)(eth.getPayload () - eth.get () + m_gsoHdrLen);
+    eth.setOffload (offload);
+    return true;
+}
+
+// the checksum is set explicitly
+void cIPPacket::clearChecksumOffload (void)
+{
+    BUG_ON (m_gsoType != txOffload::GSO_NONE); // super-frames can't be sent without offload
+    m_packets.front ().setOffload (txOffload ());
+}
+
 void cIPPacket::addRouterAlertOption ()
 {
     m_v4.hasRouterAlertOption = true;
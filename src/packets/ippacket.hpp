@@ -28,6 +28,7 @@
 #include "ipaddress.hpp"
 #include "linkable.hpp"
 #include "inetchecksum.hpp"
+#include "fieldmutation.hpp"
 
 
 // RFC2113
@@ -227,6 +228,10 @@ public:
     cEthernetPacket& getFirstEthernetPacket ();
     std::list<cEthernetPacket>& getAllEthernetPackets (void);
     void setDestMac (const cMacAddress& dest);
+    // the L4 checksum is completed on transmission by the kernel or network adapter (see txOffload)
+    void setChecksumOffload (bool enable) {m_csumOffload = enable;}
+    // UDP and TCP packets exceeding the MTU are compiled as one super-frame, which is split on transmission (see txOffload)
+    void setSegmentationOffload (bool enable) {m_gso = enable;}
     void compile (uint8_t protocol, const uint8_t* l4header, size_t l4headerLen, const uint8_t* payload, size_t payloadLen)
     {
         if (m_isIPv6)
@@ -251,6 +256,21 @@ public:
     void getDestination (cIPv6& ip) const;
     void setFlowLabel (unsigned fl);
 
+    // header fields, which can change with each transmission of the packet (see cFieldMutation)
+    enum mutableField
+    {
+        FIELD_SOURCE,           // IPv4 only
+        FIELD_DESTINATION,      // IPv4 only
+        FIELD_IDENTIFICATION,   // IPv4 only
+        FIELD_TTL,
+        FIELD_SOURCE_PORT,      // UDP and TCP only
+        FIELD_DESTINATION_PORT, // UDP and TCP only
+    };
+    void addMutation (mutableField field, const cFieldMutation& m);
+    bool locateMutations (void);
+    bool hasMutation (mutableField field) const;
+    const std::vector<cFieldMutation>& getMutations (void) const {return m_mutations;}
+
     enum protocols
     {
         PROTO_ICMP    = 1,
@@ -271,6 +291,10 @@ protected:
     void     updateL4Header (const uint8_t* l4header, size_t l4headerLen);
     void     addRouterAlertOption (void);
     bool     isIPv6 () const {return m_isIPv6;}
+    bool     offloadChecksum (uint8_t protocol, uint16_t& pseudoSum);
+    void     clearChecksumOffload (void);
+
+    size_t   m_l4Checksum;  // offset of the checksum within the L4 header, 0 if it is not maintained
 
 private:
     size_t getHeaderLength () const
@@ -282,11 +306,19 @@ private:
     }
     void v4compile (uint8_t protocol, const uint8_t* l4header, size_t l4headerLen, const uint8_t* payload, size_t payloadLen);
     void v6compile (uint8_t protocol, const uint8_t* l4header, size_t l4headerLen, const uint8_t* payload, size_t payloadLen);
+    bool prepareSuperFrame (uint8_t protocol, size_t l4headerLen, size_t payloadLen);
 
     bool                        m_isIPv6;
+    bool                        m_csumOffload;
+    bool                        m_gso;
+    uint8_t                     m_gsoType;  // txOffload::gso, GSO_NONE if the packet is not a super-frame
+    uint16_t                    m_gsoSize;
+    uint16_t                    m_gsoHdrLen; // without ethernet header
     unsigned                    m_mtu;
     std::list<cEthernetPacket>  m_packets;
     const cEthernetPacket**     m_packetsAsArray;
+    std::vector<cFieldMutation> m_mutations;
+    std::vector<mutableField>   m_mutableFields;
 
 
     // IP header content
@@ -302,7 +334,6 @@ private:
         struct in_addr  dstIP;
         bool            dontFragment;
         uint16_t        identification;
-        static uint16_t nextIdentification;
         bool            hasId;
         bool            hasRouterAlertOption;
         bool            hasChksum;
@@ -18,6 +18,7 @@
 
 
 #include <cstring>
+#include <cstddef>
 
 #include "bug.hpp"
 #include "inet.h"
@@ -25,23 +26,23 @@
 #include "inetchecksum.hpp"
 
 
-uint32_t cTcpPacket::sequence = 42;
-
 cTcpPacket::cTcpPacket (bool isIPv6) : cIPPacket (isIPv6)
 {
     header.init();
-    setSeqNumber (sequence);
+    m_l4Checksum = offsetof (tcp_header_t, checksum);
 }
 
 void cTcpPacket::compile (const uint8_t* payload, size_t len, bool calcChksum)
 {
     // TODO check max tcp length
 
+    // an explicit checksum is never offloaded
+    if (!calcChksum)
+        setChecksumOffload (false);
     cIPPacket::compile (PROTO_TCP, (const uint8_t*)&header, sizeof (header), payload, len);
-    if (calcChksum)
+    if (calcChksum && !offloadChecksum (PROTO_TCP, header.checksum))
         header.checksum = calcChecksum(payload, len);
     cIPPacket::updateL4Header ((const uint8_t*)&header, sizeof (header));
-    sequence += (uint32_t)len + (uint32_t)header.isSyn();
 }
 
 void cTcpPacket::setSourcePort (uint16_t port)
@@ -62,7 +63,6 @@ void cTcpPacket::setChecksum (uint16_t checksum)
 void cTcpPacket::setSeqNumber (uint32_t seq)
 {
     header.seqNumber = htonl(seq);
-    sequence = seq;
 }
 
 void cTcpPacket::setAckNumber (uint32_t ack)
@@ -164,9 +164,66 @@ uint16_t cTcpPacket::calcChecksum (const uint8_t* payload, size_t len) const
 
 #ifdef WITH_UNITTESTS
 #include "console.hpp"
+#include "settings.hpp"
 
 void cTcpPacket::unitTest ()
 {
     Console::PrintDebug("-- " __FILE__ " --\n");
+
+    // packets exceeding the MTU are compiled as one super-frame, which is segmented on transmission
+    for (bool isIPv6 : {false, true})
+    {
+        static uint8_t payload[4000];
+        for (size_t n = 0; n < sizeof (payload); n++)
+            payload[n] = (uint8_t)n;
+
+        // reference with a MTU large enough for the complete packet
+        cSettings::cThreadMTU jumbo (9000);
+        cTcpPacket calculated (isIPv6);
+        cSettings::cThreadMTU mtu (1500);
+        cTcpPacket superFrame (isIPv6);
+        for (cTcpPacket* p : {&calculated, &superFrame})
+        {
+            if (isIPv6)
+            {
+                p->setSource (cIPv6 ("fe80::1"));
+                p->setDestination (cIPv6 ("fe80::2"));
+            }
+            else
+            {
+                p->setSource (cIPv4 ("10.0.0.1"));
+                p->setDestination (cIPv4 ("10.0.0.2"));
+            }
+            p->setSourcePort (1000);
+            p->setDestinationPort (2000);
+            p->setSeqNumber (0x12345678);
+        }
+        superFrame.setChecksumOffload (true);
+        superFrame.setSegmentationOffload (true);
+        calculated.compile (payload, sizeof (payload), true);
+        superFrame.compile (payload, sizeof (payload), true);
+
+        const size_t hdrLen = 14 + (isIPv6 ? 40 : 20) + 20;
+        BUG_IF_NOT (superFrame.getAllEthernetPackets ().size () == 1);
+        cEthernetPacket& eth = superFrame.getFirstEthernetPacket ();
+        const txOffload& offload = eth.getOffload ();
+        BUG_IF_NOT (eth.getLength () == hdrLen + sizeof (payload));
+        BUG_IF_NOT (offload.gsoType == (isIPv6 ? txOffload::GSO_TCPV6 : txOffload::GSO_TCPV4));
+        BUG_IF_NOT (offload.gsoSize == 1500 - (hdrLen - 14) && offload.gsoHdrLen == hdrLen);
+        BUG_IF_NOT (offload.csumStart == hdrLen - 20 && offload.csumOffset == 16);
+
+        // on the wire: 2 full segments and the rest
+        size_t segLength, lastLength;
+        BUG_IF_NOT (offload.segments (eth.getLength (), segLength, lastLength) == 3);
+        BUG_IF_NOT (segLength == 1514 && lastLength == hdrLen + sizeof (payload) - 2 * offload.gsoSize);
+
+        // the checksum completed on transmission must match the calculated one
+        uint8_t* frame = eth.get ();
+        uint16_t chksum = cInetChecksum::rfc1071 (frame + offload.csumStart, eth.getLength () - offload.csumStart);
+        std::memcpy (frame + offload.csumStart + offload.csumOffset, &chksum, sizeof (chksum));
+        const cEthernetPacket& c = calculated.getFirstEthernetPacket ();
+        BUG_IF_NOT (c.getLength () == eth.getLength () && !c.getOffload ().isSuperFrame ());
+        BUG_IF_NOT (!std::memcmp (c.get () + offload.csumStart, frame + offload.csumStart, eth.getLength () - offload.csumStart));
+    }
 }
 #endif
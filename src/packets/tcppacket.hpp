@@ -126,7 +126,6 @@ private:
     uint16_t calcChecksum (const uint8_t* payload, size_t len) const;
 
     tcp_header_t header;
-    static uint32_t sequence;
 };
 
 
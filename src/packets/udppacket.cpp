@@ -1,7 +1,7 @@
 // SPDX-License-Identifier: GPL-3.0-only
 /*
  * TCPPUMP <https://github.com/amartin755/tcppump>
- * Copyright (C) 2012-2021 Andreas Martin (netnag@mailbox.org)
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -18,6 +18,7 @@
 
 
 #include <cstring>
+#include <cstddef>
 
 #include "inet.h"
 #include "udppacket.hpp"
@@ -28,6 +29,7 @@
 cUdpPacket::cUdpPacket (bool isIPv6) : cIPPacket (isIPv6)
 {
     std::memset (&header, 0, sizeof(header));
+    m_l4Checksum = offsetof (udp_header_t, checksum);
 }
 
 void cUdpPacket::compile (const uint8_t* payload, size_t len)
@@ -36,7 +38,8 @@ void cUdpPacket::compile (const uint8_t* payload, size_t len)
 
     header.length = htons(uint16_t(sizeof (header) + len));
     cIPPacket::compile (PROTO_UDP, (const uint8_t*)&header, sizeof (header), payload, len);
-    header.checksum = calcChecksum(payload, len);
+    if (!offloadChecksum (PROTO_UDP, header.checksum))
+        header.checksum = calcChecksum(payload, len);
     cIPPacket::updateL4Header ((const uint8_t*)&header, sizeof (header));
 }
 
@@ -53,6 +56,7 @@ void cUdpPacket::setDestinationPort (uint16_t port)
 void cUdpPacket::setChecksum (uint16_t checksum)
 {
     header.checksum = htons(checksum);
+    cIPPacket::clearChecksumOffload ();
     cIPPacket::updateL4Header ((const uint8_t*)&header, sizeof (header));
 }
 
@@ -94,9 +98,75 @@ uint16_t cUdpPacket::calcChecksum (const uint8_t* payload, size_t len) const
 
 #ifdef WITH_UNITTESTS
 #include "console.hpp"
+#include "settings.hpp"
 
 void cUdpPacket::unitTest ()
 {
     Console::PrintDebug("-- " __FILE__ " --\n");
+
+    // the checksum completed on transmission must match the calculated one
+    for (bool isIPv6 : {false, true})
+    {
+        const uint8_t payload[] = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+        cUdpPacket calculated (isIPv6), offloaded (isIPv6);
+        for (cUdpPacket* p : {&calculated, &offloaded})
+        {
+            if (isIPv6)
+            {
+                p->setSource (cIPv6 ("1234::1"));
+                p->setDestination (cIPv6 ("5678::2"));
+            }
+            else
+            {
+                p->setSource (cIPv4 ("10.0.0.1"));
+                p->setDestination (cIPv4 ("10.0.0.2"));
+            }
+            p->setSourcePort (1000);
+            p->setDestinationPort (2000);
+        }
+        offloaded.setChecksumOffload (true);
+        calculated.compile (payload, sizeof (payload));
+        offloaded.compile (payload, sizeof (payload));
+
+        const cEthernetPacket& c = calculated.getFirstEthernetPacket ();
+        cEthernetPacket& o = offloaded.getFirstEthernetPacket ();
+        const txOffload& offload = o.getOffload ();
+        BUG_IF_NOT (!c.getOffload ().needsChecksum () && offload.needsChecksum ());
+        BUG_IF_NOT (offload.csumStart == (isIPv6 ? 54 : 34) && offload.csumOffset == 6);
+        BUG_IF_NOT (c.getLength () == o.getLength ());
+
+        uint8_t* frame = o.get ();
+        uint16_t chksum = cInetChecksum::rfc1071 (frame + offload.csumStart, o.getLength () - offload.csumStart);
+        std::memcpy (frame + offload.csumStart + offload.csumOffset, &chksum, sizeof (chksum));
+        BUG_IF_NOT (!std::memcmp (c.get (), frame, c.getLength ()));
+
+        // explicit checksums are not offloaded
+        offloaded.setChecksum (0x1234);
+        BUG_IF_NOT (!o.getOffload ().needsChecksum ());
+    }
+
+    // packets exceeding the MTU are compiled as one super-frame, which is fragmented on transmission
+    {
+        cSettings::cThreadMTU mtu (1500);
+        static uint8_t payload[4000];
+        cUdpPacket fragmented (false), superFrame (false);
+        for (cUdpPacket* p : {&fragmented, &superFrame})
+        {
+            p->setSource (cIPv4 ("10.0.0.1"));
+            p->setDestination (cIPv4 ("10.0.0.2"));
+            p->setChecksumOffload (true);
+        }
+        superFrame.setSegmentationOffload (true);
+        fragmented.compile (payload, sizeof (payload));
+        superFrame.compile (payload, sizeof (payload));
+
+        BUG_IF_NOT (fragmented.getAllEthernetPackets ().size () == 3);
+        BUG_IF_NOT (!fragmented.getFirstEthernetPacket ().getOffload ().needsChecksum ());
+        BUG_IF_NOT (superFrame.getAllEthernetPackets ().size () == 1);
+        const cEthernetPacket& eth = superFrame.getFirstEthernetPacket ();
+        BUG_IF_NOT (eth.getLength () == 14 + 20 + 8 + sizeof (payload));
+        BUG_IF_NOT (eth.getOffload ().needsChecksum () && eth.getOffload ().gsoType == txOffload::GSO_UDP);
+        BUG_IF_NOT (eth.getOffload ().gsoSize == 1480);
+    }
 }
 #endif
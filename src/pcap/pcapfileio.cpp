@@ -18,6 +18,8 @@
 
 
 #include <cstdio>
+#include <cstring>
+#include <cerrno>
 #include <string>
 
 #include "libpcap.h"
@@ -36,6 +38,15 @@ cPcapFileIO::cPcapFileIO ()
     m_path       = NULL;
     m_eof        = false;
     m_firstRead  = false;
+    m_nanoTs     = false;
+    m_format     = PCAP;
+    m_ngFile     = NULL;
+    m_mapPos     = 0;
+    m_readAhead  = 0;
+    m_swapped    = false;
+    m_nanosec    = false;
+    m_pcapng     = false;
+    m_mapData    = NULL;
 }
 
 
@@ -45,20 +56,44 @@ cPcapFileIO::~cPcapFileIO ()
 }
 
 
-bool cPcapFileIO::open (const char* path, bool write)
+bool cPcapFileIO::open (const char* path, bool write, fileFormat format)
 {
-    BUG_ON (m_fileHandle);
+    BUG_ON (m_fileHandle || m_map || m_ngFile);
 
     char errbuf[PCAP_ERRBUF_SIZE] = {0};
 
     if (!write)
     {
-        m_fileHandle = pcap_open_offline (path, errbuf);
         m_firstRead  = true;
+        m_nanoTs     = true;
+        if (!openMapped (path))
+        {
+#ifdef PCAP_TSTAMP_PRECISION_NANO
+            m_fileHandle = pcap_open_offline_with_tstamp_precision (path, PCAP_TSTAMP_PRECISION_NANO, errbuf);
+#else
+            m_fileHandle = pcap_open_offline (path, errbuf);
+            m_nanoTs     = false;
+#endif
+        }
+    }
+    else if (format == PCAPNG)
+    {
+        if (!openPcapng (path))
+            return false;
     }
     else
     {
+#ifdef PCAP_TSTAMP_PRECISION_NANO
+        m_fileHandle = pcap_open_dead_with_tstamp_precision (DLT_EN10MB, 65535,
+                format == PCAP_NS ? PCAP_TSTAMP_PRECISION_NANO : PCAP_TSTAMP_PRECISION_MICRO);
+#else
+        if (format == PCAP_NS)
+        {
+            printError ("nanosecond timestamps are not supported by this version of libpcap");
+            return false;
+        }
         m_fileHandle = pcap_open_dead (DLT_EN10MB, 65535);
+#endif
         if (m_fileHandle)
         {
             m_dumper = pcap_dump_open (m_fileHandle, path);
@@ -73,7 +108,7 @@ bool cPcapFileIO::open (const char* path, bool write)
         }
     }
 
-    if (!m_fileHandle)
+    if (!m_fileHandle && !m_map && !m_ngFile)
     {
         printError (errbuf);
 
@@ -81,6 +116,7 @@ bool cPcapFileIO::open (const char* path, bool write)
     }
 
     m_modeWrite = write;
+    m_format    = format;
     m_path      = path;
     m_eof       = false;
     m_offset.clear ();
@@ -95,60 +131,73 @@ void cPcapFileIO::close ()
         pcap_dump_close (m_dumper);
     if (m_fileHandle)
         pcap_close (m_fileHandle);
+    if (m_ngFile && m_ngFile != stdout)
+        std::fclose (m_ngFile);
+    else if (m_ngFile)
+        std::fflush (m_ngFile);
+
+    // frames of a mapped file stay valid as long as someone else holds a reference to the mapping
+    m_map.reset ();
 
     m_fileHandle = NULL;
     m_dumper     = NULL;
+    m_ngFile     = NULL;
     m_path       = NULL;
     m_fileError  = false;
     m_eof        = false;
 }
 
 
-bool cPcapFileIO::read (struct pcap_pkthdr **header, const u_char **data)
+bool cPcapFileIO::readRecord (struct pcap_pkthdr **header, const u_char **data)
 {
-    BUG_ON (!m_fileHandle);
+    BUG_ON (!m_fileHandle && !m_map);
     BUG_ON (m_modeWrite);
 
     if (!m_fileError && !m_eof)
     {
-        int res = pcap_next_ex(m_fileHandle, header, data);
+        int res;
+        if (m_map)
+        {
+            res     = readMapped ();
+            *header = &m_mapHeader;
+            *data   = m_mapData;
+        }
+        else
+        {
+            res = pcap_next_ex(m_fileHandle, header, data);
+        }
         m_fileError = res == 0 || res == -1;
         m_eof = res == -2;
 
         if (m_fileError)
         {
             Console::PrintError ("Could not read file %s.\n", m_path);
-            printError (pcap_geterr (m_fileHandle));
-        }
-        else
-        {
-            if (m_firstRead)
-            {
-                m_offset.set ((*header)->ts);
-                m_firstRead = false;
-                (*header)->ts.tv_sec = 0;
-                (*header)->ts.tv_usec = 0;
-            }
-            else
-            {
-                cTimeval t((*header)->ts);
-                (*header)->ts = t.sub (m_offset).timeval();
-            }
+            printError (m_map ? "truncated dump file" : pcap_geterr (m_fileHandle));
         }
     }
     return !(m_fileError || m_eof);
 }
 
 
+/*
+ * Returns the next frame and its timestamp relative to the first frame of the file.
+ */
 uint8_t* cPcapFileIO::read (cTimeval* timestamp, int* len)
 {
     struct pcap_pkthdr *header;
     const u_char *pkt_data;
 
-    if (read (&header, &pkt_data))
+    if (readRecord (&header, &pkt_data))
     {
-        timestamp->set (header->ts);
-        *len = (int)header->len;
+        cTimeval t;
+        t.setNs ((uint64_t)header->ts.tv_sec * 1000000000 + (uint64_t)header->ts.tv_usec * (m_nanoTs ? 1 : 1000));
+        if (m_firstRead)
+        {
+            m_offset.set (t);
+            m_firstRead = false;
+        }
+        timestamp->set (t.sub (m_offset));
+        *len = (int)header->caplen;
 
         return (uint8_t*)pkt_data;
     }
@@ -160,25 +209,34 @@ uint8_t* cPcapFileIO::read (cTimeval* timestamp, int* len)
 
 bool cPcapFileIO::write (const cTimeval& timestamp, const uint8_t* frame, int len, bool absoluteTimestamp)
 {
-    BUG_ON (!m_fileHandle);
-    BUG_ON (!m_dumper);
+    BUG_ON (!m_dumper && !m_ngFile);
     BUG_ON (!m_modeWrite);
 
     if (!m_fileError)
     {
-        struct pcap_pkthdr hdr;
-
         if (absoluteTimestamp)
             m_offset.set (timestamp);
         else
             m_offset.add (timestamp);
-        hdr.ts  = m_offset.timeval();
-        hdr.len = hdr.caplen = len;
 
-        pcap_dump ((u_char*)m_dumper, &hdr, (u_char*)frame);
+        if (m_ngFile)
+        {
+            writePcapng (frame, (uint32_t)len);
+            m_fileError = ferror (m_ngFile);
+        }
+        else
+        {
+            struct pcap_pkthdr hdr;
+
+            hdr.ts.tv_sec  = decltype(hdr.ts.tv_sec)(m_offset.s());
+            hdr.ts.tv_usec = decltype(hdr.ts.tv_usec)(m_format == PCAP_NS ? m_offset.ns() % 1000000000 : m_offset.us() % 1000000);
+            hdr.len = hdr.caplen = len;
 
-        // as pcap_dump doesn't return an error code, we have to do error checking on dumpers underlying FILE pointer
-        m_fileError = ferror (pcap_dump_file (m_dumper));
+            pcap_dump ((u_char*)m_dumper, &hdr, (u_char*)frame);
+
+            // as pcap_dump doesn't return an error code, we have to do error checking on dumpers underlying FILE pointer
+            m_fileError = ferror (pcap_dump_file (m_dumper));
+        }
         if (m_fileError)
         {
             Console::PrintError ("Could not write file %s.\n", m_path);
@@ -187,6 +245,326 @@ bool cPcapFileIO::write (const cTimeval& timestamp, const uint8_t* frame, int le
     return !m_fileError;
 }
 
+
+/*
+ * pcapng is written in host byte order: a section header block, one interface description block
+ * with nanosecond resolution and an enhanced packet block per frame.
+ */
+bool cPcapFileIO::openPcapng (const char* path)
+{
+    m_ngFile = std::strcmp (path, "-") ? std::fopen (path, "wb") : stdout;
+    if (!m_ngFile)
+    {
+        printError (std::strerror (errno));
+        return false;
+    }
+
+    std::string blocks;
+    auto put16 = [&blocks](uint16_t v) {blocks.append ((const char*)&v, sizeof (v));};
+    auto put32 = [&blocks](uint32_t v) {blocks.append ((const char*)&v, sizeof (v));};
+
+    // section header block, version 1.0, unknown section length
+    put32 (0x0a0d0d0a);
+    put32 (28);
+    put32 (0x1a2b3c4d);
+    put16 (1);
+    put16 (0);
+    put32 (0xffffffff);
+    put32 (0xffffffff);
+    put32 (28);
+
+    // interface description block, no snap length, option if_tsresol = 9
+    put32 (0x00000001);
+    put32 (32);
+    put16 (DLT_EN10MB);
+    put16 (0);
+    put32 (0);
+    put16 (9);
+    put16 (1);
+    blocks.append ("\x09\0\0\0", 4);
+    put32 (0);          // opt_endofopt
+    put32 (32);
+
+    if (std::fwrite (blocks.data (), blocks.size (), 1, m_ngFile) != 1)
+    {
+        printError (std::strerror (errno));
+        if (m_ngFile != stdout)
+            std::fclose (m_ngFile);
+        m_ngFile = NULL;
+        return false;
+    }
+    return true;
+}
+
+
+void cPcapFileIO::writePcapng (const uint8_t* frame, uint32_t len)
+{
+    static const uint8_t padding[3] = {0};
+    const uint32_t pad   = (4 - (len & 3)) & 3;
+    const uint32_t total = 32 + len + pad;
+    const uint64_t ts    = m_offset.ns ();
+
+    // enhanced packet block of interface 0
+    const uint32_t header[] = {0x00000006, total, 0, (uint32_t)(ts >> 32), (uint32_t)ts, len, len};
+
+    std::fwrite (header, sizeof (header), 1, m_ngFile);
+    std::fwrite (frame, len, 1, m_ngFile);
+    std::fwrite (padding, pad, 1, m_ngFile);
+    std::fwrite (&total, sizeof (total), 1, m_ngFile);
+}
+
+
+static inline uint32_t swap32 (uint32_t v)
+{
+    return (v >> 24) | ((v >> 8) & 0xff00) | ((v << 8) & 0xff0000) | (v << 24);
+}
+
+
+static inline uint16_t swap16 (uint16_t v)
+{
+    return uint16_t((v >> 8) | (v << 8));
+}
+
+
+/*
+ * Maps a classic pcap or pcapng file. Returns false, if the file can't be mapped or has a different format.
+ */
+bool cPcapFileIO::openMapped (const char* path)
+{
+    static const size_t FILE_HEADER_SIZE = 24;
+
+    if (!std::strcmp (path, "-"))
+        return false;
+
+    // frames are modified in place by the output (e.g. random MACs), so copy-on-write is needed
+    std::shared_ptr<cMappedFile> map = std::make_shared<cMappedFile> ();
+    if (!map->open (path, true) || map->size () < FILE_HEADER_SIZE)
+        return false;
+
+    uint32_t magic;
+    uint16_t major;
+    std::memcpy (&magic, map->data (), sizeof (magic));
+    std::memcpy (&major, map->data () + 4, sizeof (major));
+
+    m_pcapng = false;
+    switch (magic)
+    {
+    case 0xa1b2c3d4:
+        m_swapped = false;
+        m_nanosec = false;
+        break;
+    case 0xa1b23c4d:
+        m_swapped = false;
+        m_nanosec = true;
+        break;
+    case 0xd4c3b2a1:
+        m_swapped = true;
+        m_nanosec = false;
+        break;
+    case 0x4d3cb2a1:
+        m_swapped = true;
+        m_nanosec = true;
+        break;
+    case 0x0a0d0d0a:
+        // section header blocks (including the byte order) are processed while reading
+        m_pcapng = true;
+        break;
+    default:
+        return false;
+    }
+    if (!m_pcapng && (m_swapped ? swap16 (major) : major) != 2)
+        return false;
+
+    map->sequential ();
+    m_map       = map;
+    m_mapPos    = m_pcapng ? 0 : FILE_HEADER_SIZE;
+    m_readAhead = 0;
+    m_ngInterfaces.clear ();
+    m_mapHeader.ts.tv_sec  = 0;
+    m_mapHeader.ts.tv_usec = 0;
+    return true;
+}
+
+
+/*
+ * Reads the next record of a mapped file in place. Return values are the same as of pcap_next_ex.
+ */
+int cPcapFileIO::readMapped (void)
+{
+    static const size_t READ_AHEAD = 8 * 1024 * 1024;
+
+    int res = m_pcapng ? readMappedPcapng () : readMappedPcap ();
+
+    // keep the kernel reading ahead of us
+    if (res == 1 && m_mapPos + READ_AHEAD / 2 > m_readAhead)
+    {
+        m_map->willNeed (m_readAhead, READ_AHEAD);
+        m_readAhead += READ_AHEAD;
+    }
+    return res;
+}
+
+
+int cPcapFileIO::readMappedPcap (void)
+{
+    const size_t size = m_map->size ();
+    uint32_t rec[4]; // ts_sec, ts_usec/ts_nsec, caplen, len
+
+    if (m_mapPos == size)
+        return -2;
+    if (size - m_mapPos < sizeof (rec))
+        return -1;
+
+    std::memcpy (rec, m_map->data () + m_mapPos, sizeof (rec));
+    if (m_swapped)
+    {
+        for (auto & v : rec)
+            v = swap32 (v);
+    }
+    if (rec[2] > size - m_mapPos - sizeof (rec))
+        return -1;
+
+    m_mapHeader.ts.tv_sec  = decltype(m_mapHeader.ts.tv_sec)(rec[0]);
+    m_mapHeader.ts.tv_usec = decltype(m_mapHeader.ts.tv_usec)(m_nanosec ? rec[1] : rec[1] * 1000ULL);
+    m_mapHeader.caplen     = rec[2];
+    m_mapHeader.len        = rec[3];
+    m_mapData = m_map->data () + m_mapPos + sizeof (rec);
+    m_mapPos += sizeof (rec) + rec[2];
+
+    return 1;
+}
+
+
+/*
+ * Converts a pcapng timestamp with resolution if_tsresol to nanoseconds.
+ */
+static uint64_t pcapngToNs (uint64_t ts, uint8_t tsresol)
+{
+    static const uint64_t pow10[] = {1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+            100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL};
+    const unsigned exp = tsresol & 0x7f;
+
+    if (tsresol & 0x80) // negative power of 2
+    {
+        if (exp >= 64)
+            return 0;
+        uint64_t frac = ts & ((1ULL << exp) - 1);
+        return (ts >> exp) * 1000000000ULL + (uint64_t)((long double)frac * 1e9L / (long double)(1ULL << exp));
+    }
+    if (exp <= 9)
+        return ts * pow10[9 - exp];
+    if (exp - 9 < sizeof (pow10) / sizeof (pow10[0]))
+        return ts / pow10[exp - 9];
+    return 0;
+}
+
+
+int cPcapFileIO::readMappedPcapng (void)
+{
+    const size_t size = m_map->size ();
+
+    auto get16 = [this](const uint8_t* p) {uint16_t v; std::memcpy (&v, p, sizeof (v)); return m_swapped ? swap16 (v) : v;};
+    auto get32 = [this](const uint8_t* p) {uint32_t v; std::memcpy (&v, p, sizeof (v)); return m_swapped ? swap32 (v) : v;};
+
+    for (;;)
+    {
+        if (m_mapPos == size)
+            return -2;
+        if (size - m_mapPos < 12)
+            return -1;
+
+        const uint8_t* block = m_map->data () + m_mapPos;
+        uint32_t type = get32 (block);
+
+        if (type == 0x0a0d0d0a) // section header block, defines byte order of the section
+        {
+            uint32_t magic;
+            std::memcpy (&magic, block + 8, sizeof (magic));
+            if (magic != 0x1a2b3c4d && magic != 0x4d3c2b1a)
+                return -1;
+            m_swapped = magic != 0x1a2b3c4d;
+            m_ngInterfaces.clear ();
+        }
+
+        uint32_t total = get32 (block + 4);
+        if (total < 12 || total % 4 || total > size - m_mapPos)
+            return -1;
+        m_mapPos += total;
+
+        switch (type)
+        {
+        case 0x00000001: // interface description block
+        {
+            if (total < 20)
+                return -1;
+
+            ngInterface ifc = {6, 0, get32 (block + 12)};
+            for (const uint8_t* opt = block + 16; opt + 4 <= block + total - 4; )
+            {
+                uint16_t code = get16 (opt);
+                uint16_t len  = get16 (opt + 2);
+                if (!code || opt + 4 + len > block + total - 4)
+                    break;
+                if (code == 9 && len >= 1)          // if_tsresol
+                    ifc.tsresol = opt[4];
+                else if (code == 14 && len == 8)    // if_tsoffset
+                {
+                    uint64_t v;
+                    std::memcpy (&v, opt + 4, sizeof (v));
+                    if (m_swapped)
+                        v = ((uint64_t)swap32 ((uint32_t)v) << 32) | swap32 ((uint32_t)(v >> 32));
+                    ifc.tsoffset = (int64_t)v;
+                }
+                opt += 4 + ((len + 3u) & ~3u);
+            }
+            m_ngInterfaces.push_back (ifc);
+            break;
+        }
+        case 0x00000006: // enhanced packet block
+        case 0x00000002: // packet block (obsolete)
+        {
+            if (total < 32)
+                return -1;
+
+            uint32_t id = type == 6 ? get32 (block + 8) : get16 (block + 8);
+            if (id >= m_ngInterfaces.size ())
+                return -1;
+
+            uint64_t ts = ((uint64_t)get32 (block + 12) << 32) | get32 (block + 16);
+            ts = pcapngToNs (ts, m_ngInterfaces[id].tsresol) + (uint64_t)m_ngInterfaces[id].tsoffset * 1000000000ULL;
+
+            m_mapHeader.ts.tv_sec  = decltype(m_mapHeader.ts.tv_sec)(ts / 1000000000ULL);
+            m_mapHeader.ts.tv_usec = decltype(m_mapHeader.ts.tv_usec)(ts % 1000000000ULL);
+            m_mapHeader.caplen     = get32 (block + 20);
+            m_mapHeader.len        = get32 (block + 24);
+            if (m_mapHeader.caplen > total - 32)
+                return -1;
+            m_mapData = block + 28;
+            return 1;
+        }
+        case 0x00000003: // simple packet block, no timestamp
+        {
+            if (total < 16 || m_ngInterfaces.empty ())
+                return -1;
+
+            uint32_t len = get32 (block + 8);
+            uint32_t cap = total - 16;
+            if (m_ngInterfaces[0].snaplen && m_ngInterfaces[0].snaplen < cap)
+                cap = m_ngInterfaces[0].snaplen;
+
+            // the timestamp of the previous packet is kept
+            m_mapHeader.caplen     = len < cap ? len : cap;
+            m_mapHeader.len        = len;
+            m_mapData = block + 12;
+            return 1;
+        }
+        default: // other blocks are not relevant for sending
+            break;
+        }
+    }
+}
+
+
 // FIXME same code as in cPcap!
 void cPcapFileIO::printError (const char* err)
 {
@@ -258,7 +636,7 @@ void cPcapFileIO::unitTest (const char* path)
 
     BUG_IF_NOT (obj.open(file.c_str(), false));
     BUG_IF_NOT (!obj.m_modeWrite);
-    BUG_IF_NOT (obj.m_fileHandle);
+    BUG_IF_NOT (obj.m_map);
     BUG_IF_NOT (!obj.m_dumper);
     BUG_IF_NOT (obj.m_path);
     BUG_IF_NOT (!obj.m_fileError);
@@ -281,11 +659,159 @@ void cPcapFileIO::unitTest (const char* path)
     obj.close ();
     BUG_IF_NOT (!obj.m_modeWrite);
     BUG_IF_NOT (!obj.m_fileHandle);
+    BUG_IF_NOT (!obj.m_map);
     BUG_IF_NOT (!obj.m_dumper);
     BUG_IF_NOT (!obj.m_path);
     BUG_IF_NOT (!obj.m_fileError);
     BUG_IF_NOT (!obj.m_eof);
 
+    // same frames in a file with foreign byte order and nanosecond timestamps
+    const char* swappedFile = "unittest.pcap";
+    std::string content;
+    auto put32 = [&content](uint32_t v) {v = swap32 (v); content.append ((const char*)&v, sizeof (v));};
+    put32 (0xa1b23c4d);
+    put32 (0x00020004); // version 2.4, both fields swapped at once
+    put32 (0);
+    put32 (0);
+    put32 (65535);
+    put32 (DLT_EN10MB);
+    for (unsigned i = 0; i < sizeof (indata) / sizeof (indata[0]); i++)
+    {
+        put32 (uint32_t (1000 + indata[i].t / 1000000));
+        put32 (uint32_t ((indata[i].t % 1000000) * 1000 + i));
+        put32 ((uint32_t)indata[i].binlen);
+        put32 ((uint32_t)indata[i].binlen);
+        content.append ((const char*)indata[i].bin, indata[i].binlen);
+    }
+    for (int truncated = 0; truncated < 2; truncated++)
+    {
+        FILE* fp = std::fopen (swappedFile, "wb");
+        BUG_IF_NOT (fp && std::fwrite (content.data (), content.size () - truncated, 1, fp) == 1);
+        std::fclose (fp);
+
+        BUG_IF_NOT (obj.open (swappedFile, false));
+        BUG_IF_NOT (obj.m_map && !obj.m_fileHandle);
+        BUG_IF_NOT (obj.m_swapped && obj.m_nanosec);
+
+        std::shared_ptr<cMappedFile> map = obj.mapping ();
+        const uint8_t* first = nullptr;
+        n = 0;
+        while ((f = obj.read (&t, &len)) != NULL)
+        {
+            BUG_IF_NOT (t.ns() == indata[n].t * 1000 + n);
+            BUG_IF_NOT ((size_t)len == indata[n].binlen);
+            BUG_IF_NOT (!memcmp (f, indata[n].bin, indata[n].binlen));
+            if (!first)
+                first = f;
+            n++;
+        }
+        BUG_IF_NOT (obj.m_fileError == !!truncated);
+        BUG_IF_NOT (obj.m_eof == !truncated);
+        BUG_IF_NOT ((size_t)n == (sizeof (indata) / sizeof (indata[0])) - truncated);
+        obj.close ();
+
+        // frames stay valid as long as the mapping is referenced
+        BUG_IF_NOT (!memcmp (first, indata[0].bin, indata[0].binlen));
+    }
+
+    // pcapng in foreign byte order with microsecond resolution, timestamp offset, unknown and simple packet blocks
+    content.clear ();
+    put32 (0x0a0d0d0a);
+    put32 (28);
+    put32 (0x1a2b3c4d);
+    put32 (0x00010000);
+    put32 (0xffffffff);
+    put32 (0xffffffff);
+    put32 (28);
+    put32 (0x00000001);
+    put32 (36);
+    put32 (0x00010000);
+    put32 (0);
+    put32 (0x000e0008);
+    put32 (0);
+    put32 (100);
+    put32 (0);
+    put32 (36);
+    put32 (0x00000bad);
+    put32 (12);
+    put32 (12);
+    auto putFrame = [&](unsigned i) {
+        content.append ((const char*)indata[i].bin, indata[i].binlen);
+        content.append ((4 - indata[i].binlen % 4) % 4, '\0');
+    };
+    for (unsigned i = 0; i < sizeof (indata) / sizeof (indata[0]); i++)
+    {
+        uint32_t total = uint32_t (32 + indata[i].binlen + (4 - indata[i].binlen % 4) % 4);
+        put32 (0x00000006);
+        put32 (total);
+        put32 (0);
+        put32 (0);
+        put32 (uint32_t (5000000 + indata[i].t));
+        put32 ((uint32_t)indata[i].binlen);
+        put32 ((uint32_t)indata[i].binlen);
+        putFrame (i);
+        put32 (total);
+    }
+    uint32_t total = uint32_t (16 + indata[0].binlen + (4 - indata[0].binlen % 4) % 4);
+    put32 (0x00000003);
+    put32 (total);
+    put32 ((uint32_t)indata[0].binlen);
+    putFrame (0);
+    put32 (total);
+    {
+        FILE* fp = std::fopen (swappedFile, "wb");
+        BUG_IF_NOT (fp && std::fwrite (content.data (), content.size (), 1, fp) == 1);
+        std::fclose (fp);
+    }
+    BUG_IF_NOT (obj.open (swappedFile, false));
+    BUG_IF_NOT (obj.m_map && obj.m_pcapng);
+    const int cnt = (int)(sizeof (indata) / sizeof (indata[0]));
+    n = 0;
+    while ((f = obj.read (&t, &len)) != NULL)
+    {
+        // the simple packet block contains the first frame and has the timestamp of the last frame
+        unsigned i = n < cnt ? n : 0;
+        BUG_IF_NOT (obj.m_swapped);
+        BUG_IF_NOT (t.ns() == indata[n < cnt ? n : cnt - 1].t * 1000);
+        BUG_IF_NOT ((size_t)len == indata[i].binlen);
+        BUG_IF_NOT (!memcmp (f, indata[i].bin, indata[i].binlen));
+        n++;
+    }
+    BUG_IF_NOT (obj.m_eof && n == cnt + 1);
+    BUG_IF_NOT (obj.m_offset.s() == 105);
+    obj.close ();
+    BUG_IF_NOT (pcapngToNs (3, 0x83) == 375000000);
+    BUG_IF_NOT (pcapngToNs (12345, 3) == 12345000000ULL);
+    BUG_IF_NOT (pcapngToNs (12345, 12) == 12);
+    std::remove (swappedFile);
+
+    // write and read back with nanosecond timestamps
+    const char* outFile = "unittest.out";
+    for (fileFormat format : {PCAP, PCAP_NS, PCAPNG})
+    {
+        BUG_IF_NOT (obj.open (outFile, true, format));
+        for (unsigned i = 0; i < sizeof (indata) / sizeof (indata[0]); i++)
+        {
+            t.setNs (1000000000000ULL + indata[i].t * 1000 + i);
+            BUG_IF_NOT (obj.write (t, indata[i].bin, (int)indata[i].binlen));
+        }
+        obj.close ();
+
+        BUG_IF_NOT (obj.open (outFile, false));
+        BUG_IF_NOT (obj.m_map && obj.m_pcapng == (format == PCAPNG));
+        n = 0;
+        while ((f = obj.read (&t, &len)) != NULL)
+        {
+            BUG_IF_NOT (t.ns() == indata[n].t * 1000 + (format == PCAP ? 0 : n));
+            BUG_IF_NOT ((size_t)len == indata[n].binlen);
+            BUG_IF_NOT (!memcmp (f, indata[n].bin, indata[n].binlen));
+            n++;
+        }
+        BUG_IF_NOT (obj.m_eof && (size_t)n == sizeof (indata) / sizeof (indata[0]));
+        obj.close ();
+    }
+    std::remove (outFile);
+
     for (unsigned i = 0; i < sizeof (indata) / sizeof (indata[0]); i++)
     {
         delete[] (indata[i].bin);
@@ -22,9 +22,21 @@
 
 
 #include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <vector>
 
 #include "libpcap.h"
 #include "timeval.hpp"
+#include "mappedfile.hpp"
+
+/*
+ * Classic pcap files (both byte orders, micro- or nanosecond timestamps) and pcapng files are mapped
+ * into memory and read in place, i.e. read() returns pointers into the mapping. The mapping can be
+ * modified (copy-on-write) and stays valid as long as a reference to mapping() exists, even after close().
+ * All other formats and stdin ("-") are read via libpcap; those frames are only valid until the next read.
+ * Timestamps are read with nanosecond resolution (libpcap: if supported by its version).
+ */
 
 class cPcapFileIO
 {
@@ -35,16 +47,30 @@ public:
     static void unitTest (const char* path);
 #endif
 
-    bool open (const char* path, bool write = false);
+    enum fileFormat
+    {
+        PCAP,       // classic pcap, microsecond timestamps
+        PCAP_NS,    // classic pcap, nanosecond timestamps
+        PCAPNG      // pcapng, nanosecond timestamps
+    };
+
+    bool open (const char* path, bool write = false, fileFormat format = PCAP);
     void close ();
-    bool read (struct pcap_pkthdr **, const u_char **);
     uint8_t* read (cTimeval* timestamp, int* len);
     bool write (const cTimeval& timestamp, const uint8_t* frame, int len, bool absoluteTimestamp = true);
     bool error () const {return m_fileError;};
     const char* name (void) const {return m_path;};
+    const std::shared_ptr<cMappedFile>& mapping (void) const {return m_map;};
 
 private:
     void printError (const char* err);
+    bool readRecord (struct pcap_pkthdr **, const u_char **);
+    bool openMapped (const char* path);
+    int readMapped (void);
+    int readMappedPcap (void);
+    int readMappedPcapng (void);
+    bool openPcapng (const char* path);
+    void writePcapng (const uint8_t* frame, uint32_t len);
 
     bool m_modeWrite;
     pcap_t *m_fileHandle;
@@ -54,6 +80,26 @@ private:
     bool m_eof;
     cTimeval m_offset;
     bool m_firstRead;
+    bool m_nanoTs;          // tv_usec of read records contains nanoseconds
+    fileFormat m_format;
+    FILE* m_ngFile;         // pcapng is written without libpcap
+
+    std::shared_ptr<cMappedFile> m_map;
+    size_t m_mapPos;        // offset of next record
+    size_t m_readAhead;     // end of the area, which was already advised to be read
+    bool m_swapped;         // file has other byte order than host
+    bool m_nanosec;         // timestamps in nanoseconds
+    bool m_pcapng;
+
+    struct ngInterface
+    {
+        uint8_t  tsresol;
+        int64_t  tsoffset;  // seconds
+        uint32_t snaplen;
+    };
+    std::vector<ngInterface> m_ngInterfaces; // of current section
+    struct pcap_pkthdr m_mapHeader;
+    const u_char* m_mapData;
 };
 
 #endif /* PCAPFILEIO_HPP_ */
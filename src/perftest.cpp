@@ -24,15 +24,89 @@
 #include "bug.hpp"
 #include "console.hpp"
 #include "instructionparser.hpp"
+#include "inetchecksum.hpp"
+#include "random.hpp"
 #include "sleep.hpp"
 #include "settings.hpp"
 
 
+static void checksumPerformance (void)
+{
+    const size_t sizes[] = {20, 64, 256, 576, 1500, 4096, 9000, 16384, 65536};
+    const size_t bytesPerRun = 256 * 1024 * 1024;
+    static uint8_t buf[65536 + 1];
+    for (size_t n = 0; n < sizeof (buf); n++)
+        buf[n] = (uint8_t)(n * 7);
+
+    fprintf (stderr, "internet checksum throughput [GB/s]\n%8s", "size");
+    for (int impl = cInetChecksum::GENERIC; impl <= cInetChecksum::AVX2; impl++)
+    {
+        if (cInetChecksum::isSupported ((cInetChecksum::implementation)impl))
+            fprintf (stderr, " %9s", cInetChecksum::getName ((cInetChecksum::implementation)impl));
+    }
+    fprintf (stderr, "\n");
+
+    for (size_t size : sizes)
+    {
+        // aligned and misaligned start
+        for (size_t offset = 0; offset < 2; offset++)
+        {
+            fprintf (stderr, "%6zu+%zu", size, offset);
+            for (int impl = cInetChecksum::GENERIC; impl <= cInetChecksum::AVX2; impl++)
+            {
+                if (!cInetChecksum::isSupported ((cInetChecksum::implementation)impl))
+                    continue;
+                cInetChecksum::use ((cInetChecksum::implementation)impl);
+
+                const size_t loops = bytesPerRun / size;
+                volatile uint16_t result = 0;
+                auto t1 = std::chrono::high_resolution_clock::now();
+                for (size_t i = 0; i < loops; i++)
+                {
+                    result = cInetChecksum::rfc1071 (buf + offset, size);
+                }
+                auto t2 = std::chrono::high_resolution_clock::now();
+                (void)result;
+                auto elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1);
+                fprintf (stderr, " %9.2f", (double)(loops * size) / (double)elapsed_ns.count());
+            }
+            fprintf (stderr, "\n");
+        }
+    }
+    cInetChecksum::use (cInetChecksum::getBest ());
+}
+
+static void randomPerformance (void)
+{
+    const size_t loops = 32 * 1024 * 1024;
+    static uint8_t buf[1500];
+    volatile uint64_t result = 0;
+
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < loops; i++)
+        result = cRandom::rand32 (1, 1000);
+    auto t2 = std::chrono::high_resolution_clock::now();
+    fprintf (stderr, "random values 1...1000: %.2f ns\n",
+            (double)std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count() / (double)loops);
+
+    const size_t fills = 1024 * 1024;
+    t1 = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < fills; i++)
+        cRandom::fill (buf, sizeof (buf));
+    t2 = std::chrono::high_resolution_clock::now();
+    result = buf[0];
+    (void)result;
+    fprintf (stderr, "random payload: %.2f GB/s\n",
+            (double)(fills * sizeof (buf)) / (double)std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count());
+}
+
 int main (void)
 {
     Console::SetPrintLevel(Console::Debug);
     cRandom::create();
     tcppump::SleepInit ();
+    checksumPerformance ();
+    randomPerformance ();
     try
     {
         BUG_ON (!cSettings::get().setMyIPv4 ("1.2.3.4"));
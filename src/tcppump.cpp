@@ -26,6 +26,10 @@
 #include <cstdlib>
 #include <chrono>
 #include <new>          // std::bad_alloc
+#include <thread>
+#include <exception>
+#include <memory>
+#include <algorithm>
 
 #include "tcppump.hpp"
 
@@ -42,7 +46,13 @@
 #include "scheduler.hpp"
 #include "preprocessor.hpp"
 #include "output.hpp"
+#include "ratelimiter.hpp"
 #include "random.hpp"
+#include "packetcache.hpp"
+#include "packetstream.hpp"
+#if !HAVE_WINDOWS
+#include "realtime.hpp"
+#endif
 
 
 cTcpPump::cTcpPump(const char* name, const char* brief, const char* usage, const char* description,
@@ -55,6 +65,9 @@ cTcpPump::cTcpPump(const char* name, const char* brief, const char* usage, const
     options.repeat    = 1;
     options.timeRes   = "m";
     options.outFormat = "pcap";
+    options.txBatch   = 64;
+    options.txThreads = 1;
+    options.jobs      = (int)std::max (1u, std::thread::hardware_concurrency ());
 
     timeScale       = 0;
     realtimeMode    = false;
@@ -96,6 +109,19 @@ cTcpPump::cTcpPump(const char* name, const char* brief, const char* usage, const
             "A value of 2.0 slows playback to half speed, while 0.5 plays it at twice the speed. "
             "A value of 0 plays the file as quickly as possible."
             , &options.pcap, &options.pcapScaling);
+    addCmdLineOption (true, "cache", "FILE",
+            "Use a precompiled cache for script files (-s). If FILE is up to date, the packets are loaded from it "
+            "without any parsing. Otherwise the scripts are compiled and the result is written to FILE. "
+            "The cache is invalidated by changes of the scripts and of options that affect the packets (e.g. -t, -d, --mymac, --mtu). "
+            "Note: The cache contains the resolved packets, including all random values. "
+            "Default FILE is the first script file with extension .pumpc.", &options.cache, &options.cacheFile);
+    addCmdLineOption (true, 0, "stream",
+            "Compile and send the packets of script or PCAP files piecewise. The memory usage doesn't depend on the size of the files "
+            "and sending starts immediately. Errors in the files are detected when they are reached. "
+            "Streaming is used automatically for input from stdin (-s - or --pcap -).", &options.stream);
+    addCmdLineOption (true, 'j', "jobs", "N",
+            "Compile script files (-s) by N threads. The packets are identical to the ones of a single thread. "
+            "Default: N = number of available cpus. If N = 1, scripts are compiled by the main thread.", &options.jobs);
     addCmdLineOption (true, 'l', "loop", "N",
             "Send all files/packets N times. Default: N = 1. If N = 0, packets will be sent infinitely "
             "until Ctrl+c is pressed.", &options.repeat);
@@ -104,19 +130,88 @@ cTcpPump::cTcpPump(const char* name, const char* brief, const char* usage, const
             &options.delay);
     addCmdLineOption (true, 't', "resolution", "RESOLUTION",
             "Set the time resolution for packet transmission. This affects -d parameter as well as all timestamps in script files. "
-            "Possible values are 'u'= microseconds, 'm'= milliseconds(default), 'c'= centiseconds and 's'= seconds",
+            "Possible values are 'n'= nanoseconds, 'u'= microseconds, 'm'= milliseconds(default), 'c'= centiseconds and 's'= seconds",
             &options.timeRes);
+    addCmdLineOption (true, 0, "rate", "RATE",
+            "Send packets with a constant rate and ignore their timestamps. "
+            "RATE is either a packet rate '<n>pps', a bit rate '<n>bps' or a percentage of the link speed '<n>%'. "
+            "The prefixes k, M and G are supported, e.g. 3.2Gbps or 10kpps. "
+            "Bit rates include preamble, SFD, FCS and inter-frame gap of each frame.", &options.rate);
     addCmdLineOption (true, 'w', nullptr, "OUTFILE",
             "Write raw packet data to OUTFILE, or to the standard output if OUTFILE is set to '-'.", &options.outfile);
     addCmdLineOption (true, 'F', nullptr, "FORMAT",
             "Set the file format of the output capture file written using the -w option. "
-            "Supported formats are: 'pcap' (default), 'text', 'hexstream', 'hexdump'", &options.outFormat);
+            "Supported formats are: 'pcap' (default), 'pcapns' (pcap with nanosecond timestamps), 'pcapng', 'text', 'hexstream', 'hexdump'", &options.outFormat);
     addCmdLineOption (true, 'a', "arp",
             "Resolve the destination MAC address for IPv4 packets using ARP. "
             "If the destination MAC address is omitted in IPv4 packets, it will be automatically determined via ARP.",
             &options.arp);
     addCmdLineOption (true, 0, "predictable-random",
             "Use a simple sequence instead of random numbers to generate predictable values.", &options.testPredictableRandom);
+#if !HAVE_WINDOWS
+    addCmdLineOption (true, 0, "no-tx-ring",
+            "Don't use the memory mapped transmit ring of the kernel (PACKET_MMAP). "
+            "By default, packets are handed over to the kernel in batches, unless they are sent time-triggered. "
+            "With this option packets are sent via sendmmsg.", &options.noTxRing);
+    addCmdLineOption (true, 0, "tx-batch", "N",
+            "Hand over up to N packets to the kernel at once, if packets are not sent time-triggered. "
+            "Default: N = 64. If N = 1, each packet is sent with a separate system call.", &options.txBatch);
+    addCmdLineOption (true, 0, "tx-threads", "N",
+            "Send packets in parallel by N threads, if packets are not sent time-triggered. "
+            "Each thread has its own socket and is pinned to a cpu of the network adapter's NUMA node. "
+            "Note: The order of the packets is not preserved. Default: N = 1", &options.txThreads);
+    addCmdLineOption (true, 0, "qdisc-bypass",
+            "Bypass the queuing discipline layer of the kernel (PACKET_QDISC_BYPASS). "
+            "Packets are passed directly to the driver and are dropped if its queue is full.", &options.qdiscBypass);
+    addCmdLineOption (true, 0, "csum-offload",
+            "Leave the UDP and TCP checksums to the kernel or network adapter (PACKET_VNET_HDR). "
+            "Packets are compiled with the checksum of the pseudo header only, which saves the calculation over the payload. "
+            "Packets with explicit checksum (chksum), fragmented and embedded packets keep their complete checksum. "
+            "Not used, if packets are written to a file (-w) or sent via AF_XDP.", &options.csumOffload);
+    addCmdLineOption (true, 0, "gso",
+            "Send UDP and TCP packets exceeding the MTU as one super-frame, which is split by the kernel or network adapter "
+            "(generic segmentation offload). TCP packets are split into segments of MTU size with consecutive sequence numbers, "
+            "UDP packets into IP fragments. Implies --csum-offload.", &options.gso);
+    addCmdLineOption (true, 0, "catch-up", "POLICY",
+            "Set the behavior, if time-triggered transmission falls behind schedule by more than 1 ms. "
+            "'burst' (default) sends the delayed packets as fast as possible, "
+            "'skip' drops delayed packets until the schedule is met again and "
+            "'rebase' shifts the schedule of all following packets by the delay.", &options.catchUp);
+#if HAVE_SO_TXTIME
+    addCmdLineOption (true, "launch-time", "LEAD",
+            "Pass the send time of each packet as launch time to the kernel (SO_TXTIME) and hand over the packets "
+            "LEAD microseconds in advance (default 1000). Requires the 'etf' qdisc with clockid CLOCK_TAI on the interface, "
+            "e.g. 'tc qdisc add dev IFC root etf clockid CLOCK_TAI delta 200000'. "
+            "Packets that miss their launch time are dropped by the kernel.",
+            &options.launchTime, &options.launchLead);
+#endif
+#if !HAVE_WINDOWS
+    addCmdLineOption (true, "tx-timestamps", "CSVFILE",
+            "Measure the deviation of the real transmission from the schedule via transmit timestamps of the kernel "
+            "(SO_TIMESTAMPING), if packets are sent time-triggered. Mean, percentiles and maximum are reported "
+            "for the time the packets entered the qdisc and the time they were passed to the driver. "
+            "Optionally, the timestamps of all packets are written to CSVFILE.",
+            &options.txTimestamps, &options.txTimestampsCsv);
+    addCmdLineOption (true, "rt", "CPU",
+            "Realtime profile: Packets are sent by a dedicated thread, which is pinned to CPU and runs with SCHED_FIFO priority. "
+            "All memory is locked and prefaulted after the packets are compiled. "
+            "By default, the first isolated cpu (isolcpus) or the last available cpu is used. "
+            "Requires the capabilities CAP_SYS_NICE and CAP_IPC_LOCK.",
+            &options.rt, &options.rtCpu);
+    addCmdLineOption (true, 0, "hugepages",
+            "Store the compiled packets in hugepages to reduce TLB misses when sending large packet sets. "
+            "Falls back to transparent hugepages, if no hugepages are reserved (see /proc/sys/vm/nr_hugepages).",
+            &options.hugepages);
+#endif
+#endif
+#if HAVE_IF_XDP
+    addCmdLineOption (true, "xdp", "MODE",
+            "Send packets via AF_XDP socket. No XDP program is needed. "
+            "MODE can be 'copy' (works with every driver, e.g. veth), 'zerocopy' (requires driver support) or 'auto' (default), "
+            "which uses zero-copy mode if supported by the driver. "
+            "If packets are sent repeatedly (-l), they are copied only once into the kernel shared memory.",
+            &options.xdp, &options.xdpMode);
+#endif
 }
 
 cTcpPump::~cTcpPump()
@@ -156,17 +251,20 @@ int cTcpPump::execute (const std::vector<std::string>& args)
 
     switch (options.timeRes[0])
     {
-    case 'u':    // microseconds
+    case 'n':    // nanoseconds
         timeScale = 1;
         break;
-    case 'm':   // milliseconds
+    case 'u':    // microseconds
         timeScale = 1000;
         break;
+    case 'm':   // milliseconds
+        timeScale = 1000000;
+        break;
     case 'c':   // centiseconds
-        timeScale = 10000;
+        timeScale = 10000000;
         break;
     case 's':  // seconds
-        timeScale = 1000000;
+        timeScale = 1000000000;
         break;
     default:
         Console::PrintError ("Unsupported time resolution '%c'\n", options.timeRes[0]);
@@ -224,9 +322,133 @@ int cTcpPump::execute (const std::vector<std::string>& args)
         return -1;
     }
 
+    // input from stdin can only be read piecewise
+    bool readStdin = false;
+    for (const auto & in : args)
+        readStdin |= in == "-";
+    if ((options.script || options.pcap) && readStdin)
+        options.stream = 1;
+    if (options.stream)
+    {
+        if (!options.script && !options.pcap)
+        {
+            Console::PrintError ("Option --stream requires option -s or --pcap\n");
+            return -1;
+        }
+        if (options.cache)
+        {
+            Console::PrintError ("Options --stream and --cache can't be used at the same time.\n");
+            return -1;
+        }
+        if (readStdin && options.repeat != 1)
+        {
+            Console::PrintError ("Input from stdin can't be repeated (-l)\n");
+            return -1;
+        }
+    }
+
+    if (options.txBatch < 1 || options.txBatch > 1024)
+    {
+        Console::PrintError ("Batch size must be between 1 and 1024\n");
+        return -1;
+    }
+
+    if (options.txThreads < 1 || options.txThreads > 256)
+    {
+        Console::PrintError ("Number of tx threads must be between 1 and 256\n");
+        return -1;
+    }
+    if (options.jobs < 1 || options.jobs > 256)
+    {
+        Console::PrintError ("Number of jobs must be between 1 and 256\n");
+        return -1;
+    }
+
+#if !HAVE_WINDOWS
+    int rtCpu = -1;
+    if (options.rtCpu)
+    {
+        char* end;
+        rtCpu = (int)std::strtol (options.rtCpu, &end, 10);
+        if (*end || end == options.rtCpu || rtCpu < 0)
+        {
+            Console::PrintError ("Invalid cpu '%s'\n", options.rtCpu);
+            return -1;
+        }
+    }
+    cSettings::get().setHugepages (!!options.hugepages);
+#endif
+
     if (options.ifc)
     {
-        ifc = cNetInterface::create (options.ifc, !options.outfile);
+        cNetInterface::txOptions txOpt;
+        txOpt.noTxRing    = !!options.noTxRing;
+        txOpt.txBatch     = (size_t)options.txBatch;
+        txOpt.txThreads   = (unsigned)options.txThreads;
+        txOpt.qdiscBypass = !!options.qdiscBypass;
+        txOpt.txTimestamps    = !!options.txTimestamps;
+        txOpt.tsCsvFile       = options.txTimestampsCsv;
+        if (options.launchTime)
+        {
+            txOpt.launchTime = true;
+            if (options.launchLead)
+            {
+                char* end;
+                long lead = std::strtol (options.launchLead, &end, 10);
+                if (*end || lead < 1)
+                {
+                    Console::PrintError ("Invalid launch time lead '%s'\n", options.launchLead);
+                    return -1;
+                }
+                txOpt.launchLead = (uint64_t)lead;
+            }
+        }
+        if (options.catchUp)
+        {
+            std::string policy (options.catchUp);
+            if (policy == "burst")
+                txOpt.catchUp = cNetInterface::txOptions::CATCHUP_BURST;
+            else if (policy == "skip")
+                txOpt.catchUp = cNetInterface::txOptions::CATCHUP_SKIP;
+            else if (policy == "rebase")
+                txOpt.catchUp = cNetInterface::txOptions::CATCHUP_REBASE;
+            else
+            {
+                Console::PrintError ("Unsupported catch-up policy '%s'\n", options.catchUp);
+                return -1;
+            }
+        }
+        if (options.xdp)
+        {
+            std::string mode (options.xdpMode ? options.xdpMode : "auto");
+            if (mode == "auto")
+                txOpt.xsk = cNetInterface::txOptions::XSK_AUTO;
+            else if (mode == "copy")
+                txOpt.xsk = cNetInterface::txOptions::XSK_COPY;
+            else if (mode == "zerocopy")
+                txOpt.xsk = cNetInterface::txOptions::XSK_ZEROCOPY;
+            else
+            {
+                Console::PrintError ("Unsupported AF_XDP mode '%s'\n", options.xdpMode);
+                return -1;
+            }
+        }
+        // incomplete checksums and super-frames are only accepted by the packet socket
+        if (options.csumOffload || options.gso)
+        {
+            if (options.outfile || options.xdp)
+            {
+                Console::PrintVerbose ("Warning: Checksum and segmentation offload are not used for output to a file or via AF_XDP.\n");
+            }
+            else
+            {
+                txOpt.csumOffload = true;
+                cSettings::get().setChecksumOffload (true);
+                cSettings::get().setSegmentationOffload (!!options.gso);
+            }
+        }
+
+        ifc = cNetInterface::create (options.ifc, !options.outfile, txOpt);
         if (!ifc->isReady())
             return -1;
     }
@@ -280,13 +502,88 @@ int cTcpPump::execute (const std::vector<std::string>& args)
     }
 
 
-    activeDelay.setUs((uint64_t)options.delay * (uint64_t)timeScale);
+    activeDelay.setNs((uint64_t)options.delay * (uint64_t)timeScale);
+
+    cRateLimiter rateLimit;
+    if (options.rate)
+    {
+        if (!rateLimit.parse (options.rate))
+        {
+            Console::PrintError ("Invalid rate '%s'\n", options.rate);
+            return -1;
+        }
+        if (rateLimit.isRelative ())
+        {
+            if (!ifc || options.outfile)
+            {
+                Console::PrintError ("Rate relative to link speed requires option -i\n");
+                return -1;
+            }
+            if (!rateLimit.setLinkSpeed (ifc->getLinkSpeed ()))
+            {
+                Console::PrintError ("Could not determine link speed of %s. Use an absolute rate.\n", ifc->getName ());
+                return -1;
+            }
+        }
+    }
+
+    // the key of the cache covers everything that affects the compiled and resolved packets
+    std::string cacheName;
+    if (options.cache)
+    {
+        if (!options.script)
+        {
+            Console::PrintError ("Option --cache requires option -s\n");
+            return -1;
+        }
+        cacheName = options.cacheFile ? options.cacheFile : cPacketCache::defaultName (args[0].c_str ());
+    }
+    cPacketCache cache (cacheName.c_str ());
+    if (options.cache)
+    {
+        for (const auto & file : args)
+        {
+            // not readable scripts are reported by the compiler
+            if (!cache.addFileKey (file.c_str ()))
+                options.cache = 0;
+        }
+
+        const cSettings& settings = cSettings::get ();
+        std::string mac, ip, ipv6;
+        if (settings.isMacSet ())
+            settings.getMyMAC ().get (mac);
+        if (settings.isIPSet ())
+            settings.getMyIPv4 ().get (ip);
+        if (settings.isIPv6Set ())
+            settings.getMyIPv6 ().get (ipv6);
+        unsigned mtu   = settings.getMyMTU ();
+        uint64_t delay = activeDelay.ns ();
+
+        cache.addKey (mac);
+        cache.addKey (ip);
+        cache.addKey (ipv6);
+        cache.addKey (options.ifc ? options.ifc : "");
+        cache.addKey (&mtu, sizeof (mtu));
+        cache.addKey (&timeScale, sizeof (timeScale));
+        cache.addKey (&delay, sizeof (delay));
+        cache.addKey (options.overwriteDMAC ? options.overwriteDMAC : "");
+        cache.addKey (&options.arp, sizeof (options.arp));
+        cache.addKey (&options.testPredictableRandom, sizeof (options.testPredictableRandom));
+        const bool csumOffload = settings.useChecksumOffload ();
+        cache.addKey (&csumOffload, sizeof (csumOffload));
+        const bool gso = settings.useSegmentationOffload ();
+        cache.addKey (&gso, sizeof (gso));
+    }
 
     // Install a signal handler
     cSignal::sigintEnable ();
 
     cCompiler compiler (options.script ? cCompiler::SCRIPT : options.pcap ? cCompiler::PCAP : cCompiler::PACKET,
             activeDelay, timeScale, !!options.arp, pcapScale);
+    compiler.setJobs ((unsigned)options.jobs);
+    // frames modified in place would turn the copy-on-write mapping of a streamed pcap file
+    // into anonymous memory, which is never released
+    compiler.setCopyMappedFrames (options.stream && (options.overwriteDMAC || options.randSrcMac || options.randDstMac));
     cFilter    filter (options.overwriteDMAC ? &overwriteDMAC : nullptr);
     cScheduler scheduler;
 
@@ -294,24 +591,56 @@ int cTcpPump::execute (const std::vector<std::string>& args)
     {
         // Packet-flow-chain: args --> compiler -> filter -> resolver -> scheduler -> packetData
         // Each step may alter the content of packetData
-        cPacketData& packetData = compiler  << args;
-
-        if (!options.outfile && !ifc->open ())
-            return -1;
+        // An up to date cache replaces the whole chain.
+        // When streaming, the chain is executed piecewise by a producer thread while the packets are sent.
+        std::unique_ptr<cResolver> resolver (ifc ? new cResolver (*ifc) : nullptr);
+        cPacketStream stream (compiler, filter, resolver.get (), scheduler);
+        cPacketData cachedData;
+        cPacketData* packetData = nullptr;
+        bool hasUserTimestamps;
+
+        if (options.stream)
+        {
+            if (!options.outfile && !ifc->open ())
+                return -1;
 
-        filter << packetData;
-        if (ifc)
+            stream.start (args, options.repeat);
+            hasUserTimestamps = stream.hasUserTimestamps ();
+        }
+        else
         {
-            cResolver resolver (*ifc);
-            resolver << packetData;
+            bool cached = options.cache && cache.load (cachedData);
+            packetData = cached ? &cachedData : &(compiler << args);
+
+            if (!options.outfile && !ifc->open ())
+                return -1;
+
+            if (!cached)
+            {
+                filter << *packetData;
+                if (resolver)
+                    *resolver << *packetData;
+                scheduler << *packetData;
+
+                if (options.cache)
+                {
+                    if (cache.store (*packetData))
+                        Console::PrintMoreVerbose ("Wrote cache '%s'\n", cache.getName ());
+                    else
+                        Console::PrintError ("Warning: Could not write cache '%s'\n", cache.getName ());
+                }
+            }
+            else
+                Console::PrintMoreVerbose ("Loaded packets from cache '%s'\n", cache.getName ());
+
+            hasUserTimestamps = packetData->hasUserTimestamps;
         }
-        scheduler << packetData;
 
         // if user has set a default packet delay, real-time mode is ALWAYS enabled
         if (!activeDelay.isNull ())
             realtimeMode = true;
         else
-            realtimeMode = packetData.hasUserTimestamps;
+            realtimeMode = hasUserTimestamps;
 
         // prepare backend for packet output
         cPreprocessor preprop(options.randSrcMac, options.randDstMac);
@@ -320,20 +649,71 @@ int cTcpPump::execute (const std::vector<std::string>& args)
             backend.prepare (options.outfile, options.outFormat, options.repeat);
         else
             backend.prepare (*ifc, realtimeMode, options.repeat);
+        if (options.rate)
+            backend.setRateLimit (&rateLimit);
 
-        Console::PrintMoreVerbose ("Will send %zu packets\n", packetData.getPacketCnt());
+        if (packetData)
+            Console::PrintMoreVerbose ("Will send %zu packets\n", packetData->getPacketCnt());
+        else
+            Console::PrintMoreVerbose ("Streaming packets\n");
         if (options.repeat > 1)
             Console::PrintMoreVerbose ("Repeating %d times\n", options.repeat);
         else if (options.repeat == 0)
             Console::PrintMoreVerbose ("Repeating infinitely\n");
-        if (realtimeMode)
+        if (options.rate)
+        {
+            if (rateLimit.getPacketRate () > 0.0)
+                Console::PrintMoreVerbose ("Rate limit %.0f packets/s\n\n", rateLimit.getPacketRate ());
+            else
+                Console::PrintMoreVerbose ("Rate limit %f Mbit/s\n\n", rateLimit.getBitRate () / 1000000.0);
+        }
+        else if (realtimeMode)
             Console::PrintMoreVerbose ("Real-time mode with default delay between packets %" PRIu64 " usecs\n\n", activeDelay.us());
         else
             Console::PrintMoreVerbose ("Max. throughput mode\n\n");
 
 
         // send all the packets
-        backend << packetData;
+        auto sendAll = [&]
+        {
+            if (packetData)
+                backend << *packetData;
+            else
+                backend << stream;
+        };
+#if !HAVE_WINDOWS
+        if (options.rt)
+        {
+            int cpu = rtCpu >= 0 ? rtCpu : tcppump::RealtimeDefaultCpu ();
+            Console::PrintMoreVerbose ("Sending from realtime thread on cpu %d with SCHED_FIFO priority %d\n\n",
+                    cpu, tcppump::REALTIME_PRIORITY);
+
+            std::exception_ptr error = nullptr;
+            std::thread sender ([&]
+            {
+                // the packets are compiled, so all memory (including the stack of this thread) can be locked now.
+                // Faulting in all pages takes a while, which must not happen with realtime priority on the pinned cpu.
+                tcppump::RealtimeLockMemory ();
+                tcppump::RealtimePrefaultStack ();
+                tcppump::RealtimeEnter (cpu, tcppump::REALTIME_PRIORITY);
+                try
+                {
+                    sendAll ();
+                }
+                catch (...)
+                {
+                    error = std::current_exception ();
+                }
+            });
+            sender.join ();
+
+            // exceptions of the sender thread are handled here
+            if (error)
+                std::rethrow_exception (error);
+        }
+        else
+#endif
+        sendAll ();
 
         uint64_t sentPackets, sentBytes; double duration;
         backend.statistic (sentPackets, sentBytes, duration);
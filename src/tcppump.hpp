@@ -1,7 +1,7 @@
 // SPDX-License-Identifier: GPL-3.0-only
 /*
  * TCPPUMP <https://github.com/amartin755/tcppump>
- * Copyright (C) 2012-2025 Andreas Martin (netnag@mailbox.org)
+ * Copyright (C) 2012-2026 Andreas Martin (netnag@mailbox.org)
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -47,6 +47,27 @@ struct appOptions
     int          testPredictableRandom;
     unsigned     mtu;
     const char*  outFormat;
+    int          noTxRing;
+    int          txBatch;
+    int          xdp;
+    const char*  xdpMode;
+    int          txThreads;
+    int          qdiscBypass;
+    int          csumOffload;
+    int          gso;
+    const char*  catchUp;
+    const char*  rate;
+    int          launchTime;
+    const char*  launchLead;
+    int          txTimestamps;
+    const char*  txTimestampsCsv;
+    int          rt;
+    const char*  rtCpu;
+    int          hugepages;
+    int          cache;
+    const char*  cacheFile;
+    int          stream;
+    int          jobs;
 };
 
 class cInterface;
@@ -72,7 +93,7 @@ private:
     appOptions options;
     cPcapFileIO outfile;
     cTimeval activeDelay;
-    unsigned timeScale; // 1 = us, 1000 = ms, 1000000 = sec
+    unsigned timeScale; // 1 = ns, 1000 = us, 1000000 = ms, 1000000000 = sec
     bool realtimeMode;  // if true, packets will be sent time triggered
 
     cNetInterface* ifc;
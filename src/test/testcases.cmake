@@ -1172,6 +1172,32 @@ add_test(NAME "script-01--ok-diff" COMMAND cmake -E compare_files "${TEST_TMP_DI
 set_tests_properties("script-01--ok" PROPERTIES FIXTURES_SETUP "script-01--ok-setup")
 set_tests_properties("script-01--ok-diff" PROPERTIES FIXTURES_REQUIRED "script-01--ok-setup")
 
+add_test(NAME "cache-1--ok" COMMAND "tcppump" "--predictable-random" "--myip4=1.2.3.4" "--myip6=1234::1" "--mymac=80:23:45:67:89:AB" "--mtu=1500" "-s" "--cache=${TEST_TMP_DIR}/cache-1.pumpc" "-F" "pcap" "-w" "${TEST_TMP_DIR}/cache-1--ok.pcap" "${REF_FILES_DIR}/all.pump")
+set_tests_properties("cache-1--ok" PROPERTIES FIXTURES_REQUIRED setup)
+add_test(NAME "cache-1--ok-diff" COMMAND cmake -E compare_files "${TEST_TMP_DIR}/cache-1--ok.pcap" "${REF_FILES_DIR}/all.pcap")
+set_tests_properties("cache-1--ok" PROPERTIES FIXTURES_SETUP "cache-1--ok-setup")
+set_tests_properties("cache-1--ok-diff" PROPERTIES FIXTURES_REQUIRED "cache-1--ok-setup")
+
+add_test(NAME "cache-2--nok" COMMAND "tcppump" "--predictable-random" "--myip4=1.2.3.4" "--myip6=1234::1" "--mymac=80:23:45:67:89:AB" "--mtu=1500" "--cache" "-F" "hexstream" "-w" "-" "eth(dmac=01:02:03:04:05:06)")
+set_tests_properties("cache-2--nok" PROPERTIES FIXTURES_REQUIRED setup)
+set_tests_properties("cache-2--nok" PROPERTIES WILL_FAIL TRUE)
+
+add_test(NAME "stream-1--ok" COMMAND "tcppump" "--predictable-random" "--myip4=1.2.3.4" "--myip6=1234::1" "--mymac=80:23:45:67:89:AB" "--mtu=1500" "-s" "--stream" "-F" "pcap" "-w" "${TEST_TMP_DIR}/stream-1--ok.pcap" "${REF_FILES_DIR}/all.pump")
+set_tests_properties("stream-1--ok" PROPERTIES FIXTURES_REQUIRED setup)
+add_test(NAME "stream-1--ok-diff" COMMAND cmake -E compare_files "${TEST_TMP_DIR}/stream-1--ok.pcap" "${REF_FILES_DIR}/all.pcap")
+set_tests_properties("stream-1--ok" PROPERTIES FIXTURES_SETUP "stream-1--ok-setup")
+set_tests_properties("stream-1--ok-diff" PROPERTIES FIXTURES_REQUIRED "stream-1--ok-setup")
+
+add_test(NAME "stream-2--ok" COMMAND "tcppump" "--predictable-random" "--myip4=1.2.3.4" "--myip6=1234::1" "--mymac=80:23:45:67:89:AB" "--mtu=1500" "--pcap" "--stream" "-F" "pcap" "-w" "${TEST_TMP_DIR}/stream-2--ok.pcap" "${REF_FILES_DIR}/delay-18.pcap")
+set_tests_properties("stream-2--ok" PROPERTIES FIXTURES_REQUIRED setup)
+add_test(NAME "stream-2--ok-diff" COMMAND cmake -E compare_files "${TEST_TMP_DIR}/stream-2--ok.pcap" "${REF_FILES_DIR}/pcap-02.pcap")
+set_tests_properties("stream-2--ok" PROPERTIES FIXTURES_SETUP "stream-2--ok-setup")
+set_tests_properties("stream-2--ok-diff" PROPERTIES FIXTURES_REQUIRED "stream-2--ok-setup")
+
+add_test(NAME "stream-3--nok" COMMAND "tcppump" "--predictable-random" "--myip4=1.2.3.4" "--myip6=1234::1" "--mymac=80:23:45:67:89:AB" "--mtu=1500" "--stream" "-F" "hexstream" "-w" "-" "eth(dmac=01:02:03:04:05:06)")
+set_tests_properties("stream-3--nok" PROPERTIES FIXTURES_REQUIRED setup)
+set_tests_properties("stream-3--nok" PROPERTIES WILL_FAIL TRUE)
+
 add_test(NAME "syntax-error-1--nok" COMMAND "tcppump" "--predictable-random" "--myip4=1.2.3.4" "--myip6=1234::1" "--mymac=80:23:45:67:89:AB" "--mtu=1500" "-s" "-F" "hexstream" "-w" "-" "${REF_FILES_DIR}/syntax-error-01.pump")
 set_tests_properties("syntax-error-1--nok" PROPERTIES FIXTURES_REQUIRED setup)
 set_tests_properties("syntax-error-1--nok" PROPERTIES WILL_FAIL TRUE)
@@ -1394,6 +1420,12 @@ add_test(NAME "delay-32-ok-diff" COMMAND cmake -E compare_files "${TEST_TMP_DIR}
 set_tests_properties("delay-32-ok" PROPERTIES FIXTURES_SETUP "delay-32-ok-setup")
 set_tests_properties("delay-32-ok-diff" PROPERTIES FIXTURES_REQUIRED "delay-32-ok-setup")
 
+add_test(NAME "delay-33-ok" COMMAND "tcppump" "--predictable-random" "--myip4=1.2.3.4" "--myip6=1234::1" "--mymac=80:23:45:67:89:AB" "--mtu=1500" "-tn" "-d50000000" "-l3" "-F" "pcap" "-w" "${TEST_TMP_DIR}/delay-33-ok.pcap" "2000000: arp(dip=10.20.30.40)" "arp(dip=20.20.30.40)" "+5000000: arp(dip=30.20.30.40)")
+set_tests_properties("delay-33-ok" PROPERTIES FIXTURES_REQUIRED setup)
+add_test(NAME "delay-33-ok-diff" COMMAND cmake -E compare_files "${TEST_TMP_DIR}/delay-33-ok.pcap" "${REF_FILES_DIR}/delay-32.pcap")
+set_tests_properties("delay-33-ok" PROPERTIES FIXTURES_SETUP "delay-33-ok-setup")
+set_tests_properties("delay-33-ok-diff" PROPERTIES FIXTURES_REQUIRED "delay-33-ok-setup")
+
 add_test(NAME "overwrite-dmac-1--ok" COMMAND "tcppump" "--predictable-random" "--myip4=1.2.3.4" "--myip6=1234::1" "--mymac=80:23:45:67:89:AB" "--mtu=1500" "--overwrite-dmac=12:34:56:78:90:91" "-F" "hexstream" "-w" "-" "eth(dmac=11:22:33:44:55:66, payload = 0123456789abcdef0123456789abcdef)")
 set_tests_properties("overwrite-dmac-1--ok" PROPERTIES FIXTURES_REQUIRED setup)
 set_tests_properties("overwrite-dmac-1--ok" PROPERTIES PASS_REGULAR_EXPRESSION "1234567890918023456789ab00100123456789abcdef0123456789abcdef")
@@ -1462,6 +1494,43 @@ set_tests_properties("loop-5--nok" PROPERTIES PASS_REGULAR_EXPRESSION "Expected
 add_test(NAME "loop-6--ok" COMMAND "tcppump" "--predictable-random" "--myip4=1.2.3.4" "--myip6=1234::1" "--mymac=80:23:45:67:89:AB" "--mtu=1500" "-s" "-F" "hexstream" "-w" "-" "${REF_FILES_DIR}/loop-06.pump")
 set_tests_properties("loop-6--ok" PROPERTIES FIXTURES_REQUIRED setup)
 
+add_test(NAME "loop-7--ok" COMMAND "tcppump" "--predictable-random" "--myip4=1.2.3.4" "--myip6=1234::1" "--mymac=80:23:45:67:89:AB" "--mtu=1500" "-s" "-F" "hexstream" "-w" "-" "${REF_FILES_DIR}/loop-07.pump")
+set_tests_properties("loop-7--ok" PROPERTIES FIXTURES_REQUIRED setup)
+set_tests_properties("loop-7--ok" PROPERTIES PASS_REGULAR_EXPRESSION "01
+02
+03
+03
+03
+02
+03
+03
+03
+05")
+
+add_test(NAME "mutation-1--ok" COMMAND "tcppump" "--predictable-random" "--myip4=1.2.3.4" "--myip6=1234::1" "--mymac=80:23:45:67:89:AB" "--mtu=1500" "-l3" "-F" "hexstream" "-w" "-" "udp(dip=10.20.30.40, dmac=11:22:33:44:55:66, sport=+[1-2], dport=+[7|8|9], ttl=+[1-2])")
+set_tests_properties("mutation-1--ok" PROPERTIES FIXTURES_REQUIRED setup)
+set_tests_properties("mutation-1--ok" PROPERTIES PASS_REGULAR_EXPRESSION "1122334455668023456789ab08004500001c0000000001118d90010203040a141e28000100070008d394
+1122334455668023456789ab08004500001c0000000002118c90010203040a141e28000200080008d392
+1122334455668023456789ab08004500001c0000000001118d90010203040a141e28000100090008d392")
+
+add_test(NAME "mutation-2--ok" COMMAND "tcppump" "--predictable-random" "--myip4=1.2.3.4" "--myip6=1234::1" "--mymac=80:23:45:67:89:AB" "--mtu=1500" "-l3" "-F" "hexstream" "-w" "-" "tcp(dip=+[10.20.30.254-10.20.31.0], dmac=11:22:33:44:55:66, sip=+[1.1.1.1|2.2.2.2], id=+[0xfffe-0xffff], sport=1, dport=2, seq=0, ack=0)")
+set_tests_properties("mutation-2--ok" PROPERTIES FIXTURES_REQUIRED setup)
+set_tests_properties("mutation-2--ok" PROPERTIES PASS_REGULAR_EXPRESSION "1122334455668023456789ab080045000028fffe000040064fbe010101010a141efe0001000200000000000000005000040080ce0000
+1122334455668023456789ab080045000028ffff000040064dba020202020a141eff000100020000000000000000500004007ecb0000
+1122334455668023456789ab080045000028fffe000040064fbc010101010a141f000001000200000000000000005000040080cc0000")
+
+add_test(NAME "mutation-3--nok" COMMAND "tcppump" "--predictable-random" "--myip4=1.2.3.4" "--myip6=1234::1" "--mymac=80:23:45:67:89:AB" "--mtu=1500" "-F" "hexstream" "-w" "-" "udp(dip=10.20.30.40, dmac=11:22:33:44:55:66, sport=+[1-0x10000], dport=0)")
+set_tests_properties("mutation-3--nok" PROPERTIES FIXTURES_REQUIRED setup)
+set_tests_properties("mutation-3--nok" PROPERTIES WILL_FAIL TRUE)
+
+add_test(NAME "mutation-4--nok" COMMAND "tcppump" "--predictable-random" "--myip4=1.2.3.4" "--myip6=1234::1" "--mymac=80:23:45:67:89:AB" "--mtu=1500" "-F" "hexstream" "-w" "-" "udp(dip=10.20.30.40, dmac=11:22:33:44:55:66, sport=0, dport=0, dscp=+[1-2])")
+set_tests_properties("mutation-4--nok" PROPERTIES FIXTURES_REQUIRED setup)
+set_tests_properties("mutation-4--nok" PROPERTIES WILL_FAIL TRUE)
+
+add_test(NAME "mutation-5--nok" COMMAND "tcppump" "--predictable-random" "--myip4=1.2.3.4" "--myip6=1234::1" "--mymac=80:23:45:67:89:AB" "--mtu=1500" "-F" "hexstream" "-w" "-" "udp(dip=10.20.30.40, dmac=11:22:33:44:55:66, sport=0, dport=0, payload=<udp(dip=1.1.1.1, dmac=11:22:33:44:55:66, sport=+[1-2], dport=0)>)")
+set_tests_properties("mutation-5--nok" PROPERTIES FIXTURES_REQUIRED setup)
+set_tests_properties("mutation-5--nok" PROPERTIES WILL_FAIL TRUE)
+
 add_test(NAME "pcap-1--ok" COMMAND "tcppump" "--predictable-random" "--myip4=1.2.3.4" "--myip6=1234::1" "--mymac=80:23:45:67:89:AB" "--mtu=1500" "--pcap" "-F" "pcap" "-w" "${TEST_TMP_DIR}/pcap-1--ok.pcap" "${REF_FILES_DIR}/delay-13.pcap")
 set_tests_properties("pcap-1--ok" PROPERTIES FIXTURES_REQUIRED setup)
 add_test(NAME "pcap-1--ok-diff" COMMAND cmake -E compare_files "${TEST_TMP_DIR}/pcap-1--ok.pcap" "${REF_FILES_DIR}/delay-13.pcap")
@@ -1492,6 +1561,38 @@ add_test(NAME "pcap-5--ok-diff" COMMAND cmake -E compare_files "${TEST_TMP_DIR}/
 set_tests_properties("pcap-5--ok" PROPERTIES FIXTURES_SETUP "pcap-5--ok-setup")
 set_tests_properties("pcap-5--ok-diff" PROPERTIES FIXTURES_REQUIRED "pcap-5--ok-setup")
 
+add_test(NAME "pcap-6--ok" COMMAND "tcppump" "--predictable-random" "--myip4=1.2.3.4" "--myip6=1234::1" "--mymac=80:23:45:67:89:AB" "--mtu=1500" "--pcap" "-F" "pcap" "-w" "${TEST_TMP_DIR}/pcap-6--ok.pcap" "${REF_FILES_DIR}/pcap-06.pcap")
+set_tests_properties("pcap-6--ok" PROPERTIES FIXTURES_REQUIRED setup)
+add_test(NAME "pcap-6--ok-diff" COMMAND cmake -E compare_files "${TEST_TMP_DIR}/pcap-6--ok.pcap" "${REF_FILES_DIR}/delay-13.pcap")
+set_tests_properties("pcap-6--ok" PROPERTIES FIXTURES_SETUP "pcap-6--ok-setup")
+set_tests_properties("pcap-6--ok-diff" PROPERTIES FIXTURES_REQUIRED "pcap-6--ok-setup")
+
+add_test(NAME "pcap-7--ok" COMMAND "tcppump" "--predictable-random" "--myip4=1.2.3.4" "--myip6=1234::1" "--mymac=80:23:45:67:89:AB" "--mtu=1500" "--pcap" "-F" "pcap" "-w" "${TEST_TMP_DIR}/pcap-7--ok.pcap" "${REF_FILES_DIR}/pcap-07.pcapng")
+set_tests_properties("pcap-7--ok" PROPERTIES FIXTURES_REQUIRED setup)
+add_test(NAME "pcap-7--ok-diff" COMMAND cmake -E compare_files "${TEST_TMP_DIR}/pcap-7--ok.pcap" "${REF_FILES_DIR}/delay-13.pcap")
+set_tests_properties("pcap-7--ok" PROPERTIES FIXTURES_SETUP "pcap-7--ok-setup")
+set_tests_properties("pcap-7--ok-diff" PROPERTIES FIXTURES_REQUIRED "pcap-7--ok-setup")
+
+add_test(NAME "rate-1--ok" COMMAND "tcppump" "--predictable-random" "--myip4=1.2.3.4" "--myip6=1234::1" "--mymac=80:23:45:67:89:AB" "--mtu=1500" "-l3" "--rate=1Mbps" "-F" "pcap" "-w" "${TEST_TMP_DIR}/rate-1--ok.pcap" "arp(dip=10.20.30.40)")
+set_tests_properties("rate-1--ok" PROPERTIES FIXTURES_REQUIRED setup)
+add_test(NAME "rate-1--ok-diff" COMMAND cmake -E compare_files "${TEST_TMP_DIR}/rate-1--ok.pcap" "${REF_FILES_DIR}/rate-01.pcap")
+set_tests_properties("rate-1--ok" PROPERTIES FIXTURES_SETUP "rate-1--ok-setup")
+set_tests_properties("rate-1--ok-diff" PROPERTIES FIXTURES_REQUIRED "rate-1--ok-setup")
+
+add_test(NAME "rate-2--ok" COMMAND "tcppump" "--predictable-random" "--myip4=1.2.3.4" "--myip6=1234::1" "--mymac=80:23:45:67:89:AB" "--mtu=1500" "-l2" "-d5" "--rate=2kpps" "-F" "pcap" "-w" "${TEST_TMP_DIR}/rate-2--ok.pcap" "arp(dip=10.20.30.40)" "eth(dmac=11:22:33:44:55:66, payload=*1000)")
+set_tests_properties("rate-2--ok" PROPERTIES FIXTURES_REQUIRED setup)
+add_test(NAME "rate-2--ok-diff" COMMAND cmake -E compare_files "${TEST_TMP_DIR}/rate-2--ok.pcap" "${REF_FILES_DIR}/rate-02.pcap")
+set_tests_properties("rate-2--ok" PROPERTIES FIXTURES_SETUP "rate-2--ok-setup")
+set_tests_properties("rate-2--ok-diff" PROPERTIES FIXTURES_REQUIRED "rate-2--ok-setup")
+
+add_test(NAME "rate-3--nok" COMMAND "tcppump" "--predictable-random" "--myip4=1.2.3.4" "--myip6=1234::1" "--mymac=80:23:45:67:89:AB" "--mtu=1500" "--rate=10%" "-F" "hexstream" "-w" "-" "arp(dip=10.20.30.40)")
+set_tests_properties("rate-3--nok" PROPERTIES FIXTURES_REQUIRED setup)
+set_tests_properties("rate-3--nok" PROPERTIES WILL_FAIL TRUE)
+
+add_test(NAME "rate-4--nok" COMMAND "tcppump" "--predictable-random" "--myip4=1.2.3.4" "--myip6=1234::1" "--mymac=80:23:45:67:89:AB" "--mtu=1500" "--rate=fast" "-F" "hexstream" "-w" "-" "arp(dip=10.20.30.40)")
+set_tests_properties("rate-4--nok" PROPERTIES FIXTURES_REQUIRED setup)
+set_tests_properties("rate-4--nok" PROPERTIES WILL_FAIL TRUE)
+
 add_test(NAME "online-1--ok" COMMAND "tcppump" "-vvvv" "-i" "${OUT_IFC}" "arp(dip=1.2.3.4)")
 set_tests_properties("online-1--ok" PROPERTIES FIXTURES_REQUIRED setup)
 set_tests_properties("online-1--ok" PROPERTIES PASS_REGULAR_EXPRESSION "Successfully sent 1 packet.")
@@ -1500,6 +1601,38 @@ add_test(NAME "online-2--ok" COMMAND "tcppump" "-vvvv" "-l2" "-i" "${OUT_IFC}" "
 set_tests_properties("online-2--ok" PROPERTIES FIXTURES_REQUIRED setup)
 set_tests_properties("online-2--ok" PROPERTIES PASS_REGULAR_EXPRESSION "Successfully sent 2 packet.")
 
+add_test(NAME "online-3--ok" COMMAND "tcppump" "-vvvv" "-l2" "--no-tx-ring" "-i" "${OUT_IFC}" "arp(dip=1.2.3.4)")
+set_tests_properties("online-3--ok" PROPERTIES FIXTURES_REQUIRED setup)
+set_tests_properties("online-3--ok" PROPERTIES PASS_REGULAR_EXPRESSION "Successfully sent 2 packet.")
+
+add_test(NAME "online-4--ok" COMMAND "tcppump" "-vvvv" "-l10" "--no-tx-ring" "--tx-batch=3" "-i" "${OUT_IFC}" "arp(dip=1.2.3.4)")
+set_tests_properties("online-4--ok" PROPERTIES FIXTURES_REQUIRED setup)
+set_tests_properties("online-4--ok" PROPERTIES PASS_REGULAR_EXPRESSION "Successfully sent 10 packets.")
+
+add_test(NAME "online-5--ok" COMMAND "tcppump" "-vvvv" "-l10" "--xdp=copy" "-i" "${OUT_IFC}" "arp(dip=1.2.3.4)")
+set_tests_properties("online-5--ok" PROPERTIES FIXTURES_REQUIRED setup)
+set_tests_properties("online-5--ok" PROPERTIES PASS_REGULAR_EXPRESSION "Successfully sent 10 packets.")
+
+add_test(NAME "online-6--ok" COMMAND "tcppump" "-vvvv" "-l10" "--tx-threads=2" "--tx-batch=3" "-i" "${OUT_IFC}" "arp(dip=1.2.3.4)")
+set_tests_properties("online-6--ok" PROPERTIES FIXTURES_REQUIRED setup)
+set_tests_properties("online-6--ok" PROPERTIES PASS_REGULAR_EXPRESSION "Successfully sent 10 packets.")
+
+add_test(NAME "online-7--ok" COMMAND "tcppump" "-vvvv" "-l10" "--rate=10kpps" "-i" "${OUT_IFC}" "arp(dip=1.2.3.4)")
+set_tests_properties("online-7--ok" PROPERTIES FIXTURES_REQUIRED setup)
+set_tests_properties("online-7--ok" PROPERTIES PASS_REGULAR_EXPRESSION "Successfully sent 10 packets.")
+
+add_test(NAME "online-8--ok" COMMAND "tcppump" "-vvvv" "-l3" "-d1" "--launch-time=500" "-i" "${OUT_IFC}" "arp(dip=1.2.3.4)")
+set_tests_properties("online-8--ok" PROPERTIES FIXTURES_REQUIRED setup)
+set_tests_properties("online-8--ok" PROPERTIES PASS_REGULAR_EXPRESSION "Successfully sent 3 packets.")
+
+add_test(NAME "online-9--ok" COMMAND "tcppump" "-vvvv" "-l3" "-d1" "--tx-timestamps" "-i" "${OUT_IFC}" "arp(dip=1.2.3.4)")
+set_tests_properties("online-9--ok" PROPERTIES FIXTURES_REQUIRED setup)
+set_tests_properties("online-9--ok" PROPERTIES PASS_REGULAR_EXPRESSION "Deviation from schedule at driver")
+
+add_test(NAME "online-10--ok" COMMAND "tcppump" "-vvvv" "-l3" "-d1" "--rt" "-i" "${OUT_IFC}" "arp(dip=1.2.3.4)")
+set_tests_properties("online-10--ok" PROPERTIES FIXTURES_REQUIRED setup)
+set_tests_properties("online-10--ok" PROPERTIES PASS_REGULAR_EXPRESSION "Successfully sent 3 packets.")
+
 add_test(NAME "lldp-01--ok" COMMAND "tcppump" "--predictable-random" "--myip4=1.2.3.4" "--myip6=1234::1" "--mymac=80:23:45:67:89:AB" "--mtu=1500" "-F" "hexstream" "-w" "-" "lldp()")
 set_tests_properties("lldp-01--ok" PROPERTIES FIXTURES_REQUIRED setup)
 set_tests_properties("lldp-01--ok" PROPERTIES PASS_REGULAR_EXPRESSION "0180c200000e8023456789ab88cc0207048023456789ab0407038023456789ab060200780000")
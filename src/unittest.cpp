@@ -28,17 +28,28 @@
 #include "arppacket.hpp"
 #include "bug.hpp"
 #include "ippacket.hpp"
+#include "udppacket.hpp"
+#include "tcppacket.hpp"
 #include "parameterlist.hpp"
 #include "instructionparser.hpp"
+#include "compiler.hpp"
 #include "sleep.hpp"
+#if !HAVE_WINDOWS
+#include "pacer.hpp"
+#include "txtimestamps.hpp"
+#endif
 #include "ipaddress.hpp"
 #include "macaddress.hpp"
 #include "parsehelper.hpp"
 #include "inetchecksum.hpp"
+#include "fieldmutation.hpp"
 #include "random.hpp"
 #include "bytearray.hpp"
 #include "uuid.hpp"
 #include "md5.hpp"
+#include "framearena.hpp"
+#include "packetcache.hpp"
+#include "ratelimiter.hpp"
 #if HAVE_MSVC
 #include <crtdbg.h>
 #endif
@@ -64,21 +75,33 @@ int main (int argc, char* argv[])
     {
         tcppump::SleepInit ();
         tcppump::SleepUnitTest ();
+#if !HAVE_WINDOWS
+        cPacer::unitTest ();
+        cTxTimestamps::unitTest ();
+#endif
         cByteArray::unitTest ();
         cUUID::unitTest ();
         cMD5::unitTest ();
+        cFrameArena::unitTest ();
+        cPacketCache::unitTest ();
         cRandom::unitTest ();
         cIPv4::unitTest ();
         cIPv6::unitTest ();
         cMacAddress::unitTest ();
         cTimeval::unitTest ();
         cInetChecksum::unitTest();
+        cFieldMutation::unitTest ();
+        cRateLimiter::unitTest ();
         cEthernetPacket::unitTest ();
         cArpPacket::unitTest ();
         cIPPacket::unitTest ();
+        cUdpPacket::unitTest ();
+        cTcpPacket::unitTest ();
         cParseHelper::unitTest ();
         cParameterList::unitTest ();
         cInstructionParser::unitTest ();
+        cFileParser::unitTest ();
+        cCompiler::unitTest ();
 
 #if HAVE_PCAP
         cPcapFileIO::unitTest (argv[1]);